@@ -89,6 +89,8 @@ UB_THIRDPARTY_INTERACTIVE.files = thirdparty/interactive
 DEFINES += NO_THIRD_PARTY_WARNINGS
 DEFINES += UBVERSION=\"\\\"$${LONG_VERSION}\"\\\" \
    UBVERSION_RC=$$VERSION_RC
+# use "CONFIG+=profiling" to build with profiling instrumentation
+CONFIG(profiling):DEFINES += UB_PROFILING
 ALPHA_BETA_STR = $$find(VERSION, "[ab]")
 count(ALPHA_BETA_STR, 1):DEFINES += PRE_RELEASE
 BUILD_DIR = build
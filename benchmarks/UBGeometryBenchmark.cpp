@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QElapsedTimer>
+#include <QtGui>
+
+#include <cstdio>
+#include <limits>
+#include <random>
+
+#include "frameworks/UBGeometryUtils.h"
+
+#include "UBGeometryReference.h"
+
+#include "core/memcheck.h"
+
+typedef QList<QPair<QPointF, qreal> > Stroke;
+
+/** Largest distance between the outlines of both implementations, in scene units */
+static const qreal sOutlineTolerance = 1.0;
+
+/** Largest distance between the Bézier points of both implementations, in scene units */
+static const qreal sBezierTolerance = 0.1;
+
+static const int sStrokeCount = 500;
+static const int sStrokePoints = 100;
+static const int sCurveCount = 20000;
+
+/** Number of points per curve, as used by UBGraphicsStroke */
+static const int sCurvePoints = 10;
+
+static const int sRepetitions = 10;
+
+/**
+ * @brief Return the distance from p to the closed outline
+ */
+static qreal distanceToOutline(const QPointF& p, const QPolygonF& outline)
+{
+    qreal distance = std::numeric_limits<qreal>::max();
+
+    for (int i = 0; i < outline.size(); ++i) {
+        const QPointF a = outline[i];
+        const QPointF ab = outline[(i + 1) % outline.size()] - a;
+        const qreal squaredLength = QPointF::dotProduct(ab, ab);
+        const qreal t = squaredLength > 0 ? qBound(qreal(0), QPointF::dotProduct(p - a, ab) / squaredLength, qreal(1)) : 0;
+
+        distance = qMin(distance, QLineF(a + t * ab, p).length());
+    }
+
+    return distance;
+}
+
+/**
+ * @brief Return the largest distance from a vertex of an outline to the other outline, both ways
+ */
+static qreal outlineDistance(const QPolygonF& a, const QPolygonF& b)
+{
+    qreal distance = 0;
+
+    for (const QPointF& p : a)
+        distance = qMax(distance, distanceToOutline(p, b));
+
+    for (const QPointF& p : b)
+        distance = qMax(distance, distanceToOutline(p, a));
+
+    return distance;
+}
+
+/**
+ * @brief Generate pen strokes as walks of smoothly varying direction and width
+ *
+ * Consecutive points are never equal: both implementations orient a null segment at the end of a
+ * stroke differently.
+ */
+static QList<Stroke> randomStrokes(std::mt19937& random)
+{
+    std::uniform_real_distribution<qreal> position(0, 1000);
+    std::uniform_real_distribution<qreal> angle(0, 2 * M_PI);
+    std::uniform_real_distribution<qreal> turn(-0.5, 0.5);
+    std::uniform_real_distribution<qreal> step(0.5, 8);
+    std::uniform_real_distribution<qreal> width(1, 20);
+    std::uniform_real_distribution<qreal> widthChange(-0.5, 0.5);
+
+    QList<Stroke> strokes;
+
+    for (int s = 0; s < sStrokeCount; ++s) {
+        Stroke stroke;
+        QPointF point(position(random), position(random));
+        qreal direction = angle(random);
+        qreal pointWidth = width(random);
+
+        for (int i = 0; i < sStrokePoints; ++i) {
+            stroke << qMakePair(point, pointWidth);
+
+            direction += turn(random);
+            point += step(random) * QPointF(std::cos(direction), std::sin(direction));
+            pointWidth = qBound(qreal(1), pointWidth + widthChange(random), qreal(20));
+        }
+
+        strokes << stroke;
+    }
+
+    return strokes;
+}
+
+/**
+ * @brief Run f sRepetitions times and return the number of points processed per second
+ */
+template <typename Function>
+static double pointsPerSecond(qint64 points, Function f)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < sRepetitions; ++i)
+        f();
+
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), qint64(1));
+
+    return double(points) * sRepetitions * 1e9 / elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+    Q_UNUSED(argc);
+    Q_UNUSED(argv);
+
+    std::mt19937 random(42);
+    bool success = true;
+
+    // stroke outlines, with both ends round as for pen strokes and an open start as for the
+    // polygons drawn while the stroke is in progress
+    const QList<Stroke> strokes = randomStrokes(random);
+    qreal maxOutlineDistance = 0;
+
+    for (const Stroke& stroke : strokes) {
+        maxOutlineDistance = qMax(maxOutlineDistance, outlineDistance(UBGeometryUtils::curveToPolygon(stroke, true, true),
+                UBGeometryReference::curveToPolygon(stroke, true, true)));
+        maxOutlineDistance = qMax(maxOutlineDistance, outlineDistance(UBGeometryUtils::curveToPolygon(stroke, false, true),
+                UBGeometryReference::curveToPolygon(stroke, false, true)));
+    }
+
+    const qint64 strokePoints = qint64(sStrokeCount) * sStrokePoints;
+    qint64 outlineSink = 0;
+
+    const double outlineRate = pointsPerSecond(strokePoints, [&]() {
+        for (const Stroke& stroke : strokes)
+            outlineSink += UBGeometryUtils::curveToPolygon(stroke, true, true).size();
+    });
+
+    const double referenceOutlineRate = pointsPerSecond(strokePoints, [&]() {
+        for (const Stroke& stroke : strokes)
+            outlineSink += UBGeometryReference::curveToPolygon(stroke, true, true).size();
+    });
+
+    std::printf("curveToPolygon: max distance %.4f (tolerance %.4f)\n", maxOutlineDistance, sOutlineTolerance);
+    std::printf("    kernel    %12.0f points/s\n", outlineRate);
+    std::printf("    reference %12.0f points/s (%.1fx)\n", referenceOutlineRate, outlineRate / referenceOutlineRate);
+
+    if (maxOutlineDistance > sOutlineTolerance)
+        success = false;
+
+    // Bézier curves
+    std::uniform_real_distribution<qreal> position(0, 200);
+    QList<QPointF> controlPoints;
+
+    for (int i = 0; i < 3 * sCurveCount; ++i)
+        controlPoints << QPointF(position(random), position(random));
+
+    qreal maxBezierDistance = 0;
+
+    for (int i = 0; i < sCurveCount; ++i) {
+        const QList<QPointF> points = UBGeometryUtils::quadraticBezier(controlPoints[3*i], controlPoints[3*i+1], controlPoints[3*i+2], sCurvePoints);
+        const QList<QPointF> reference = UBGeometryReference::quadraticBezier(controlPoints[3*i], controlPoints[3*i+1], controlPoints[3*i+2], sCurvePoints);
+
+        if (points.size() != reference.size()) {
+            maxBezierDistance = std::numeric_limits<qreal>::max();
+            break;
+        }
+
+        for (int j = 0; j < points.size(); ++j)
+            maxBezierDistance = qMax(maxBezierDistance, QLineF(points[j], reference[j]).length());
+    }
+
+    const qint64 curvePoints = qint64(sCurveCount) * (sCurvePoints + 1);
+    qint64 bezierSink = 0;
+
+    const double bezierRate = pointsPerSecond(curvePoints, [&]() {
+        for (int i = 0; i < sCurveCount; ++i)
+            bezierSink += UBGeometryUtils::quadraticBezier(controlPoints[3*i], controlPoints[3*i+1], controlPoints[3*i+2], sCurvePoints).size();
+    });
+
+    const double referenceBezierRate = pointsPerSecond(curvePoints, [&]() {
+        for (int i = 0; i < sCurveCount; ++i)
+            bezierSink += UBGeometryReference::quadraticBezier(controlPoints[3*i], controlPoints[3*i+1], controlPoints[3*i+2], sCurvePoints).size();
+    });
+
+    std::printf("quadraticBezier: max distance %.4f (tolerance %.4f)\n", maxBezierDistance, sBezierTolerance);
+    std::printf("    kernel    %12.0f points/s\n", bezierRate);
+    std::printf("    reference %12.0f points/s (%.1fx)\n", referenceBezierRate, bezierRate / referenceBezierRate);
+
+    if (maxBezierDistance > sBezierTolerance)
+        success = false;
+
+    // keeps the timed loops from being optimized out
+    if (outlineSink < 0 || bezierSink < 0)
+        std::printf("\n");
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBGeometryReference.h"
+
+#include "core/memcheck.h"
+
+static const double PI = 4.0 * atan(1.0);
+
+QPolygonF UBGeometryReference::lineToPolygon(const QPointF& pStart, const QPointF& pEnd,
+        const qreal& pStartWidth, const qreal& pEndWidth)
+{
+
+    qreal x1 = pStart.x();
+    qreal y1 = pStart.y();
+
+    qreal x2 = pEnd.x();
+    qreal y2 = pEnd.y();
+
+    QLineF line(pStart, pEnd);
+
+    qreal alpha = (90.0 - line.angle()) * PI / 180.0;
+    qreal hypothenuseStart = pStartWidth / 2;
+
+    qreal hypothenuseEnd = pEndWidth / 2;
+
+    qreal sinAlpha = sin(alpha);
+    qreal cosAlpha = cos(alpha);
+
+    // TODO UB 4.x PERF cache sin/cos table
+    qreal oppositeStart = sinAlpha * hypothenuseStart;
+    qreal adjacentStart = cosAlpha * hypothenuseStart;
+
+    QPointF p1a(x1 - adjacentStart, y1 - oppositeStart);
+    QPointF p1b(x1 + adjacentStart, y1 + oppositeStart);
+
+    qreal oppositeEnd = sinAlpha * hypothenuseEnd;
+    qreal adjacentEnd = cosAlpha * hypothenuseEnd;
+
+    QPointF p2a(x2 - adjacentEnd, y2 - oppositeEnd);
+
+    QPainterPath painterPath;
+
+    painterPath.moveTo(p1a);
+    painterPath.lineTo(p2a);
+
+    painterPath.arcTo(x2 - hypothenuseEnd, y2 - hypothenuseEnd, pEndWidth, pEndWidth, (90.0 + line.angle()), -180.0);
+
+    painterPath.lineTo(p1b);
+
+    painterPath.arcTo(x1 - hypothenuseStart, y1 - hypothenuseStart, pStartWidth, pStartWidth, -1 * (90.0 - line.angle()), -180.0);
+
+    painterPath.closeSubpath();
+
+    return painterPath.toFillPolygon();
+}
+
+QPolygonF UBGeometryReference::curveToPolygon(const QList<QPair<QPointF, qreal> >& points, bool roundStart, bool roundEnd)
+{
+    int n_points = points.size();
+
+    if (n_points == 0)
+        return QPolygonF();
+    if (n_points == 1)
+        return lineToPolygon(points.first().first, points.first().first, points.first().second, points.first().second);
+
+    qreal startWidth = points.first().second;
+    qreal endWidth = points.last().second;
+
+    /* The vertices (x's) are calculated based on the stroke's width and angle, and the position of the
+       supplied points (o's):
+
+          x----------x--------x
+
+          o          o        o
+
+          x----------x -------x
+
+       The vertices above and below each 'o' point are temporarily stored together, 
+       as a pair of points.
+     */
+
+    typedef QPair<QPointF, QPointF> pointPair;
+    QList<pointPair> newPoints;
+
+
+    QLineF firstSegment = QLineF(points[0].first, points[1].first);
+    QLineF normal = firstSegment.normalVector();
+    normal.setLength(startWidth/2.0);
+    newPoints << pointPair(normal.p2(), points[0].first - QPointF(normal.dx(), normal.dy()));
+
+    /*
+    Calculating the vertices (d1 and d2, below) is a little less trivial for the
+    next points: their positions depend on the angle between one segment and the next.
+
+                      d1
+         ------------x
+                      \
+         .a      b .   \
+                        \
+         --------x       \
+               d2 \       \
+                   \   .c  \
+
+    Here, points a, b and c are supplied in the `points` list.
+
+    N.B: The drawing isn't quite accurate; we don't do a miter joint but a kind
+    of rounded-off joint (the distance between b and d1 is half the width of the stroke)
+    */
+
+    for (int i(1); i < n_points-1; ++i) {
+        //qreal width = startWidth + (qreal(i)/qreal(n_points-1)) * (endWidth - startWidth);
+
+        QLineF normal = (QLineF(points[i-1].first, points[i+1].first)).normalVector();
+        normal.setLength(points[i].second/2.0);
+        QPointF d1 = points[i].first + QPointF(normal.dx(), normal.dy());
+        QPointF d2 = points[i].first - QPointF(normal.dx(), normal.dy());
+
+        newPoints << pointPair(d1, d2);
+    }
+
+    // The last point is similar to the first
+    QLineF lastSegment = QLineF(points[n_points-2].first, points[n_points-1].first);
+    normal = lastSegment.normalVector();
+    normal.setLength(endWidth/2.0);
+
+    QPointF d1 = points.last().first + QPointF(normal.dx(), normal.dy());
+    QPointF d2 = points.last().first - QPointF(normal.dx(), normal.dy());
+
+    newPoints << pointPair(d1, d2);
+
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    path.moveTo(newPoints[0].first);
+
+    for (int i(1); i < n_points; ++i) {
+        path.lineTo(newPoints[i].first);
+    }
+
+    if (roundEnd)
+        path.arcTo(points.last().first.x() - endWidth/2.0, points.last().first.y() - endWidth/2.0, endWidth, endWidth, (90.0 + lastSegment.angle()), -180.0);
+    else
+        path.lineTo(newPoints.last().second);
+
+    for (int i(n_points-1); i >= 0; --i) {
+        path.lineTo(newPoints[i].second);
+    }
+
+    if (roundStart)
+        path.arcTo(points[0].first.x() - startWidth/2.0, points[0].first.y() - startWidth/2.0, startWidth, startWidth, (firstSegment.angle() - 90.0), -180.0);
+    else
+        path.lineTo(newPoints[0].first);
+
+
+    //path.closeSubpath();
+
+    return path.toFillPolygon();
+}
+
+QList<QPointF> UBGeometryReference::quadraticBezier(const QPointF& p0, const QPointF& p1, const QPointF& p2, unsigned int nPoints)
+{
+    QPainterPath path(p0);
+    path.quadTo(p1, p2);
+
+    QList<QPointF> points;
+
+    if (nPoints <= 1)
+        return points;
+
+    for (unsigned int i(0); i <= nPoints; ++i) {
+        qreal percent = qreal(i)/qreal(nPoints);
+        points << path.pointAtPercent(percent);
+    }
+
+    return points;
+}
@@ -44,6 +44,7 @@ LIBS     += "-L$$THIRD_PARTY_PATH/quazip/lib/$$SUB_DIR" "-lquazip"
 QT       += xml xmlpatterns core
 QT       += gui
 QT       += svg
+QT       += concurrent
 
 
 DEFINES += UBCFFADAPTOR_LIBRARY
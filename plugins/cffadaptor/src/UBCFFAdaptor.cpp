@@ -29,6 +29,7 @@
 
 #include "UBCFFAdaptor.h"
 
+#include <QtConcurrent>
 #include <QtCore>
 #include <QtXml>
 #include <QTransform>
@@ -44,13 +45,35 @@
     #include <quazip.h>
     #include <quazipfile.h>
     #include <quazipfileinfo.h>
+    #include <quagzipfile.h>
 #else
     #include "quazip.h"
     #include "quazipfile.h"
     #include "quazipfileinfo.h"
+    #include "quagzipfile.h"
 #endif
 //THIRD_PARTY_WARNINGS_ENABLE
 
+/**
+ * @brief Open a page file for reading, through gzip when it was saved compressed
+ *
+ * Returns the device to read from, or a null pointer if the file cannot be opened.
+ */
+static QIODevice *openPageFile(const QString &fileName, QFile &file, QuaGzipFile &gzipFile)
+{
+    if (!file.open(QIODevice::ReadOnly))
+        return nullptr;
+
+    // gzip magic number
+    if (!file.peek(2).startsWith("\x1f\x8b"))
+        return &file;
+
+    file.close();
+    gzipFile.setFileName(fileName);
+
+    return gzipFile.open(QIODevice::ReadOnly) ? &gzipFile : nullptr;
+}
+
 
 UBCFFAdaptor::UBCFFAdaptor()
 {}
@@ -517,36 +540,102 @@ bool UBCFFAdaptor::UBToCFFConverter::parseContent() {
     fileFilters << QString(pageAlias + "???." + pageFileExtentionUBZ);
     QStringList pageList = sourceDir.entryList(fileFilters, QDir::Files, QDir::Name | QDir::IgnoreCase);
 
-    QDomElement svgDocumentSection = mDataModel->createElementNS(svgIWBNS, ":"+tSvg);
-
     if (!pageList.count()) {
         qDebug() << "can't find any content file";
         errorStr = "ErrorContentFile";
         return false;
-    } else 
-    {
-        QDomElement pageset = parsePageset(pageList);
-        if (pageset.isNull())
-            return false;
-        else
-            svgDocumentSection.appendChild(pageset);
     }
 
-    
+    // The background of a page covers the viewboxes of all pages up to it, as when
+    // converting the pages in order. Only the page roots are read to know them.
+    QList<QRect> pageViewboxes;
+    QRect viewbox;
+
+    for (const QString &pageFileName : std::as_const(pageList)) {
+        pageViewboxes << viewbox;
+        viewbox |= readPageViewbox(pageFileName);
+    }
+
+    setViewBox(viewbox);
+
     if (QRect() == mViewbox)
     {
         mViewbox.setRect(0,0, mSVGSize.width(), mSVGSize.height());
     }
 
-    svgDocumentSection.setAttribute(aIWBViewBox, rectToIWBAttr(mViewbox));
-    svgDocumentSection.setAttribute(aWidth, QString("%1").arg(mViewbox.width()));
-    svgDocumentSection.setAttribute(aHeight, QString("%1").arg(mViewbox.height()));
+    mIWBContentWriter->writeStartElement(svgIWBNS, tSvg);
+    mIWBContentWriter->writeAttribute(aIWBViewBox, rectToIWBAttr(mViewbox));
+    mIWBContentWriter->writeAttribute(aWidth, QString("%1").arg(mViewbox.width()));
+    mIWBContentWriter->writeAttribute(aHeight, QString("%1").arg(mViewbox.height()));
+    mIWBContentWriter->writeStartElement(svgIWBNS, tIWBPageSet);
+
+    // extended elements follow the svg section, collect them outside of memory meanwhile
+    QTemporaryFile extendedElementsFile;
+    if (!extendedElementsFile.open()) {
+        qDebug() << "can't open temporary file for extended iwb elements";
+        errorStr = "createXMLOutputPatternError";
+        return false;
+    }
+
+    QXmlStreamWriter extendedElementsWriter(&extendedElementsFile);
+    extendedElementsWriter.writeStartElement(tFragment);
+    int extendedElementCount = 0;
+
+    // Pages are converted on the thread pool and written in order. Only a few pages
+    // are converted ahead of the one written, bounding the memory used.
+    const int pagesAhead = 2 * qMax(1, QThread::idealThreadCount());
+    QQueue<QFuture<PageResult>> pendingPages;
+    int nextPage = 0;
+    bool pagesConverted = true;
 
+    for (int page = 0; page < pageList.count() && pagesConverted; page++) {
+        while (nextPage < pageList.count() && nextPage <= page + pagesAhead) {
+            const QString source = sourcePath;
+            const QString destination = destinationPath;
+            const QString pageFileName = pageList.at(nextPage);
+            const QRect pageViewbox = pageViewboxes.at(nextPage);
+            const int pageNo = nextPage + 1;
 
-    writeQDomElementToXML(svgDocumentSection);
+            pendingPages.enqueue(QtConcurrent::run([=](){
+                return convertPage(source, destination, pageFileName, pageNo, pageViewbox);
+            }));
+
+            nextPage++;
+        }
+
+        const PageResult result = pendingPages.dequeue().result();
+        mExportErrorList << result.messages;
+
+        if (!result.converted) {
+            if (result.error != noErrorMsg)
+                errorStr = result.error;
+
+            pagesConverted = false;
+            break;
+        }
 
+        QXmlStreamReader svgPart(result.svgPart);
+        QXmlStreamReader iwbPart(result.iwbPart);
 
-    if (!writeExtendedIwbSection()) {
+        pagesConverted = copyFragment(svgPart, *mIWBContentWriter)
+                && copyFragment(iwbPart, extendedElementsWriter);
+        extendedElementCount += result.extendedElementCount;
+    }
+
+    // pages converted ahead still write their media
+    while (!pendingPages.isEmpty())
+        pendingPages.dequeue().waitForFinished();
+
+    if (!pagesConverted)
+        return false;
+
+    mIWBContentWriter->writeEndElement();
+    mIWBContentWriter->writeEndElement();
+
+    extendedElementsWriter.writeEndElement();
+    extendedElementsFile.seek(0);
+
+    if (!writeExtendedIwbSection(&extendedElementsFile, extendedElementCount)) {
         if (errorStr == noErrorMsg)
             errorStr = "writeExtendedIwbSectionError";
         return false;
@@ -555,6 +644,55 @@ bool UBCFFAdaptor::UBToCFFConverter::parseContent() {
     return true;
 }
 
+/**
+ * Convert a single page with a converter of its own, so that pages can be converted concurrently.
+ * The viewbox is the union of the viewboxes of the previous pages.
+ */
+UBCFFAdaptor::UBToCFFConverter::PageResult UBCFFAdaptor::UBToCFFConverter::convertPage(const QString &source, const QString &destination, const QString &pageFileName, int pageNo, const QRect &viewbox)
+{
+    PageResult result;
+
+    UBToCFFConverter pageConverter(source, destination);
+    pageConverter.mViewbox = viewbox;
+
+    QDomElement page = pageConverter.parsePage(pageFileName);
+    if (!page.isNull()) {
+        page.setAttribute(tId, pageNo);
+
+        result.svgPart = pageConverter.writeFragment(QList<QDomElement>() << page);
+        result.iwbPart = pageConverter.writeFragment(pageConverter.mExtendedElements);
+        result.extendedElementCount = pageConverter.mExtendedElements.count();
+        result.converted = true;
+    }
+
+    result.messages = pageConverter.getMessages();
+    result.error = pageConverter.lastErrStr();
+
+    return result;
+}
+
+QRect UBCFFAdaptor::UBToCFFConverter::readPageViewbox(const QString &pageFileName) const
+{
+    QFile pageFile(sourcePath + "/" + pageFileName);
+    QuaGzipFile gzipFile;
+    QIODevice *pageDevice = openPageFile(pageFile.fileName(), pageFile, gzipFile);
+    if (!pageDevice)
+        return QRect();
+
+    QXmlStreamReader reader(pageDevice);
+
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QXmlStreamReader::StartElement) {
+            if (reader.name() == tSvg && reader.attributes().hasAttribute(aUBZViewBox))
+                return getViewboxRect(reader.attributes().value(aUBZViewBox).toString());
+
+            break;
+        }
+    }
+
+    return QRect();
+}
+
 QDomElement UBCFFAdaptor::UBToCFFConverter::parsePage(const QString &pageFileName)
 {
     qDebug() << "begin parsing page" + pageFileName;
@@ -563,10 +701,12 @@ QDomElement UBCFFAdaptor::UBToCFFConverter::parsePage(const QString &pageFileNam
     int errorLine, errorColumn;
 
     QFile pageFile(sourcePath + "/" + pageFileName);
-    if (!pageFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    QuaGzipFile gzipFile;
+    QIODevice *pageDevice = openPageFile(pageFile.fileName(), pageFile, gzipFile);
+    if (!pageDevice) {
         qDebug() << "can't open file" << pageFileName << "for reading";
         return QDomElement();
-    } else if (!mDataModel->setContent(pageFile.readAll(), true, &errorStr, &errorLine, &errorColumn)) {
+    } else if (!mDataModel->setContent(pageDevice->readAll(), true, &errorStr, &errorLine, &errorColumn)) {
         qWarning() << "Error:Parseerroratline" << errorLine << ","
                    << "column" << errorColumn << ":" << errorStr;
         pageFile.close();
@@ -603,40 +743,6 @@ QDomElement UBCFFAdaptor::UBToCFFConverter::parsePage(const QString &pageFileNam
     return page.hasChildNodes() ? page : QDomElement();
 }
 
-QDomElement UBCFFAdaptor::UBToCFFConverter::parsePageset(const QStringList &pageFileNames)
-{   
-    QMultiMap<int, QDomElement> pageList;
-    int iPageNo = 1;
-
-    QStringListIterator curPage(pageFileNames);
-
-    while (curPage.hasNext()) {
-
-        QString curPageFile = curPage.next();
-        QDomElement iterElement = parsePage(curPageFile);
-        if (!iterElement.isNull())           
-        {
-            iterElement.setAttribute(tId, iPageNo);
-            addSVGElementToResultModel(iterElement, pageList, iPageNo);
-            iPageNo++; 
-        }
-        else
-            return QDomElement();
-    }
-
-
-    if (!pageList.count())
-        return QDomElement(); 
-
-
-    QDomElement svgPagesetElement = mDocumentToWrite->createElementNS(svgIWBNS,":"+ tIWBPageSet);
-
-    for (const auto &value : std::as_const(pageList)) {
-        svgPagesetElement.appendChild(value);
-    }
-
-    return svgPagesetElement.hasChildNodes() ? svgPagesetElement : QDomElement();
-}
 QDomElement UBCFFAdaptor::UBToCFFConverter::parseSvgPageSection(const QDomElement &element)
 {
     //we don't know about page number, so return QDomElement.
@@ -710,20 +816,94 @@ void UBCFFAdaptor::UBToCFFConverter::writeQDomElementToXML(const QDomNode &node)
     }
 }
 
-bool UBCFFAdaptor::UBToCFFConverter::writeExtendedIwbSection()
+/**
+ * Write the elements to a standalone fragment. Its root declares the namespaces of the
+ * output document, so that the elements get the same prefixes as in the output.
+ */
+QByteArray UBCFFAdaptor::UBToCFFConverter::writeFragment(const QList<QDomElement> &elements)
 {
-    if (!mExtendedElements.count()) {
+    QByteArray fragment;
+    QXmlStreamWriter fragmentWriter(&fragment);
+
+    QXmlStreamWriter *contentWriter = mIWBContentWriter;
+    mIWBContentWriter = &fragmentWriter;
+
+    mIWBContentWriter->writeStartElement(tFragment);
+    fillNamespaces();
+
+    for (const QDomElement &element : elements)
+        writeQDomElementToXML(element);
+
+    mIWBContentWriter->writeEndElement();
+    mIWBContentWriter = contentWriter;
+
+    return fragment;
+}
+
+/**
+ * Copy the content of a fragment, without its root, to the writer. Names are copied as
+ * written, the prefixes being those of the output document.
+ */
+bool UBCFFAdaptor::UBToCFFConverter::copyFragment(QXmlStreamReader &reader, QXmlStreamWriter &writer)
+{
+    reader.setNamespaceProcessing(false);
+
+    int depth = 0;
+
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (depth++ > 0) {
+                writer.writeStartElement(reader.qualifiedName().toString());
+
+                const QXmlStreamAttributes attributes = reader.attributes();
+                for (const QXmlStreamAttribute &attribute : attributes)
+                    writer.writeAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
+            }
+            break;
+
+        case QXmlStreamReader::EndElement:
+            if (--depth > 0)
+                writer.writeEndElement();
+            break;
+
+        case QXmlStreamReader::Characters:
+            if (depth > 0) {
+                if (reader.isCDATA())
+                    writer.writeCDATA(reader.text().toString());
+                else
+                    writer.writeCharacters(reader.text().toString());
+            }
+            break;
+
+        case QXmlStreamReader::Comment:
+            writer.writeComment(reader.text().toString());
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (reader.hasError()) {
+        qDebug() << "can't copy converted content:" << reader.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool UBCFFAdaptor::UBToCFFConverter::writeExtendedIwbSection(QIODevice *extendedElements, int elementCount)
+{
+    if (!elementCount) {
         qDebug() << "extended iwb content list is empty";
         errorStr = "EmptyExtendedIwbSectionContentError";
         return false;
     }
-    QListIterator<QDomElement> nextExtendedIwbElement(mExtendedElements);
-    while (nextExtendedIwbElement.hasNext()) {
-        writeQDomElementToXML(nextExtendedIwbElement.next());
-        //TODO write iwb extended element to mIWBContentWriter
-    }
 
-    return true;
+    QXmlStreamReader reader(extendedElements);
+
+    return copyFragment(reader, *mIWBContentWriter);
 }
 
 // extended element options
@@ -1130,8 +1310,8 @@ bool UBCFFAdaptor::UBToCFFConverter::setContentFromUBZ(const QDomElement &ubzEle
 
         QDir dstDocFolder(destinationPath);
 
-        if (!dstDocFolder.exists(sDstContentFolder))
-            bRet &= dstDocFolder.mkdir(sDstContentFolder);
+        // pages are converted concurrently, mkpath does not fail on a folder created meanwhile
+        bRet &= dstDocFolder.mkpath(sDstContentFolder);
 
         if (bRet)
         {
@@ -1154,8 +1334,8 @@ bool UBCFFAdaptor::UBToCFFConverter::setContentFromUBZ(const QDomElement &ubzEle
         {
             QDir dstDocFolder(destinationPath);
 
-            if (!dstDocFolder.exists(sDstContentFolder))
-                bRet &= dstDocFolder.mkdir(sDstContentFolder);
+            // pages are converted concurrently, mkpath does not fail on a folder created meanwhile
+            bRet &= dstDocFolder.mkpath(sDstContentFolder);
 
             if (bRet)
             {
@@ -1718,8 +1898,8 @@ bool UBCFFAdaptor::UBToCFFConverter::parseUBZAudio(const QDomElement &element, Q
         //creating folder for audioImage
         QDir dstDocFolder(destinationPath);
         bool bRes = true;
-        if (!dstDocFolder.exists(cfImages))
-            bRes &= dstDocFolder.mkdir(cfImages);
+        // pages are converted concurrently, mkpath does not fail on a folder created meanwhile
+        bRes &= dstDocFolder.mkpath(cfImages);
         
         // CFF cannot show SVG images, so we need to convert it to png.
         if (bRes && createPngFromSvg(srcAudioImageFile, dstAudioImageFilePath, getTransformFromUBZ(element), QSize(audioImageDimention, audioImageDimention)))
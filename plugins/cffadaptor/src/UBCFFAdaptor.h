@@ -79,17 +79,30 @@ private:
 
     private:
 
+        // a converted page, written as fragments of the output document
+        struct PageResult {
+            bool converted = false;
+            QByteArray svgPart;
+            QByteArray iwbPart;
+            int extendedElementCount = 0;
+            QList<QString> messages;
+            QString error;
+        };
+
         void addLastExportError(QString error) {mExportErrorList.append(error);}
 
         void fillNamespaces();
 
         bool parseMetadata();
         bool parseContent();
-        QDomElement parsePageset(const QStringList &pageFileNames);
+        static PageResult convertPage(const QString &source, const QString &destination, const QString &pageFileName, int pageNo, const QRect &viewbox);
+        QRect readPageViewbox(const QString &pageFileName) const;
         QDomElement parsePage(const QString &pageFileName);
         QDomElement parseSvgPageSection(const QDomElement &element);
         void writeQDomElementToXML(const QDomNode &node);
-        bool writeExtendedIwbSection();
+        QByteArray writeFragment(const QList<QDomElement> &elements);
+        static bool copyFragment(QXmlStreamReader &reader, QXmlStreamWriter &writer);
+        bool writeExtendedIwbSection(QIODevice *extendedElements, int elementCount);
         QDomElement parseGroupsPageSection(const QDomElement &groupRoot);
 
         bool createBackground(const QDomElement &element, QMultiMap<int, QDomElement> &dstSvgList);
@@ -47,6 +47,7 @@ const QString tUBZSize = "size";
 const QString tSvg = "svg";
 const QString tIWBPage = "page";
 const QString tIWBPageSet = "pageset";
+const QString tFragment = "fragment";
 const QString tId = "id";
 const QString tElement = "element";
 const QString tUBZGroup = "group";
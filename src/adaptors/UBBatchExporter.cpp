@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBBatchExporter.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QThreadPool>
+
+#include "adaptors/UBExportCFF.h"
+#include "adaptors/UBExportDocument.h"
+#include "adaptors/UBExportFullPDF.h"
+#include "adaptors/UBExportPDF.h"
+#include "adaptors/UBExportWeb.h"
+
+#include "core/UB.h"
+#include "core/UBPersistenceManager.h"
+
+#include "document/UBDocumentProxy.h"
+
+#include "core/memcheck.h"
+
+static const QStringList sFormats{"pdf", "fullpdf", "ubz", "iwb", "web"};
+
+int UBBatchExporter::run(const QStringList& arguments)
+{
+    if (!parseArguments(arguments))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (!QDir().mkpath(mOutputDir))
+    {
+        qWarning() << "Batch export: cannot create output directory" << mOutputDir;
+        return 1;
+    }
+
+    QList<Job> workerJobs;
+    QList<Job> sceneJobs;
+
+    for (const QString& path : std::as_const(mDocumentPaths))
+    {
+        const QList<std::shared_ptr<UBDocumentProxy>> documents = findDocuments(path);
+
+        if (documents.isEmpty())
+        {
+            qWarning() << "Batch export: no document found in" << path;
+        }
+
+        for (const auto& document : documents)
+        {
+            const QString baseName = QFileInfo(document->persistencePath()).fileName();
+
+            for (const QString& format : std::as_const(mFormats))
+            {
+                Job job;
+                job.document = document;
+                job.format = format;
+                job.output = mOutputDir + "/" + baseName + (format == "web" ? QString() : "." + (format == "fullpdf" ? QString("pdf") : format));
+
+                if (format == "fullpdf" && mFormats.contains("pdf"))
+                {
+                    job.output = mOutputDir + "/" + baseName + "-full.pdf";
+                }
+
+                if (runsOnWorkerThread(format))
+                {
+                    workerJobs << job;
+                }
+                else
+                {
+                    sceneJobs << job;
+                }
+            }
+        }
+    }
+
+    QThreadPool pool;
+
+    if (mJobCount > 0)
+    {
+        pool.setMaxThreadCount(mJobCount);
+    }
+
+    QList<QFuture<QJsonObject>> workerResults;
+
+    for (const Job& job : std::as_const(workerJobs))
+    {
+        workerResults << QtConcurrent::run(&pool, &UBBatchExporter::runJob, job);
+    }
+
+    // scenes can only be used on the GUI thread
+    QJsonArray report;
+
+    for (const Job& job : std::as_const(sceneJobs))
+    {
+        report.append(runJob(job));
+    }
+
+    for (auto& result : workerResults)
+    {
+        report.append(result.result());
+    }
+
+    bool success = true;
+
+    for (const auto& entry : std::as_const(report))
+    {
+        success &= entry.toObject().value("success").toBool();
+    }
+
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if (mReportPath.isEmpty())
+    {
+        QTextStream(stdout) << json;
+    }
+    else
+    {
+        QFile reportFile(mReportPath);
+
+        if (!reportFile.open(QIODevice::WriteOnly) || reportFile.write(json) != json.size())
+        {
+            qWarning() << "Batch export: cannot write report" << mReportPath;
+            success = false;
+        }
+    }
+
+    return success ? 0 : 1;
+}
+
+bool UBBatchExporter::parseArguments(const QStringList& arguments)
+{
+    for (int i = 1; i < arguments.size(); ++i)
+    {
+        const QString& argument = arguments.at(i);
+        const bool hasValue = i + 1 < arguments.size();
+
+        if (argument == "--export" && hasValue)
+        {
+            mFormats = arguments.at(++i).toLower().split(',', UB::SplitBehavior::SkipEmptyParts);
+        }
+        else if (argument == "--output" && hasValue)
+        {
+            mOutputDir = QFileInfo(arguments.at(++i)).absoluteFilePath();
+        }
+        else if (argument == "--report" && hasValue)
+        {
+            mReportPath = arguments.at(++i);
+        }
+        else if (argument == "--jobs" && hasValue)
+        {
+            mJobCount = arguments.at(++i).toInt();
+        }
+        else if (!argument.startsWith('-'))
+        {
+            mDocumentPaths << argument;
+        }
+        // other flags are for Qt or the application and are ignored
+    }
+
+    for (const QString& format : std::as_const(mFormats))
+    {
+        if (!sFormats.contains(format))
+        {
+            qWarning() << "Batch export: unknown format" << format;
+            return false;
+        }
+    }
+
+    return !mFormats.isEmpty() && !mOutputDir.isEmpty() && !mDocumentPaths.isEmpty() && mJobCount >= 0;
+}
+
+QList<std::shared_ptr<UBDocumentProxy>> UBBatchExporter::findDocuments(const QString& path) const
+{
+    QList<std::shared_ptr<UBDocumentProxy>> documents;
+    const QDir dir(path);
+
+    if (dir.exists("metadata.rdf"))
+    {
+        documents << UBPersistenceManager::createDocumentProxyStructure(QFileInfo(dir.absolutePath()));
+        return documents;
+    }
+
+    const QFileInfoList subDirs = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+
+    for (const QFileInfo& subDir : subDirs)
+    {
+        if (QFileInfo::exists(subDir.absoluteFilePath() + "/metadata.rdf"))
+        {
+            documents << UBPersistenceManager::createDocumentProxyStructure(subDir);
+        }
+    }
+
+    return documents;
+}
+
+/**
+ * @brief Formats which work from the document files and do not need scenes
+ *
+ * The iwb conversion reads the page files and only paints on images, which is safe off the GUI
+ * thread.
+ */
+bool UBBatchExporter::runsOnWorkerThread(const QString& format)
+{
+    return format == "ubz" || format == "web" || format == "iwb";
+}
+
+UBExportAdaptor* UBBatchExporter::createExporter(const QString& format)
+{
+    if (format == "pdf")
+        return new UBExportPDF();
+    if (format == "fullpdf")
+        return new UBExportFullPDF();
+    if (format == "ubz")
+        return new UBExportDocument();
+    if (format == "iwb")
+        return new UBExportCFF();
+    if (format == "web")
+        return new UBExportWeb();
+
+    return nullptr;
+}
+
+QJsonObject UBBatchExporter::runJob(const Job& job)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool success = false;
+    UBExportAdaptor* exporter = createExporter(job.format);
+
+    if (exporter && !job.document->isBroken())
+    {
+        exporter->setVerbose(false);
+        success = exporter->persistsDocument(job.document, job.output);
+    }
+
+    delete exporter;
+
+    QJsonObject result;
+    result["document"] = job.document->persistencePath();
+    result["name"] = job.document->name();
+    result["format"] = job.format;
+    result["output"] = job.output;
+    result["success"] = success;
+    result["pages"] = job.document->pageCount();
+    result["milliseconds"] = timer.elapsed();
+
+    qDebug() << "Batch export:" << job.format << job.document->persistencePath() << (success ? "done in" : "failed after") << timer.elapsed() << "ms";
+
+    return result;
+}
+
+void UBBatchExporter::printUsage()
+{
+    QTextStream(stderr) << "Usage: OpenBoard --export <formats> --output <directory> [--jobs <count>] [--report <file>] <document>...\n"
+                        << "  <formats>   comma separated list of: " << sFormats.join(", ") << "\n"
+                        << "  <document>  a document folder, or a folder containing document folders\n";
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QJsonObject>
+#include <QStringList>
+#include <memory>
+
+class UBDocumentProxy;
+class UBExportAdaptor;
+
+/**
+ * Headless export of documents from the command line.
+ *
+ *     OpenBoard --export pdf,ubz --output <dir> [--jobs <n>] [--report <file>] <document>...
+ *
+ * Each document argument is either a document folder or a folder containing document
+ * folders, such as the user's document library. Supported formats are pdf, fullpdf (PDF
+ * merged with the original PDF pages), ubz, iwb and web.
+ *
+ * Exports that work from the document files (ubz, web and iwb) run on a pool of worker
+ * threads. Exports that need graphics scenes run on the GUI thread, concurrently with the
+ * former, and use worker threads internally. A JSON report with the duration of each export
+ * is written to the report file, or to the standard output.
+ */
+class UBBatchExporter
+{
+public:
+    int run(const QStringList& arguments);
+
+private:
+    struct Job
+    {
+        std::shared_ptr<UBDocumentProxy> document;
+        QString format;
+        QString output;
+    };
+
+    bool parseArguments(const QStringList& arguments);
+    QList<std::shared_ptr<UBDocumentProxy>> findDocuments(const QString& path) const;
+    static bool runsOnWorkerThread(const QString& format);
+    static UBExportAdaptor* createExporter(const QString& format);
+    static QJsonObject runJob(const Job& job);
+    static void printUsage();
+
+    QStringList mFormats{};
+    QStringList mDocumentPaths{};
+    QString mOutputDir{};
+    QString mReportPath{};
+    int mJobCount{0};
+};
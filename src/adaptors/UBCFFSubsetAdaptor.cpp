@@ -120,6 +120,66 @@ static QString aEditable        = "editable";
 static QString apRotate         = "rotate";
 static QString apTranslate      = "translate";
 
+/**
+ * @brief Create a DOM element of document from the start element at the current position of reader
+ *
+ * Like QDomDocument::setContent with namespace processing, the element and its attributes keep
+ * their namespace.
+ */
+static QDomElement createDomElement(const QXmlStreamReader& reader, QDomDocument& document)
+{
+    QDomElement element = document.createElementNS(reader.namespaceUri().toString(), reader.qualifiedName().toString());
+
+    for (const QXmlStreamAttribute& attribute : reader.attributes())
+        element.setAttributeNS(attribute.namespaceUri().toString(), attribute.qualifiedName().toString(), attribute.value().toString());
+
+    return element;
+}
+
+/**
+ * @brief Read the element at the current position of reader and its content into document
+ *
+ * Only this element is held in memory, so that a whole IWB content is never loaded into one DOM
+ * tree. Like QDomDocument::setContent, comments and whitespace-only text are dropped.
+ */
+static QDomElement readDomElement(QXmlStreamReader& reader, QDomDocument& document)
+{
+    QDomElement root = createDomElement(reader, document);
+    document.appendChild(root);
+
+    QDomElement current = root;
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+
+        if (reader.isStartElement()) {
+            QDomElement child = createDomElement(reader, document);
+            current.appendChild(child);
+            current = child;
+        } else if (reader.isEndElement()) {
+            if (current == root)
+                break;
+
+            current = current.parentNode().toElement();
+        } else if (reader.isCDATA()) {
+            current.appendChild(document.createCDATASection(reader.text().toString()));
+        } else if (reader.isCharacters() && !reader.isWhitespace()) {
+            current.appendChild(document.createTextNode(reader.text().toString()));
+        }
+    }
+
+    return root;
+}
+
+/**
+ * @brief Skip the remaining children of the current element of reader, and its end
+ */
+static void skipRemainingElements(QXmlStreamReader& reader)
+{
+    while (reader.readNextStartElement())
+        reader.skipCurrentElement();
+}
+
 UBCFFSubsetAdaptor::UBCFFSubsetAdaptor()
 {}
 
@@ -146,16 +206,9 @@ bool UBCFFSubsetAdaptor::ConvertCFFFileToUbz(QString &cffSourceFile, std::shared
 UBCFFSubsetAdaptor::UBCFFSubsetReader::UBCFFSubsetReader(std::shared_ptr<UBDocumentProxy>proxy, QFile *content)
     : mProxy(proxy)
     , mGSectionContainer(NULL)
+    , mContent(content)
 {
-    int errorLine, errorColumn;
-    QString errorStr;
-    if(!mDOMdoc.setContent(content, true, &errorStr, &errorLine, &errorColumn)){
-        qWarning() << "Error:Parseerroratline" << errorLine << ","
-                  << "column" << errorColumn << ":" << errorStr;
-    } else {
-        qDebug() << "well parsed to DOM";
-        pwdContent = QFileInfo(content->fileName()).dir().absolutePath();
-    }
+    pwdContent = QFileInfo(content->fileName()).dir().absolutePath();
     qDebug() << "tmp path is" << pwdContent;
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parse()
@@ -166,9 +219,6 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parse()
     if (!getTempFileName() || !createTempFlashPath())
         return false;
 
-    if (mDOMdoc.isNull())
-        return false;
-
     bool result = parseDoc();
     if (result)
         result = mProxy->pageCount() != 0;
@@ -1132,16 +1182,6 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPage(const QDomElement &pare
 
     return true;
 }
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPageset(const QDomElement &parent)
-{
-    QDomElement currentPage = parent.firstChildElement(tPage);
-    while (!currentPage.isNull()) {
-        if (!parseSvgPage(currentPage))
-            return false;
-        currentPage = currentPage.nextSiblingElement(tPage);
-    }
-    return true;
-}
 
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseIwbMeta(const QDomElement &element)
 {
@@ -1152,22 +1192,57 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseIwbMeta(const QDomElement &elem
 
     return true;
 }
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvg(const QDomElement &svgSection)
+/**
+ * @brief Read the svg section at the current position of reader, one page or one element at a time
+ */
+bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvg(QXmlStreamReader &reader)
 {
-    if (svgSection.namespaceURI() != svgNS) {
+    if (reader.namespaceUri() != svgNS) {
         qWarning() << "incorrect svg namespace, incorrect document";
        // return false;
     }
 
-    parseSvgSectionAttr(svgSection);
-    QDomElement currentSvg = svgSection.firstChildElement();
+    QDomDocument sectionDocument;
+    parseSvgSectionAttr(createDomElement(reader, sectionDocument));
 
-    if (currentSvg.tagName() != tPageset) {
-        parseSvgPage(svgSection);
-    } else if (currentSvg.tagName() == tPageset){
-        parseSvgPageset(currentSvg);
+    if (!reader.readNextStartElement()) {
+        // empty section, still a page
+        createNewScene();
+        return true;
     }
 
+    if (reader.name() == tPageset) {
+        while (reader.readNextStartElement()) {
+            if (reader.name() != tPage) {
+                reader.skipCurrentElement();
+                continue;
+            }
+
+            QDomDocument pageDocument;
+
+            if (!parseSvgPage(readDomElement(reader, pageDocument))) {
+                skipRemainingElements(reader);
+                break;
+            }
+        }
+
+        // the other elements of the section are ignored
+        skipRemainingElements(reader);
+        return true;
+    }
+
+    // the elements of the section are a single page
+    createNewScene();
+
+    do {
+        QDomDocument elementDocument;
+
+        if (!parseSvgElement(readDomElement(reader, elementDocument))) {
+            skipRemainingElements(reader);
+            break;
+        }
+    } while (reader.readNextStartElement());
+
     return true;
 }
 
@@ -1306,16 +1381,41 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseIwbElement(QDomElement &element
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseDoc()
 {
-    QDomElement currentTopElement = mDOMdoc.documentElement().firstChildElement();
-    while (!currentTopElement.isNull()) {
-        QString tagName = currentTopElement.tagName();
+    // the content is streamed, only the top element being parsed is held in a DOM tree
+    QXmlStreamReader reader(mContent);
+
+    if (!reader.readNextStartElement()) {
+        qWarning() << "Error: no root element in the content" << reader.errorString();
+        return false;
+    }
+
+    while (reader.readNextStartElement()) {
+        QString tagName = reader.name().toString();
+
+        if (tagName == tSvg) {
+            if (!parseSvg(reader)) return false;
+            continue;
+        }
+
+        if (tagName != tMeta && tagName != tGroup && tagName != tElement) {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        QDomDocument document;
+        QDomElement currentTopElement = readDomElement(reader, document);
+
         if      (tagName == tMeta       && !parseIwbMeta(currentTopElement))    return false;
-        else if (tagName == tSvg        && !parseSvg(currentTopElement))        return false;
         else if (tagName == tGroup      && !parseIwbGroup(currentTopElement))   return false;
         else if (tagName == tElement    && !parseIwbElement(currentTopElement)) return false;
+    }
 
-        currentTopElement = currentTopElement.nextSiblingElement();
+    if (reader.hasError()) {
+        qWarning() << "Error:Parseerroratline" << reader.lineNumber() << ","
+                  << "column" << reader.columnNumber() << ":" << reader.errorString();
+        return false;
     }
+
     if (!persistScenes()) return false;
 
     return true;
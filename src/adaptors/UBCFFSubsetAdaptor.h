@@ -84,7 +84,7 @@ private:
         UBGraphicsGroupContainerItem *mGSectionContainer;
 
     private:
-        QDomDocument mDOMdoc;
+        QIODevice *mContent;
         QDomNode mCurrentDOMElement;
         QHash<QString, UBGraphicsItem*> persistedItems;
         QMap<QString, QString> mRefToUuidMap;
@@ -99,10 +99,9 @@ private:
 
         inline void parseSvgSectionAttr(const QDomElement &);
         bool parseSvgPage(const QDomElement &parent);
-        bool parseSvgPageset(const QDomElement &parent);
         bool parseSvgElement(const QDomElement &parent);
         bool parseIwbMeta(const QDomElement &element);
-        bool parseSvg(const QDomElement &svgSection);
+        bool parseSvg(QXmlStreamReader &reader);
 
         inline bool parseGSection(const QDomElement &element);
         inline bool parseSvgSwitchSection(const QDomElement &element);
@@ -28,6 +28,7 @@
 #include <QFileDialog>
 
 #include "UBExportAdaptor.h"
+#include "UBThumbnailWriter.h"
 
 #include "document/UBDocumentProxy.h"
 
@@ -146,6 +147,9 @@ void UBExportAdaptor::persistLocally(std::shared_ptr<UBDocumentProxy> pDocumentP
             return;
         }
 
+        // the exported files include the thumbnails
+        UBThumbnailWriter::writer()->flush();
+
         bool persisted = this->persistsDocument(pDocumentProxy, filename);
 
         if (mIsVerbose && persisted)
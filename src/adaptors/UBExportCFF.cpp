@@ -93,6 +93,12 @@ void UBExportCFF::persist(std::shared_ptr<UBDocumentProxy> pDocument)
     
 }
 
+bool UBExportCFF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocument, const QString& filename)
+{
+    UBCFFAdaptor toIWBExporter;
+    return toIWBExporter.convertUBZToIWB(pDocument->persistencePath(), filename);
+}
+
 bool UBExportCFF::associatedActionactionAvailableFor(const QModelIndex &selectedIndex)
 {
     const UBDocumentTreeModel *docModel = qobject_cast<const UBDocumentTreeModel*>(selectedIndex.model());
@@ -47,6 +47,7 @@ public:
     virtual QString exportName();
     virtual QString exportExtention();
     virtual void persist(std::shared_ptr<UBDocumentProxy> pDocument);
+    virtual bool persistsDocument(std::shared_ptr<UBDocumentProxy> pDocument, const QString& filename);
     virtual bool associatedActionactionAvailableFor(const QModelIndex &selectedIndex);
 };
 
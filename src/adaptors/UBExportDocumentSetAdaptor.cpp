@@ -78,7 +78,7 @@ void UBExportDocumentSetAdaptor::persist(std::shared_ptr<UBDocumentProxy> pDocum
         filename = askForFileName(pDocumentProxy, tr("Export as UBX File"));
 
     } else {
-        treeViewParentIndex = UBApplication::documentController->firstSelectedTreeIndex();
+        treeViewParentIndex = UBApplication::documentController()->firstSelectedTreeIndex();
         if (!treeViewParentIndex.isValid()) {
             qDebug() << "failed to export";
             UBApplication::showMessage(tr("Failed to export..."));
@@ -49,6 +49,7 @@
 #include "pdf/GraphicsPDFItem.h"
 
 #include "UBExportPDF.h"
+#include "UBExportPDFPipeline.h"
 
 #include <Merger.h>
 #include <Exception.h>
@@ -103,18 +104,23 @@ void UBExportFullPDF::saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentP
         pdfPrinter.setOutputFileName(filename);
         pdfPrinter.setFullPage(true);
 
-        QPainter* pdfPainter = 0;
+        const bool exportBackgroundColor = UBSettings::settings()->exportBackgroundColor->get().toBool();
+        const bool exportBackgroundGrid = UBSettings::settings()->exportBackgroundGrid->get().toBool();
 
-        for(int pageIndex = 0 ; pageIndex < pDocumentProxy->pageCount(); pageIndex++)
-        {
-            std::shared_ptr<UBGraphicsScene> scene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, pageIndex);
-            // set background according to PDF export settings
-            bool isDark = scene->isDarkBackground();
-            UBPageBackground pageBackground = scene->pageBackground();
+        // background state of the page being exported, restored on cached scenes
+        bool isDark = false;
+        UBPageBackground pageBackground = UBPageBackground::plain;
+
+        mPageInfos.fill(PageInfo(), pDocumentProxy->pageCount());
 
-            bool exportDark = isDark && UBSettings::settings()->exportBackgroundColor->get().toBool();
+        UBExportPDFPipeline pipeline(pDocumentProxy, &pdfPrinter);
+
+        auto prepare = [&](UBGraphicsScene* scene, int pageIndex) -> QSizeF {
+            // set background according to PDF export settings
+            isDark = scene->isDarkBackground();
+            pageBackground = scene->pageBackground();
 
-            bool sceneHasPDFBackground = false;
+            bool exportDark = isDark && exportBackgroundColor;
 
             // set high res rendering
             scene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
@@ -126,31 +132,29 @@ void UBExportFullPDF::saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentP
 
             UBGraphicsPDFItem *pdfItem = qgraphicsitem_cast<UBGraphicsPDFItem*>(scene->backgroundObject());
 
+            PageInfo& pageInfo = mPageInfos[pageIndex];
+            pageInfo.annotationsRect = scene->normalizedSceneRect();
+            pageInfo.nominalSize = scene->nominalSize();
+
             if (pdfItem)
             {
                 mHasPDFBackgrounds = true;
-                sceneHasPDFBackground = true;
                 pageSize = pdfItem->pageSize();     // original PDF document page size
-            }
-            else
-            {
-                sceneHasPDFBackground = false;
-            }
-
-            QPageSize size(pageSize, QPageSize::Point);
-            pdfPrinter.setPageSize(size);
 
-            if (!pdfPainter) pdfPainter = new QPainter(&pdfPrinter);
-
-            if (pageIndex != 0) pdfPrinter.newPage();
+                pageInfo.hasPDFBackground = true;
+                pageInfo.pdfFileUuid = pdfItem->fileUuid();
+                pageInfo.pdfPageNumber = pdfItem->pageNumber();
+                pageInfo.pdfPageSize = pdfItem->pageSize();
+                pageInfo.pdfSceneRect = pdfItem->sceneBoundingRect();
+            }
 
             // do not draw background color and grid if scene has PDF background
-            if (sceneHasPDFBackground)
+            if (pdfItem)
             {
                 scene->setDrawingMode(true);
                 scene->setBackground(false, UBPageBackground::plain);
             }
-            else if (UBSettings::settings()->exportBackgroundGrid->get().toBool())
+            else if (exportBackgroundGrid)
             {
                 scene->setBackground(exportDark, pageBackground);
             }
@@ -159,9 +163,10 @@ void UBExportFullPDF::saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentP
                 scene->setBackground(exportDark, UBPageBackground::plain);
             }
 
-            //render to PDF
-            scene->render(pdfPainter, QRectF(), scene->normalizedSceneRect());
+            return pageSize;
+        };
 
+        auto restore = [&](UBGraphicsScene* scene) {
             //restore screen rendering quality
             scene->setRenderingContext(UBGraphicsScene::Screen);
             scene->setRenderingQuality(UBItem::RenderingQualityNormal, UBItem::CacheAllowed);
@@ -169,9 +174,12 @@ void UBExportFullPDF::saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentP
             //restore background state
             scene->setDrawingMode(false);
             scene->setBackground(isDark, pageBackground);
-        }
+        };
 
-        if (pdfPainter) delete pdfPainter;
+        if (!pipeline.run(prepare, restore))
+        {
+            qWarning() << "cannot write PDF file" << filename;
+        }
     }
     else
     {
@@ -223,17 +231,16 @@ bool UBExportFullPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumen
 
             for(int pageIndex = 0 ; pageIndex < existingPageCount; pageIndex++)
             {
-                std::shared_ptr<UBGraphicsScene> scene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, pageIndex);
-                UBGraphicsPDFItem *pdfItem = qgraphicsitem_cast<UBGraphicsPDFItem*>(scene->backgroundObject());
+                const PageInfo& pageInfo = mPageInfos.at(pageIndex);
 
-                if (pdfItem)
+                if (pageInfo.hasPDFBackground)
                 {
-                    QString pdfName = UBPersistenceManager::objectDirectory + "/" + pdfItem->fileUuid().toString() + ".pdf";
+                    QString pdfName = UBPersistenceManager::objectDirectory + "/" + pageInfo.pdfFileUuid.toString() + ".pdf";
                     QString backgroundPath = pDocumentProxy->persistencePath() + "/" + pdfName;
 
                     // Original data in scene coordinates, annotationsRect always contains pdfSceneRect
-                    QRectF pdfSceneRect = pdfItem->sceneBoundingRect();
-                    QRectF annotationsRect = scene->normalizedSceneRect();
+                    QRectF pdfSceneRect = pageInfo.pdfSceneRect;
+                    QRectF annotationsRect = pageInfo.annotationsRect;
 
                     double xAnnotation = annotationsRect.x();
                     double yAnnotation = annotationsRect.y();
@@ -253,7 +260,7 @@ bool UBExportFullPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumen
                     // Compute scaling of PDF on the scene
                     // If the PDF was scaled when added to the scene (e.g if it was loaded from a document with a different DPI
                     // than the current one), it should also be scaled here.
-                    QSizeF pageSize = pdfItem->pageSize();
+                    QSizeF pageSize = pageInfo.pdfPageSize;
                     double pdfScale = pdfSceneRect.width() / pageSize.width() * dpiScale;
 
                     // Offsets are calculated in the PDF coordinate system.
@@ -271,7 +278,7 @@ bool UBExportFullPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumen
 
                     MergePageDescription pageDescription(pageSize.width(),
                                                          pageSize.height(),
-                                                         pdfItem->pageNumber(),
+                                                         pageInfo.pdfPageNumber,
                                                          QFile::encodeName(backgroundPath).constData(),
                                                          pdfTransform,
                                                          pageIndex + 1,
@@ -284,7 +291,7 @@ bool UBExportFullPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumen
                 }
                 else
                 {
-                    QSizeF pageSize = scene->nominalSize() * mScaleFactor;
+                    QSizeF pageSize = pageInfo.nominalSize * mScaleFactor;
 
                     MergePageDescription pageDescription(pageSize.width(),
                              pageSize.height(),
@@ -55,8 +55,21 @@ class UBExportFullPDF : public UBExportAdaptor
         void saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const QString& filename);
 
     private:
+        // what the PDF merger needs to know about a page, collected while exporting the overlay
+        struct PageInfo
+        {
+            bool hasPDFBackground{false};
+            QUuid pdfFileUuid{};
+            int pdfPageNumber{0};
+            QSizeF pdfPageSize{};
+            QRectF pdfSceneRect{};
+            QRectF annotationsRect{};
+            QSizeF nominalSize{};
+        };
+
         float mScaleFactor;
         bool mHasPDFBackgrounds;
+        QVector<PageInfo> mPageInfos;
 
         UBExportPDF * mSimpleExporter;
 };
@@ -49,6 +49,8 @@
 
 #include "pdf/GraphicsPDFItem.h"
 
+#include "UBExportPDFPipeline.h"
+
 #include "core/memcheck.h"
 
 UBExportPDF::UBExportPDF(QObject *parent)
@@ -94,23 +96,23 @@ bool UBExportPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumentPro
     float dpiCommon = UBApplication::displayManager->logicalDpi(ScreenRole::Control);
     float scaleFactor = dpiCommon ? 72.0f / dpiCommon : 1.f;
 
-    QPainter pdfPainter;
-    bool painterNeedsBegin = true;
-
-    int existingPageCount = pDocumentProxy->pageCount();
+    const bool exportBackgroundColor = UBSettings::settings()->exportBackgroundColor->get().toBool();
+    const bool exportBackgroundGrid = UBSettings::settings()->exportBackgroundGrid->get().toBool();
 
-    for(int pageIndex = 0 ; pageIndex < existingPageCount; pageIndex++) {
+    // background state of the page being exported, restored on cached scenes
+    bool isDark = false;
+    UBPageBackground pageBackground = UBPageBackground::plain;
 
-        std::shared_ptr<UBGraphicsScene> scene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, pageIndex);
-        UBApplication::showMessage(tr("Exporting page %1 of %2").arg(pageIndex + 1).arg(existingPageCount));
+    UBExportPDFPipeline pipeline(pDocumentProxy, &pdfWriter);
 
+    auto prepare = [&](UBGraphicsScene* scene, int) -> QSizeF {
         // set background to white, no crossing for PDF output
-        bool isDark = scene->isDarkBackground();
-        UBPageBackground pageBackground = scene->pageBackground();
+        isDark = scene->isDarkBackground();
+        pageBackground = scene->pageBackground();
 
-        bool exportDark = isDark && UBSettings::settings()->exportBackgroundColor->get().toBool();
+        bool exportDark = isDark && exportBackgroundColor;
 
-        if (UBSettings::settings()->exportBackgroundGrid->get().toBool())
+        if (exportBackgroundGrid)
         {
             scene->setBackground(exportDark, pageBackground);
         }
@@ -119,38 +121,31 @@ bool UBExportPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumentPro
             scene->setBackground(exportDark, UBPageBackground::plain);
         }
 
-        // pageSize is the output PDF page size; it is set to equal the scene's boundary size; if the contents
-        // of the scene overflow from the boundaries, they will be scaled down.
-        QSize pageSize = scene->sceneSize();
-
         // set high res rendering
         scene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
         scene->setRenderingContext(UBGraphicsScene::NonScreen);
 
-        // Setting output page size
-        QPageSize outputPageSize = QPageSize(QSizeF(pageSize.width()*scaleFactor, pageSize.height()*scaleFactor), QPageSize::Point);
-        pdfWriter.setPageSize(outputPageSize);
-
-        // Call begin only once
-        if(painterNeedsBegin)
-            painterNeedsBegin = !pdfPainter.begin(&pdfWriter);
-
-        else if (pageIndex < existingPageCount)
-            pdfWriter.newPage();
+        // pageSize is the output PDF page size; it is set to equal the scene's boundary size; if the contents
+        // of the scene overflow from the boundaries, they will be scaled down.
+        QSize pageSize = scene->sceneSize();
 
-        // Render the scene
-        scene->render(&pdfPainter, QRectF(), scene->normalizedSceneRect());
+        return QSizeF(pageSize.width() * scaleFactor, pageSize.height() * scaleFactor);
+    };
 
+    auto restore = [&](UBGraphicsScene* scene) {
         // Restore screen rendering quality
         scene->setRenderingContext(UBGraphicsScene::Screen);
         scene->setRenderingQuality(UBItem::RenderingQualityNormal, UBItem::CacheAllowed);
 
         // Restore background state
         scene->setBackground(isDark, pageBackground);
-    }
+    };
 
-    if(!painterNeedsBegin)
-        pdfPainter.end();
+    if (!pipeline.run(prepare, restore))
+    {
+        qWarning() << "cannot write PDF file" << filename;
+        return false;
+    }
 
     return true;
 }
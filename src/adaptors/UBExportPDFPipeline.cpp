@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBExportPDFPipeline.h"
+
+#include <QPagedPaintDevice>
+#include <QPaintEngine>
+#include <QPainter>
+#include <QThread>
+#include <QtConcurrent>
+
+#include "adaptors/UBSvgSubsetAdaptor.h"
+#include "core/UBApplication.h"
+#include "core/UBPersistenceManager.h"
+#include "document/UBDocumentProxy.h"
+#include "domain/UBGraphicsScene.h"
+
+#include "core/memcheck.h"
+
+/**
+ * Paint engine forwarding to a QPicture, with pixmaps turned into images.
+ *
+ * A recorded pixmap becomes a QPixmap again when the picture is played, which is not
+ * supported outside the GUI thread. Images can be played on any thread.
+ */
+class UBImagePictureEngine : public QPaintEngine
+{
+public:
+    explicit UBImagePictureEngine(QPicture* picture)
+        : QPaintEngine(QPaintEngine::AllFeatures)
+        , mPicture(picture)
+    {
+    }
+
+    bool begin(QPaintDevice*) override
+    {
+        return mPainter.begin(mPicture);
+    }
+
+    bool end() override
+    {
+        return mPainter.end();
+    }
+
+    void updateState(const QPaintEngineState& state) override
+    {
+        const QPaintEngine::DirtyFlags flags = state.state();
+
+        if (flags & DirtyPen)
+        {
+            QPen pen = state.pen();
+            pen.setBrush(imageBrush(pen.brush()));
+            mPainter.setPen(pen);
+        }
+
+        if (flags & DirtyBrush)
+            mPainter.setBrush(imageBrush(state.brush()));
+
+        if (flags & DirtyBrushOrigin)
+            mPainter.setBrushOrigin(state.brushOrigin());
+
+        if (flags & DirtyFont)
+            mPainter.setFont(state.font());
+
+        if (flags & DirtyBackground)
+            mPainter.setBackground(imageBrush(state.backgroundBrush()));
+
+        if (flags & DirtyBackgroundMode)
+            mPainter.setBackgroundMode(state.backgroundMode());
+
+        // same order as the picture engine, the clip is set with the current transform
+        if (flags & DirtyTransform)
+            mPainter.setTransform(state.transform());
+
+        if (flags & DirtyClipEnabled)
+            mPainter.setClipping(state.isClipEnabled());
+
+        if (flags & DirtyClipRegion)
+            mPainter.setClipRegion(state.clipRegion(), state.clipOperation());
+
+        if (flags & DirtyClipPath)
+            mPainter.setClipPath(state.clipPath(), state.clipOperation());
+
+        if (flags & DirtyHints)
+            mPainter.setRenderHints(state.renderHints());
+
+        if (flags & DirtyCompositionMode)
+            mPainter.setCompositionMode(state.compositionMode());
+
+        if (flags & DirtyOpacity)
+            mPainter.setOpacity(state.opacity());
+    }
+
+    void drawPath(const QPainterPath& path) override
+    {
+        mPainter.drawPath(path);
+    }
+
+    void drawPolygon(const QPointF* points, int pointCount, PolygonDrawMode mode) override
+    {
+        switch (mode)
+        {
+        case PolylineMode:
+            mPainter.drawPolyline(points, pointCount);
+            break;
+
+        case ConvexMode:
+            mPainter.drawConvexPolygon(points, pointCount);
+            break;
+
+        case OddEvenMode:
+            mPainter.drawPolygon(points, pointCount, Qt::OddEvenFill);
+            break;
+
+        default:
+            mPainter.drawPolygon(points, pointCount, Qt::WindingFill);
+            break;
+        }
+    }
+
+    void drawTextItem(const QPointF& p, const QTextItem& textItem) override
+    {
+        mPainter.drawTextItem(p, textItem);
+    }
+
+    void drawPixmap(const QRectF& r, const QPixmap& pm, const QRectF& sr) override
+    {
+        mPainter.drawImage(r, pm.toImage(), sr);
+    }
+
+    void drawTiledPixmap(const QRectF& r, const QPixmap& pixmap, const QPointF& s) override
+    {
+        QBrush brush(pixmap.toImage());
+        brush.setTransform(QTransform::fromTranslate(r.x() - s.x(), r.y() - s.y()));
+        mPainter.fillRect(r, brush);
+    }
+
+    void drawImage(const QRectF& r, const QImage& pm, const QRectF& sr, Qt::ImageConversionFlags flags) override
+    {
+        mPainter.drawImage(r, pm, sr, flags);
+    }
+
+    Type type() const override
+    {
+        return QPaintEngine::User;
+    }
+
+private:
+    static QBrush imageBrush(const QBrush& brush)
+    {
+        if (brush.style() != Qt::TexturePattern)
+            return brush;
+
+        QBrush imageBrush(brush.textureImage());
+        imageBrush.setTransform(brush.transform());
+        return imageBrush;
+    }
+
+    QPicture* mPicture;
+    QPainter mPainter;
+};
+
+/**
+ * Paint device recording into a QPicture through UBImagePictureEngine.
+ */
+class UBImagePictureRecorder : public QPaintDevice
+{
+public:
+    explicit UBImagePictureRecorder(QPicture* picture)
+        : mPicture(picture)
+        , mEngine(picture)
+    {
+    }
+
+    QPaintEngine* paintEngine() const override
+    {
+        return &mEngine;
+    }
+
+protected:
+    int metric(PaintDeviceMetric metric) const override
+    {
+        // fonts are resolved as for the picture itself
+        switch (metric)
+        {
+        case PdmWidth:
+            return mPicture->width();
+        case PdmHeight:
+            return mPicture->height();
+        case PdmWidthMM:
+            return mPicture->widthMM();
+        case PdmHeightMM:
+            return mPicture->heightMM();
+        case PdmNumColors:
+            return mPicture->colorCount();
+        case PdmDepth:
+            return mPicture->depth();
+        case PdmDpiX:
+            return mPicture->logicalDpiX();
+        case PdmDpiY:
+            return mPicture->logicalDpiY();
+        case PdmPhysicalDpiX:
+            return mPicture->physicalDpiX();
+        case PdmPhysicalDpiY:
+            return mPicture->physicalDpiY();
+        default:
+            return QPaintDevice::metric(metric);
+        }
+    }
+
+private:
+    QPicture* mPicture;
+    mutable UBImagePictureEngine mEngine;
+};
+
+
+UBExportPDFPipeline::UBExportPDFPipeline(std::shared_ptr<UBDocumentProxy> proxy, QPagedPaintDevice* device)
+    : mProxy{proxy}
+    , mDevice{device}
+{
+    // number of pages read ahead, and of recorded pages waiting for the writer
+    mWindow = qBound(2, QThread::idealThreadCount(), 8);
+    mFreeSlots.release(mWindow);
+}
+
+/**
+ * @brief Render all pages, returns false if the device could not be painted on
+ */
+bool UBExportPDFPipeline::run(const PagePreparer& prepare, const PageRestorer& restore)
+{
+    // a headless export has no scene cache to share
+    UBPersistenceManager* persistenceManager = UBApplication::isHeadless ? nullptr : UBPersistenceManager::persistenceManager();
+    const int pageCount = mProxy->pageCount();
+
+    QThread* writer = QThread::create([this]() { write(); });
+    writer->start();
+
+    std::deque<QFuture<QByteArray>> pageFiles;
+    int nextRead = 0;
+
+    for (int pageIndex = 0; pageIndex < pageCount; ++pageIndex)
+    {
+        for (; nextRead < pageCount && nextRead < pageIndex + mWindow; ++nextRead)
+        {
+            if (persistenceManager && persistenceManager->isSceneInCached(mProxy, nextRead))
+            {
+                pageFiles.push_back(QFuture<QByteArray>());
+            }
+            else
+            {
+                pageFiles.push_back(QtConcurrent::run(&UBSvgSubsetAdaptor::loadSceneAsText, mProxy, nextRead));
+            }
+        }
+
+        QFuture<QByteArray> pageFile = pageFiles.front();
+        pageFiles.pop_front();
+
+        UBApplication::showMessage(QCoreApplication::translate("UBExportPDF", "Exporting page %1 of %2").arg(pageIndex + 1).arg(pageCount));
+
+        const bool cached = persistenceManager && persistenceManager->isSceneInCached(mProxy, pageIndex);
+        std::shared_ptr<UBGraphicsScene> scene;
+
+        if (cached)
+        {
+            scene = persistenceManager->getDocumentScene(mProxy, pageIndex);
+        }
+        else
+        {
+            // the page may have been cached while reading ahead
+            const QByteArray content = pageFile.isCanceled() || pageFile.resultCount() == 0 ? UBSvgSubsetAdaptor::loadSceneAsText(mProxy, pageIndex) : pageFile.result();
+
+            if (!content.isEmpty())
+            {
+                scene = UBSvgSubsetAdaptor::loadScene(mProxy, content);
+            }
+        }
+
+        if (!scene)
+        {
+            // a blank page of the nominal size keeps the following pages in place
+            qWarning() << "PDF export: cannot load page" << pageIndex + 1 << "of" << mProxy->name() << ", exporting a blank page";
+            scene = std::make_shared<UBGraphicsScene>(mProxy, false);
+        }
+
+        Page page;
+        page.pageSize = prepare(scene.get(), pageIndex);
+        page.sourceRect = scene->normalizedSceneRect();
+
+        UBImagePictureRecorder recorder(&page.picture);
+        QPainter recorderPainter(&recorder);
+        scene->render(&recorderPainter, QRectF(QPointF(), page.sourceRect.size()), page.sourceRect);
+        recorderPainter.end();
+
+        if (cached)
+        {
+            restore(scene.get());
+        }
+
+        scene.reset();
+
+        mFreeSlots.acquire();
+
+        {
+            QMutexLocker lock{&mMutex};
+            mPages.push_back(std::move(page));
+        }
+
+        mUsedSlots.release();
+    }
+
+    {
+        QMutexLocker lock{&mMutex};
+        mFinished = true;
+    }
+
+    mUsedSlots.release();
+
+    writer->wait();
+    delete writer;
+
+    return mSuccess;
+}
+
+/**
+ * @brief Play the recorded pages on the device, runs on the writer thread
+ */
+void UBExportPDFPipeline::write()
+{
+    QPainter painter;
+    bool painterNeedsBegin = true;
+
+    while (true)
+    {
+        mUsedSlots.acquire();
+
+        Page page;
+
+        {
+            QMutexLocker lock{&mMutex};
+
+            if (mPages.empty() && mFinished)
+            {
+                break;
+            }
+
+            page = std::move(mPages.front());
+            mPages.pop_front();
+        }
+
+        mFreeSlots.release();
+
+        if (!mSuccess)
+        {
+            // keep draining the pages so that the GUI thread is never blocked
+            continue;
+        }
+
+        mDevice->setPageSize(QPageSize(page.pageSize, QPageSize::Point));
+
+        // call begin only once
+        if (painterNeedsBegin)
+        {
+            painterNeedsBegin = !painter.begin(mDevice);
+            mSuccess = !painterNeedsBegin;
+
+            if (!mSuccess)
+            {
+                continue;
+            }
+        }
+        else
+        {
+            mDevice->newPage();
+        }
+
+        // same placement as QGraphicsScene::render: keep the aspect ratio and center on the page
+        const QSizeF deviceSize(mDevice->width(), mDevice->height());
+        const QSizeF sourceSize = page.sourceRect.size();
+        const qreal scale = qMin(deviceSize.width() / sourceSize.width(), deviceSize.height() / sourceSize.height());
+
+        painter.save();
+        painter.translate((deviceSize.width() - sourceSize.width() * scale) / 2, (deviceSize.height() - sourceSize.height() * scale) / 2);
+        painter.scale(scale, scale);
+        painter.drawPicture(0, 0, page.picture);
+        painter.restore();
+    }
+
+    if (!painterNeedsBegin)
+    {
+        painter.end();
+    }
+}
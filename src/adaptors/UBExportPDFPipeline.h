@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QMutex>
+#include <QPicture>
+#include <QSemaphore>
+#include <QSizeF>
+#include <deque>
+#include <functional>
+#include <memory>
+
+class QPagedPaintDevice;
+class UBDocumentProxy;
+class UBGraphicsScene;
+
+/**
+ * Renders all pages of a document on a paged device, such as a PDF writer.
+ *
+ * Page files are read ahead on worker threads and their scenes are loaded without going
+ * through the scene cache, unless the page is already cached and may hold unsaved changes.
+ * Graphics scenes can only be used on the GUI thread, so each scene is recorded there into
+ * a QPicture, which is cheap. Pixmaps are recorded as images, so that playing the picture
+ * creates no pixmap. The pictures are then played in page order on the device by a single
+ * writer thread, where the actual PDF encoding takes place. At most a few recorded pages
+ * wait for the writer, so that memory stays flat whatever the page count. A page which
+ * cannot be read is exported blank, so that the following pages keep their index.
+ */
+class UBExportPDFPipeline
+{
+public:
+    /** Set up the scene for export and return the size of the output page in points */
+    using PagePreparer = std::function<QSizeF(UBGraphicsScene* scene, int pageIndex)>;
+
+    /** Restore the state changed by the preparer, called for scenes of the scene cache only */
+    using PageRestorer = std::function<void(UBGraphicsScene* scene)>;
+
+    UBExportPDFPipeline(std::shared_ptr<UBDocumentProxy> proxy, QPagedPaintDevice* device);
+
+    bool run(const PagePreparer& prepare, const PageRestorer& restore);
+
+private:
+    struct Page
+    {
+        QSizeF pageSize{};
+        QRectF sourceRect{};
+        QPicture picture{};
+    };
+
+    void write();
+
+    std::shared_ptr<UBDocumentProxy> mProxy{};
+    QPagedPaintDevice* mDevice{nullptr};
+
+    int mWindow{2};
+    std::deque<Page> mPages{};
+    QMutex mMutex{};
+    QSemaphore mFreeSlots{};
+    QSemaphore mUsedSlots{};
+    bool mFinished{false};
+    bool mSuccess{true};
+};
@@ -28,6 +28,7 @@
 
 
 #include "UBExportWeb.h"
+#include "UBThumbnailWriter.h"
 
 #include "frameworks/UBPlatformUtils.h"
 #include "frameworks/UBFileSystemUtils.h"
@@ -69,16 +70,13 @@ void UBExportWeb::persist(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
         QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
         UBApplication::showMessage(tr("Exporting document..."));
 
-        if(UBFileSystemUtils::copyDir(pDocumentProxy->persistencePath(), dirName))
-        {
-            QString htmlPath = dirName + "/index.html";
-
-            QFile html(":www/OpenBoard-web-player.html");
-            html.copy(htmlPath);
+        UBThumbnailWriter::writer()->flush();
 
+        if(persistsDocument(pDocumentProxy, dirName))
+        {
             UBApplication::showMessage(tr("Export successful."));
 
-            QDesktopServices::openUrl(QUrl::fromLocalFile(htmlPath));
+            QDesktopServices::openUrl(QUrl::fromLocalFile(dirName + "/index.html"));
         }
         else
         {
@@ -95,3 +93,15 @@ QString UBExportWeb::exportName()
 {
     return tr("Export to Web Browser");
 }
+
+
+bool UBExportWeb::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const QString& dirName)
+{
+    if(!UBFileSystemUtils::copyDir(pDocumentProxy->persistencePath(), dirName))
+        return false;
+
+    QFile html(":www/OpenBoard-web-player.html");
+    html.copy(dirName + "/index.html");
+
+    return true;
+}
@@ -47,6 +47,7 @@ class UBExportWeb : public UBExportAdaptor
         virtual QString exportName();
 
         virtual void persist(std::shared_ptr<UBDocumentProxy> pDocument);
+        virtual bool persistsDocument(std::shared_ptr<UBDocumentProxy> pDocument, const QString& dirName);
 
 };
 
@@ -36,6 +36,16 @@
 #include <QDomElement>
 #include <QGraphicsVideoItem>
 #include <QElapsedTimer>
+#include <QSaveFile>
+
+#include <limits>
+#include <zlib.h>
+
+#ifdef Q_OS_OSX
+    #include <quagzipfile.h>
+#else
+    #include "quagzipfile.h"
+#endif
 
 #include "domain/UBGraphicsSvgItem.h"
 #include "domain/UBGraphicsPixmapItem.h"
@@ -67,8 +77,10 @@
 #include "board/UBBoardPaletteManager.h"
 
 #include "frameworks/UBFileSystemUtils.h"
+#include "frameworks/UBGeometryUtils.h"
 #include "frameworks/UBStringUtils.h"
 #include "frameworks/UBFileSystemUtils.h"
+#include "frameworks/UBTrace.h"
 
 #include "core/UBSettings.h"
 #include "core/UBSetting.h"
@@ -98,6 +110,41 @@ const QString tStrokeGroup = "strokeGroup";
 const QString tGroups = "groups";
 const QString aId = "id";
 
+/** Size of the chunks read until the root element of a page is parsed, and upper bound */
+static const int sPageHeaderChunkSize = 4096;
+static const int sMaxPageHeaderSize = 64 * 1024;
+
+/** Number of page headers kept, e.g. the pages of a few large documents */
+static const int sMaxCachedPageHeaders = 8192;
+
+/** Size from which a page is indexed, so that its visible part can be loaded first */
+static const int sProgressiveLoadingMinSize = 1024 * 1024;
+
+namespace
+{
+    struct CachedPageHeader
+    {
+        qint64 size;
+        QDateTime modified;
+        UBSvgSubsetAdaptor::PageHeader header;
+    };
+}
+
+static QMutex sPageHeaderMutex;
+static QHash<QString, CachedPageHeader> sPageHeaders;
+
+/**
+ * @brief Drop the cached header of a page file, to be called when the file is replaced
+ *
+ * The cache only checks the size and modification time, which may not change when a page
+ * file is replaced by another one, e.g. when pages are renamed or copied.
+ */
+void UBSvgSubsetAdaptor::forgetPageHeader(const QString& fileName)
+{
+    QMutexLocker lock(&sPageHeaderMutex);
+    sPageHeaders.remove(fileName);
+}
+
 
 QString UBSvgSubsetAdaptor::toSvgTransform(const QTransform& matrix)
 {
@@ -138,6 +185,178 @@ QTransform UBSvgSubsetAdaptor::fromSvgTransform(const QString& transform)
 
 
 
+/**
+ * Write-only device deflating to another device in the gzip format.
+ */
+class UBGzipWriter : public QIODevice
+{
+public:
+    explicit UBGzipWriter(QIODevice* target)
+        : mTarget(target)
+        , mFailed(false)
+    {
+        memset(&mStream, 0, sizeof(mStream));
+    }
+
+    ~UBGzipWriter()
+    {
+        close();
+    }
+
+    bool open(OpenMode mode) override
+    {
+        // window bits above 15 select the gzip header, which readPageFile() detects
+        if (deflateInit2(&mStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return false;
+
+        mFailed = false;
+        return QIODevice::open(mode);
+    }
+
+    void close() override
+    {
+        if (!isOpen())
+            return;
+
+        if (!deflateTo(Z_FINISH))
+            mFailed = true;
+
+        deflateEnd(&mStream);
+        QIODevice::close();
+    }
+
+    bool failed() const
+    {
+        return mFailed;
+    }
+
+protected:
+    qint64 readData(char*, qint64) override
+    {
+        return -1;
+    }
+
+    qint64 writeData(const char* data, qint64 length) override
+    {
+        qint64 written = 0;
+
+        while (written < length)
+        {
+            const uInt chunk = static_cast<uInt>(qMin<qint64>(length - written, std::numeric_limits<uInt>::max()));
+
+            mStream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + written));
+            mStream.avail_in = chunk;
+
+            if (!deflateTo(Z_NO_FLUSH))
+            {
+                mFailed = true;
+                return -1;
+            }
+
+            written += chunk;
+        }
+
+        return length;
+    }
+
+private:
+    bool deflateTo(int flush)
+    {
+        char buffer[16384];
+
+        do
+        {
+            mStream.next_out = reinterpret_cast<Bytef*>(buffer);
+            mStream.avail_out = sizeof(buffer);
+
+            if (deflate(&mStream, flush) == Z_STREAM_ERROR)
+                return false;
+
+            const qint64 produced = sizeof(buffer) - mStream.avail_out;
+
+            if (produced > 0 && mTarget->write(buffer, produced) != produced)
+                return false;
+        }
+        while (mStream.avail_out == 0);
+
+        return true;
+    }
+
+    QIODevice* mTarget;
+    z_stream mStream;
+    bool mFailed;
+};
+
+
+/**
+ * Writes a page file through a temporary file which replaces the page on commit, so that
+ * an interrupted save never leaves a truncated page. The content is gzip compressed if
+ * requested, readPageFile() detects it.
+ */
+class UBPageFileWriter
+{
+public:
+    UBPageFileWriter(const QString& fileName, bool compress)
+        : mFile(fileName)
+        , mGzipWriter(&mFile)
+        , mCompress(compress)
+    {
+    }
+
+    bool open()
+    {
+        if (!mFile.open(QIODevice::WriteOnly))
+        {
+            qCritical() << "cannot open " << mFile.fileName() << " for writing. Error : " << mFile.errorString();
+            return false;
+        }
+
+        if (mCompress && !mGzipWriter.open(QIODevice::WriteOnly))
+        {
+            qCritical() << "cannot compress " << mFile.fileName();
+            return false;
+        }
+
+        return true;
+    }
+
+    QIODevice* device()
+    {
+        return mCompress ? static_cast<QIODevice*>(&mGzipWriter) : static_cast<QIODevice*>(&mFile);
+    }
+
+    bool commit()
+    {
+        if (mCompress)
+        {
+            mGzipWriter.close();
+
+            if (mGzipWriter.failed())
+            {
+                qCritical() << "cannot compress " << mFile.fileName();
+                mFile.cancelWriting();
+            }
+        }
+
+        const bool committed = mFile.commit();
+        UBSvgSubsetAdaptor::forgetPageHeader(mFile.fileName());
+
+        if (!committed)
+        {
+            qCritical() << "cannot write " << mFile.fileName() << ". Error : " << mFile.errorString();
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    QSaveFile mFile;
+    UBGzipWriter mGzipWriter;
+    bool mCompress;
+};
+
+
 static bool itemZIndexComp(const QGraphicsItem* item1,
                            const QGraphicsItem* item2)
 {
@@ -148,9 +367,11 @@ static bool itemZIndexComp(const QGraphicsItem* item1,
 void UBSvgSubsetAdaptor::upgradeScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
     //4.2
-    QDomDocument doc = loadSceneDocument(proxy, pageIndex);
-    QDomElement elSvg = doc.documentElement(); // SVG tag
-    QString ubVersion = elSvg.attributeNS(UBSettings::uniboardDocumentNamespaceUri, "version", "4.1"); // default to 4.1
+    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
+    QString ubVersion = pageHeader(fileName).version;
+
+    if (ubVersion.isEmpty())
+        ubVersion = "4.1"; // default to 4.1
 
     if (ubVersion.startsWith("4.1") || ubVersion.startsWith("4.2") || ubVersion.startsWith("4.3"))
     {
@@ -162,80 +383,84 @@ void UBSvgSubsetAdaptor::upgradeScene(std::shared_ptr<UBDocumentProxy> proxy, co
 }
 
 
-QDomDocument UBSvgSubsetAdaptor::loadSceneDocument(std::shared_ptr<UBDocumentProxy> proxy, const int pPageIndex)
-{
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",pPageIndex);
-
-    QFile file(fileName);
-    QDomDocument doc("page");
-
-    if (file.exists())
-    {
-        if (!file.open(QIODevice::ReadOnly))
-        {
-            qWarning() << "Cannot open file " << fileName << " for reading ...";
-            return doc;
-        }
-
-        doc.setContent(&file, true);
-        file.close();
-    }
-
-    return doc;
-}
-
-
 void UBSvgSubsetAdaptor::setSceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex, QUuid pUuid)
 {
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",pageIndex);
 
-    QFile file(fileName);
+    if (!QFile::exists(fileName))
+        return;
 
-    if (!file.exists() || !file.open(QIODevice::ReadOnly))
+    if (replaceSceneUuid(fileName, pUuid))
         return;
 
-    QTextStream textReadStream(&file);
-    QString xmlContent = textReadStream.readAll();
+    QString xmlContent = QString::fromUtf8(readPageFile(fileName));
     int uuidIndex = xmlContent.indexOf("uuid");
     if (-1 == uuidIndex)
     {
         qWarning() << "Cannot read UUID from file" << fileName << "to set new UUID";
-        file.close();
         return;
     }
     int quoteStartIndex = xmlContent.indexOf('"', uuidIndex);
     if (-1 == quoteStartIndex)
     {
         qWarning() << "Cannot read UUID from file" << fileName << "to set new UUID";
-        file.close();
         return;
     }
     int quoteEndIndex = xmlContent.indexOf('"', quoteStartIndex + 1);
     if (-1 == quoteEndIndex)
     {
         qWarning() << "Cannot read UUID from file" << fileName << "to set new UUID";
-        file.close();
         return;
     }
 
-    file.close();
-
     QString newXmlContent = xmlContent.left(quoteStartIndex + 1);
     newXmlContent.append(UBStringUtils::toCanonicalUuid(pUuid));
     newXmlContent.append(xmlContent.right(xmlContent.length() - quoteEndIndex));
 
-    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
-    {
-        QTextStream textWriteStream(&file);
-        textWriteStream << newXmlContent;
-        file.close();
-    }
-    else
+    UBPageFileWriter writer(fileName, UBSettings::settings()->snapshot().compressPages);
+
+    if (!writer.open() || writer.device()->write(newXmlContent.toUtf8()) < 0 || !writer.commit())
     {
         qWarning() << "Cannot open file" << fileName  << "to write UUID";
     }
 }
 
+/**
+ * @brief Overwrite the uuid attribute of the root element in place
+ *
+ * Only the bytes of the uuid are written. Returns false if this is not possible, e.g. for a
+ * compressed page, and the page then has to be written again.
+ */
+bool UBSvgSubsetAdaptor::replaceSceneUuid(const QString& fileName, const QUuid& uuid)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+
+    const QByteArray head = file.read(sPageHeaderChunkSize);
+    const QByteArray value = UBStringUtils::toCanonicalUuid(uuid).toUtf8();
+
+    const int rootIndex = head.indexOf("<svg");
+    const int rootEndIndex = head.indexOf('>', rootIndex);
+    const int uuidIndex = head.indexOf("uuid=\"", rootIndex);
+
+    if (rootIndex < 0 || rootEndIndex < 0 || uuidIndex < 0 || uuidIndex > rootEndIndex)
+        return false;
+
+    const int valueIndex = uuidIndex + 6;
+    const int quoteEndIndex = head.indexOf('"', valueIndex);
+
+    if (quoteEndIndex < 0 || quoteEndIndex - valueIndex != value.size())
+        return false;
+
+    const bool replaced = file.seek(valueIndex) && file.write(value) == value.size();
+    file.close();
+    forgetPageHeader(fileName);
+
+    return replaced;
+}
+
 QString UBSvgSubsetAdaptor::uniboardDocumentNamespaceUriFromVersion(int mFileVersion)
 {
     return mFileVersion >= 40200 ? UBSettings::uniboardDocumentNamespaceUri : sFormerUniboardDocumentNamespaceUri;
@@ -247,21 +472,17 @@ std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::loadScene(std::shared_ptr<U
     UBApplication::showMessage(QObject::tr("Loading scene (%1/%2)").arg(pageIndex+1).arg(proxy->pageCount()));
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
     qInfo() << "loading scene. Filename is : " << fileName;
-    QFile file(fileName);
 
-    if (file.exists())
+    if (QFile::exists(fileName))
     {
-        if (!file.open(QIODevice::ReadOnly))
+        const QByteArray content = readPageFile(fileName);
+
+        if (content.isEmpty())
         {
-            qWarning() << "Cannot open file " << fileName << " for reading ...";
             return 0;
         }
 
-        std::shared_ptr<UBGraphicsScene> scene = loadScene(proxy, file.readAll());
-
-        file.close();
-
-        return scene;
+        return loadScene(proxy, content);
     }
 
     return 0;
@@ -272,69 +493,186 @@ QByteArray UBSvgSubsetAdaptor::loadSceneAsText(std::shared_ptr<UBDocumentProxy>
 {
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
     qDebug() << fileName;
-    QFile file(fileName);
 
-    if (file.exists())
+    if (QFile::exists(fileName))
+    {
+        return readPageFile(fileName);
+    }
+    return "";
+}
+
+
+QUuid UBSvgSubsetAdaptor::sceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
+{
+    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
+
+    return pageHeader(fileName).uuid;
+}
+
+
+/**
+ * @brief Return the attributes of the root element of a page file
+ *
+ * Only the beginning of the file is parsed. Headers are cached and the cache entry is
+ * checked against the size and modification time of the file, so that metadata probes
+ * over a whole document cost a file status per page.
+ */
+UBSvgSubsetAdaptor::PageHeader UBSvgSubsetAdaptor::pageHeader(const QString& fileName)
+{
+    QFileInfo info(fileName);
+
+    if (!info.exists())
+    {
+        return PageHeader();
+    }
+
+    const qint64 size = info.size();
+    const QDateTime modified = info.lastModified();
+
     {
-        if (!file.open(QIODevice::ReadOnly))
+        QMutexLocker lock(&sPageHeaderMutex);
+        auto it = sPageHeaders.constFind(fileName);
+
+        if (it != sPageHeaders.constEnd() && it->size == size && it->modified == modified)
         {
-            qWarning() << "Cannot open file " << fileName << " for reading ...";
-            return "";
+            return it->header;
         }
+    }
 
-        return file.readAll();
+    PageHeader header = readPageHeader(fileName);
 
-        file.close();
+    QMutexLocker lock(&sPageHeaderMutex);
 
+    if (sPageHeaders.size() >= sMaxCachedPageHeaders)
+    {
+        sPageHeaders.clear();
     }
-    return "";
+
+    sPageHeaders.insert(fileName, {size, modified, header});
+
+    return header;
 }
 
 
-QUuid UBSvgSubsetAdaptor::sceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
+UBSvgSubsetAdaptor::PageHeader UBSvgSubsetAdaptor::readPageHeader(const QString& fileName)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
+    PageHeader header;
 
     QFile file(fileName);
 
-    QUuid uuid;
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Cannot open file " << fileName << " for reading ...";
+        return header;
+    }
 
-    if (file.exists())
+    QuaGzipFile gzipFile(fileName);
+    QIODevice* device = &file;
+
+    if (file.peek(2).startsWith("\x1f\x8b"))
     {
-        if (!file.open(QIODevice::ReadOnly))
+        file.close();
+
+        if (!gzipFile.open(QIODevice::ReadOnly))
         {
-            qWarning() << "Cannot open file " << fileName << " for reading ...";
-            return QUuid();
+            qWarning() << "Cannot uncompress file " << fileName;
+            return header;
         }
 
-        QXmlStreamReader xml(file.readAll());
+        device = &gzipFile;
+    }
+
+    QXmlStreamReader xml;
+    qint64 bytesRead = 0;
 
-        bool foundSvg = false;
+    while (bytesRead < sMaxPageHeaderSize)
+    {
+        const QByteArray chunk = device->read(sPageHeaderChunkSize);
 
-        while (!xml.atEnd() && !foundSvg)
+        if (chunk.isEmpty())
+        {
+            break;
+        }
+
+        bytesRead += chunk.size();
+        xml.addData(chunk);
+
+        while (!xml.atEnd())
         {
             xml.readNext();
 
             if (xml.isStartElement())
             {
-                if (xml.name().toString() == "svg")
+                // the root element
+                if (xml.name().toString() != "svg")
                 {
-                    auto svgSceneUuid = xml.attributes().value(UBSettings::uniboardDocumentNamespaceUri, "uuid");
-                    if (svgSceneUuid.isNull())
-                        svgSceneUuid = xml.attributes().value("http://www.mnemis.com/uniboard", "uuid");
+                    return header;
+                }
 
-                    if (!svgSceneUuid.isNull())
-                        uuid = QUuid(svgSceneUuid.toString());
+                const QXmlStreamAttributes attributes = xml.attributes();
 
-                    foundSvg = true;
+                auto uuid = attributes.value(UBSettings::uniboardDocumentNamespaceUri, "uuid");
+                if (uuid.isNull())
+                    uuid = attributes.value(sFormerUniboardDocumentNamespaceUri, "uuid");
+
+                header.valid = true;
+                header.uuid = QUuid(uuid.toString());
+                header.version = attributes.value(UBSettings::uniboardDocumentNamespaceUri, "version").toString();
+
+                const QStringList size = attributes.value(UBSettings::uniboardDocumentNamespaceUri, "nominal-size").toString().split("x");
+
+                if (size.size() == 2)
+                {
+                    header.nominalSize = QSize(size.at(0).toInt(), size.at(1).toInt());
                 }
+
+                return header;
             }
         }
 
-        file.close();
+        if (xml.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+        {
+            break;
+        }
     }
 
-    return uuid;
+    qWarning() << "Cannot read page header of " << fileName;
+    return header;
+}
+
+
+/**
+ * @brief Read a page file, uncompressing it if it was saved compressed
+ *
+ * Returns an empty array if the file cannot be read.
+ */
+QByteArray UBSvgSubsetAdaptor::readPageFile(const QString& fileName)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Cannot open file " << fileName << " for reading ...";
+        return QByteArray();
+    }
+
+    // gzip magic number
+    if (!file.peek(2).startsWith("\x1f\x8b"))
+    {
+        return file.readAll();
+    }
+
+    file.close();
+
+    QuaGzipFile gzipFile(fileName);
+
+    if (!gzipFile.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Cannot uncompress file " << fileName;
+        return QByteArray();
+    }
+
+    return gzipFile.readAll();
 }
 
 
@@ -356,6 +694,7 @@ UBSvgSubsetAdaptor::UBSvgSubsetReader::UBSvgSubsetReader(std::shared_ptr<UBDocum
     , mProxy(pProxy)
     , mDocumentPath(pProxy->persistencePath())
     , mGroupHasInfo(false)
+    , mXmlData(pXmlData)
 {
     // NOOP
 }
@@ -390,6 +729,15 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::start()
 
 bool UBSvgSubsetAdaptor::UBSvgSubsetReader::isFinished()
 {
+    if (mIndexed)
+    {
+        // elements may have been read out of order by loadRegion()
+        while (mNextElement < mElements.size() && mElements[mNextElement].loaded)
+            ++mNextElement;
+
+        return mNextElement >= mElements.size() && mGroups.loaded;
+    }
+
     return mXmlReader.atEnd();
 }
 
@@ -603,7 +951,10 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::processElement()
             QString uuid_stripped = strokesGroup->uuid().toString().replace("}","").replace("{","");
 
             if (!mStrokesList.contains(uuid_stripped))
+            {
                 mStrokesList.insert(uuid_stripped, strokesGroup);
+                mNewStrokesGroupIds << uuid_stripped;
+            }
         }
         else if (name == "polygon" || name == "line")
         {
@@ -626,15 +977,14 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::processElement()
             {
                 polygonItem->setData(UBGraphicsItemData::ItemLayerType, QVariant(UBItemLayerType::Graphic));
 
-                UBGraphicsStrokesGroup* group;
-                if(!mStrokesList.contains(parentId)){
+                UBGraphicsStrokesGroup* group = strokesGroupForId(parentId);
+                if(!group){
                     group = new UBGraphicsStrokesGroup();
                     mStrokesList.insert(parentId,group);
+                    mNewStrokesGroupIds << parentId;
                     group->setTransform(polygonItem->transform());
                     UBGraphicsItem::assignZValue(group, polygonItem->zValue());
                 }
-                else
-                    group = mStrokesList.value(parentId);
 
                 if (!currentStroke)
                     currentStroke = new UBGraphicsStroke();
@@ -666,16 +1016,15 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::processElement()
             {
                 polygonItem->setData(UBGraphicsItemData::ItemLayerType, QVariant(UBItemLayerType::Graphic));
 
-                UBGraphicsStrokesGroup* group;
+                UBGraphicsStrokesGroup* group = strokesGroupForId(parentId);
 
-                if(!mStrokesList.contains(parentId)){
+                if(!group){
                     group = new UBGraphicsStrokesGroup();
                     mStrokesList.insert(parentId,group);
+                    mNewStrokesGroupIds << parentId;
                     group->setTransform(polygonItem->transform());
                     UBGraphicsItem::assignZValue(group, polygonItem->zValue());
                 }
-                else
-                    group = mStrokesList.value(parentId);
 
                 if (!currentStroke)
                     currentStroke = new UBGraphicsStroke();
@@ -847,7 +1196,9 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::processElement()
             {
                 mScene->addItem(cache);
                 mScene->registerTool(cache);
-                UBApplication::boardController->notifyCache(true);
+
+                if (UBApplication::boardController)
+                    UBApplication::boardController->notifyCache(true);
             }
         }
         else if (name == "foreignObject")
@@ -1023,14 +1374,27 @@ std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::UBSvgSubsetReader::scene()
 
         qDebug() << "Number of detected strokes: " << mStrokesList.count();
 
+        if (mStrokePointsKept < mStrokePointsRead)
+        {
+            qDebug() << "Stroke points simplified on load from" << mStrokePointsRead << "to" << mStrokePointsKept;
+            UBTrace::counter("stroke points dropped on load", mStrokePointsRead - mStrokePointsKept);
+        }
+
         if (mScene) {
-            QHashIterator<QString, UBGraphicsStrokesGroup*> iterator(mStrokesList);
-            while (iterator.hasNext()) {
-                iterator.next();
-                mScene->addItem(iterator.value());
+            // when loading progressively, the groups were added along with their strokes
+            // and the user may have deleted some of them since
+            if (!mIndexed) {
+                QHashIterator<QString, UBGraphicsStrokesGroup*> iterator(mStrokesList);
+                while (iterator.hasNext()) {
+                    iterator.next();
+
+                    if (!iterator.value()->scene())
+                        mScene->addItem(iterator.value());
+                }
             }
 
-            mScene->setModified(saveSceneAfterLoading);
+            // the page may already have been edited while it was loaded progressively
+            mScene->setModified(saveSceneAfterLoading || (mIndexed && mScene->isModified()));
             mScene->enableUndoRedoStack();
             qDebug() << "loadScene() : created scene and read file";
         }
@@ -1042,6 +1406,278 @@ std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::UBSvgSubsetReader::scene()
 }
 
 
+/**
+ * @brief Index the top-level elements of the page and their bounds, then read the root element
+ *
+ * Once indexed, the elements are no longer read in document order: loadRegion() reads the
+ * elements intersecting a rect, and loadNextElement() the following ones in document order,
+ * so that the visible part of a huge page can be shown before the rest is read. The groups
+ * section refers to the other items and is always read last.
+ *
+ * Returns false if the page could not be indexed, in which case it is read sequentially.
+ */
+bool UBSvgSubsetAdaptor::UBSvgSubsetReader::indexElements()
+{
+    UBTraceScope trace("UBSvgSubsetReader::indexElements");
+
+    mText = QString::fromUtf8(mXmlData);
+
+    QXmlStreamReader reader(mText);
+    QVector<IndexedElement> elements;
+    IndexedElement groups;
+    IndexedElement element;
+    QTransform elementTransform;
+    bool isGroups = false;
+    int depth = 0;
+
+    while (!reader.atEnd())
+    {
+        // an element starts where the previous token ended
+        qint64 tokenStart = reader.characterOffset();
+        reader.readNext();
+
+        if (reader.isStartElement())
+        {
+            ++depth;
+
+            if (depth == 1)
+            {
+                mHeader = mText.left(int(reader.characterOffset()));
+            }
+            else if (depth == 2)
+            {
+                element = IndexedElement();
+                element.begin = tokenStart;
+                element.bounds = elementBounds(reader, QTransform());
+                element.loaded = false;
+
+                auto svgTransform = reader.attributes().value("transform");
+                elementTransform = svgTransform.isNull() ? QTransform() : fromSvgTransform(svgTransform.toString());
+                isGroups = reader.name().toString() == tGroups;
+            }
+            else if (depth == 3 && !isGroups)
+            {
+                // the polygons of a stroke group
+                element.bounds |= elementBounds(reader, elementTransform);
+            }
+        }
+        else if (reader.isEndElement())
+        {
+            if (depth == 2)
+            {
+                element.end = reader.characterOffset();
+
+                if (isGroups)
+                    groups = element;
+                else
+                    elements << element;
+            }
+
+            --depth;
+        }
+    }
+
+    if (reader.hasError() || mHeader.isEmpty())
+    {
+        qWarning() << "cannot index page, reading it sequentially:" << reader.errorString();
+        mText.clear();
+        mHeader.clear();
+        return false;
+    }
+
+    mElements = elements;
+    mGroups = groups;
+    mNextElement = 0;
+    mIndexed = true;
+
+    UBTrace::counter("page elements indexed", mElements.size());
+
+    // the root element creates the scene
+    loadXml(mHeader + "</svg>", false);
+
+    if (!mScene)
+    {
+        qWarning() << "cannot read the root element of the indexed page, reading it sequentially";
+        mIndexed = false;
+        mXmlReader.clear();
+        mXmlReader.addData(mXmlData);
+        return false;
+    }
+
+    mMustFinalize = isFinished();
+
+    return true;
+}
+
+/**
+ * @brief Read the indexed elements intersecting the given rect, and those whose bounds are unknown
+ */
+void UBSvgSubsetAdaptor::UBSvgSubsetReader::loadRegion(const QRectF& sceneRect)
+{
+    UBTraceScope trace("UBSvgSubsetReader::loadRegion");
+
+    int count = 0;
+
+    for (IndexedElement& element : mElements)
+    {
+        if (!element.loaded && (element.bounds.isNull() || element.bounds.intersects(sceneRect)))
+        {
+            loadElement(element);
+            ++count;
+        }
+    }
+
+    qDebug() << "loaded" << count << "of" << mElements.size() << "elements intersecting" << sceneRect;
+    UBTrace::counter("page elements loaded first", count);
+}
+
+/**
+ * @brief Read the next indexed element which was not read yet, or the groups once all are read
+ */
+void UBSvgSubsetAdaptor::UBSvgSubsetReader::loadNextElement()
+{
+    if (isFinished())
+        return;
+
+    if (mNextElement < mElements.size())
+        loadElement(mElements[mNextElement++]);
+    else
+        loadElement(mGroups);
+}
+
+void UBSvgSubsetAdaptor::UBSvgSubsetReader::loadElement(IndexedElement& element)
+{
+    element.loaded = true;
+
+    // loading does not modify the page, but the user may already have
+    bool modified = mScene->isModified();
+
+    // nor is it undoable, even though the partial page is already editable
+    const bool undoEnabled = mScene->isURStackIsEnabled();
+    mScene->setURStackEnable(false);
+
+    loadXml(mHeader + mText.mid(int(element.begin), int(element.end - element.begin)) + "</svg>", true);
+
+    // stroke groups are shown as soon as they have strokes, from then on the user may delete
+    // them, so they are only referred to by uuid
+    foreach (const QString& id, mNewStrokesGroupIds)
+    {
+        UBGraphicsStrokesGroup* group = mStrokesList.value(id);
+
+        if (group)
+        {
+            if (!group->scene())
+                mScene->addItem(group);
+
+            mShownStrokesGroups.insert(id, group->uuid());
+            mStrokesList.insert(id, nullptr);
+        }
+    }
+
+    mNewStrokesGroupIds.clear();
+    mScene->setModified(modified);
+    mScene->setURStackEnable(undoEnabled);
+
+    mMustFinalize = isFinished();
+}
+
+/**
+ * @brief Return the strokes group read with the given id, or nullptr if there is none
+ *
+ * A group already shown by a previous loadElement() is looked up in the scene, it is not
+ * found if the user deleted it.
+ */
+UBGraphicsStrokesGroup* UBSvgSubsetAdaptor::UBSvgSubsetReader::strokesGroupForId(const QString& id)
+{
+    UBGraphicsStrokesGroup* group = mStrokesList.value(id);
+
+    if (!group && mShownStrokesGroups.contains(id))
+    {
+        group = qgraphicsitem_cast<UBGraphicsStrokesGroup*>(mScene->itemForUuid(mShownStrokesGroups.take(id)));
+
+        if (group)
+        {
+            mStrokesList.insert(id, group);
+            mNewStrokesGroupIds << id;
+        }
+    }
+
+    return group;
+}
+
+/**
+ * @brief Process a document made of the page header, some of its elements and the closing tag
+ * @param skipRoot true if the root element was already processed
+ */
+void UBSvgSubsetAdaptor::UBSvgSubsetReader::loadXml(const QString& xml, bool skipRoot)
+{
+    mXmlReader.clear();
+    mXmlReader.addData(xml);
+
+    if (skipRoot)
+    {
+        do
+        {
+            mXmlReader.readNext();
+        }
+        while (!mXmlReader.atEnd() && !mXmlReader.isStartElement());
+    }
+
+    while (!mXmlReader.atEnd())
+    {
+        processElement();
+    }
+
+    // the end of this document is not the end of the page
+    mMustFinalize = false;
+}
+
+/**
+ * @brief Estimate the scene bounds of an element from its attributes, or a null rect if unknown
+ */
+QRectF UBSvgSubsetAdaptor::UBSvgSubsetReader::elementBounds(const QXmlStreamReader& reader, const QTransform& parentTransform)
+{
+    const QXmlStreamAttributes attributes = reader.attributes();
+    const QString name = reader.name().toString();
+    QRectF bounds;
+
+    if (name == "polygon" || name == "polyline")
+    {
+        QPolygonF polygon;
+        const QStringList ts = attributes.value("points").toString().split(QLatin1Char(' '), UB::SplitBehavior::SkipEmptyParts);
+
+        foreach (const QString& sPoint, ts)
+        {
+            QStringList sCoord = sPoint.split(QLatin1Char(','), UB::SplitBehavior::SkipEmptyParts);
+
+            if (sCoord.size() == 2)
+                polygon << QPointF(sCoord.at(0).toFloat(), sCoord.at(1).toFloat());
+        }
+
+        bounds = polygon.boundingRect();
+    }
+    else if (name == "line")
+    {
+        bounds = QRectF(QPointF(attributes.value("x1").toString().toFloat(), attributes.value("y1").toString().toFloat()),
+                        QPointF(attributes.value("x2").toString().toFloat(), attributes.value("y2").toString().toFloat())).normalized();
+    }
+    else if (attributes.hasAttribute("width") && attributes.hasAttribute("height"))
+    {
+        bounds = QRectF(attributes.value("x").toString().toFloat(), attributes.value("y").toString().toFloat(),
+                        attributes.value("width").toString().toFloat(), attributes.value("height").toString().toFloat());
+    }
+
+    if (bounds.isNull())
+        return QRectF();
+
+    auto svgTransform = attributes.value("transform");
+    QTransform transform = svgTransform.isNull() ? parentTransform : fromSvgTransform(svgTransform.toString());
+
+    // keep thin strokes from having empty bounds
+    return transform.mapRect(bounds).adjusted(-1, -1, 1, 1);
+}
+
+
 UBGraphicsGroupContainerItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::readGroup()
 {
     UBGraphicsGroupContainerItem *group = new UBGraphicsGroupContainerItem();
@@ -1254,16 +1890,28 @@ bool UBSvgSubsetAdaptor::UBSvgSubsetWriter::persistScene(std::shared_ptr<UBDocum
 {
     Q_UNUSED(pageIndex);
 
+    UBTraceScope trace("UBSvgSubsetWriter::persistScene");
+    QElapsedTimer time;
+    time.start();
+
     //Creating dom structure to store information
     QDomDocument groupDomDocument;
     QDomElement groupRoot = groupDomDocument.createElement(tGroups);
     groupDomDocument.appendChild(groupRoot);
 
-    QBuffer buffer;
-    buffer.open(QBuffer::WriteOnly);
-    mXmlWriter.setDevice(&buffer);
+    // the page is streamed to the file, it replaces the former page once completely written
+    QString fileName = mDocumentPath + UBFileSystemUtils::digitFileFormat("/page%1.svg", mPageIndex);
+    UBPageFileWriter writer(fileName, UBSettings::settings()->snapshot().compressPages);
+
+    if (!writer.open())
+    {
+        return false;
+    }
+
+    mXmlWriter.setDevice(writer.device());
 
-    mXmlWriter.setAutoFormatting(true);
+    // no indentation, it only adds size to stroke-heavy pages
+    mXmlWriter.setAutoFormatting(false);
 
     mXmlWriter.writeStartDocument();
     mXmlWriter.writeDefaultNamespace(nsSvg);
@@ -1552,17 +2200,15 @@ bool UBSvgSubsetAdaptor::UBSvgSubsetWriter::persistScene(std::shared_ptr<UBDocum
     }
 
     mXmlWriter.writeEndDocument();
-    QString fileName = mDocumentPath + UBFileSystemUtils::digitFileFormat("/page%1.svg", mPageIndex);
-    QFile file(fileName);
 
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    if (mXmlWriter.hasError() || !writer.commit())
     {
-        qCritical() << "cannot open " << fileName << " for writing. Error : " << file.errorString();
+        qCritical() << "cannot save page " << fileName;
         return false;
     }
-    file.write(buffer.data());
-    file.flush();
-    file.close();
+
+    qDebug() << "saved" << fileName << ":" << QFileInfo(fileName).size() << "bytes in" << time.elapsed() << "ms";
+    UBTrace::counter("page bytes written", QFileInfo(fileName).size());
 
     return true;
 }
@@ -1821,7 +2467,7 @@ UBGraphicsPolygonItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemFromPol
         qWarning() << "cannot make sense of 'points' value " << svgPoints.toString();
     }
 
-    polygonItem->setPolygon(polygon);
+    polygonItem->setPolygon(simplifiedStrokePoints(polygon));
 
     auto svgFill = mXmlReader.attributes().value("fill");
 
@@ -2013,6 +2659,32 @@ UBGraphicsPolygonItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemFromLin
     return polygonItem;
 }
 
+/**
+ * @brief Drop the points of a stroke read from the page that do not change its shape noticeably
+ *
+ * Pages saved by former versions kept every point of the strokes; they are simplified with the
+ * same tolerance setting as strokes drawn now, unless disabled in the settings. The zoom at which
+ * a stroke was drawn is not known, so the tolerance is taken in scene units here, i.e. in screen
+ * pixels at 100% zoom, while strokes being drawn use screen pixels at the current zoom.
+ */
+QPolygonF UBSvgSubsetAdaptor::UBSvgSubsetReader::simplifiedStrokePoints(const QPolygonF& points)
+{
+    mStrokePointsRead += points.size();
+
+    const UBSettingsSnapshot& settings = UBSettings::settings()->snapshot();
+
+    if (!settings.simplifyStrokesOnLoad || points.size() < 3)
+    {
+        mStrokePointsKept += points.size();
+        return points;
+    }
+
+    QPolygonF simplified = UBGeometryUtils::simplifyPolygon(points, settings.simplifyStrokesTolerance);
+    mStrokePointsKept += simplified.size();
+
+    return simplified;
+}
+
 QList<UBGraphicsPolygonItem*> UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemsFromPolylineSvg(const QColor& pDefaultColor)
 {
     auto strokeWidth = mXmlReader.attributes().value("stroke-width");
@@ -2097,7 +2769,7 @@ QList<UBGraphicsPolygonItem*> UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItem
         QStringList ts = svgPoints.toString().split(QLatin1Char(' '),
                                                     UB::SplitBehavior::SkipEmptyParts);
 
-        QList<QPointF> points;
+        QPolygonF points;
 
         foreach(const QString sPoint, ts)
         {
@@ -2125,6 +2797,8 @@ QList<UBGraphicsPolygonItem*> UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItem
             }
         }
 
+        points = simplifiedStrokePoints(points);
+
         for (int i = 0; i < points.size() - 1; i++)
         {
             UBGraphicsPolygonItem* polygonItem = new UBGraphicsPolygonItem(QLineF(points.at(i), points.at(i + 1)), lineWidth);
@@ -3511,6 +4185,9 @@ UBSvgSubsetAdaptor::UBSvgReaderContext::UBSvgReaderContext(std::shared_ptr<UBDoc
 {
     reader = new UBSvgSubsetReader(proxy, pXmlData);
     reader->start();
+
+    if (pXmlData.size() >= sProgressiveLoadingMinSize)
+        reader->indexElements();
 }
 
 UBSvgSubsetAdaptor::UBSvgReaderContext::~UBSvgReaderContext()
@@ -3525,10 +4202,32 @@ bool UBSvgSubsetAdaptor::UBSvgReaderContext::isFinished() const
 
 void UBSvgSubsetAdaptor::UBSvgReaderContext::step()
 {
-    reader->processElement();
+    if (reader->isIndexed())
+        reader->loadNextElement();
+    else
+        reader->processElement();
 }
 
 std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::UBSvgReaderContext::scene() const
 {
     return reader->scene();
 }
+
+bool UBSvgSubsetAdaptor::UBSvgReaderContext::isProgressive() const
+{
+    return reader->isIndexed();
+}
+
+void UBSvgSubsetAdaptor::UBSvgReaderContext::loadRegion(const QRectF& sceneRect)
+{
+    if (reader->isIndexed())
+        reader->loadRegion(sceneRect);
+}
+
+/**
+ * @brief The scene being loaded, which only has the elements read so far
+ */
+std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::UBSvgReaderContext::partialScene() const
+{
+    return reader->partialScene();
+}
@@ -79,6 +79,10 @@ class UBSvgSubsetAdaptor
             void step();
             std::shared_ptr<UBGraphicsScene> scene() const;
 
+            bool isProgressive() const;
+            void loadRegion(const QRectF& sceneRect);
+            std::shared_ptr<UBGraphicsScene> partialScene() const;
+
         private:
             UBSvgSubsetReader* reader = nullptr;
         };
@@ -94,6 +98,19 @@ class UBSvgSubsetAdaptor
         static QUuid sceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
         static void setSceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex, QUuid pUuid);
 
+        /** Attributes of the root element of a page */
+        struct PageHeader
+        {
+            bool valid{false};
+            QUuid uuid{};
+            QString version{};
+            QSize nominalSize{};
+        };
+
+        static PageHeader pageHeader(const QString& fileName);
+        static void forgetPageHeader(const QString& fileName);
+        static QByteArray readPageFile(const QString& fileName);
+
         static void convertPDFObjectsToImages(std::shared_ptr<UBDocumentProxy> proxy);
         static void convertSvgImagesToImages(std::shared_ptr<UBDocumentProxy> proxy);
 
@@ -111,7 +128,8 @@ class UBSvgSubsetAdaptor
 
     private:
 
-        static QDomDocument loadSceneDocument(std::shared_ptr<UBDocumentProxy> proxy, const int pPageIndex);
+        static PageHeader readPageHeader(const QString& fileName);
+        static bool replaceSceneUuid(const QString& fileName, const QUuid& uuid);
 
         static QString uniboardDocumentNamespaceUriFromVersion(int fileVersion);
 
@@ -136,8 +154,28 @@ class UBSvgSubsetAdaptor
                 void processElement();
                 std::shared_ptr<UBGraphicsScene> scene();
 
+                bool indexElements();
+                bool isIndexed() const { return mIndexed; }
+                void loadRegion(const QRectF& sceneRect);
+                void loadNextElement();
+                std::shared_ptr<UBGraphicsScene> partialScene() const { return mScene; }
+
             private:
 
+                /** A top-level element of the page, located by its character offsets in the page */
+                struct IndexedElement
+                {
+                    qint64 begin{0};
+                    qint64 end{0};
+                    QRectF bounds;
+                    bool loaded{true};
+                };
+
+                static QRectF elementBounds(const QXmlStreamReader& reader, const QTransform& parentTransform);
+                void loadElement(IndexedElement& element);
+                void loadXml(const QString& xml, bool skipRoot);
+                UBGraphicsStrokesGroup* strokesGroupForId(const QString& id);
+
                 UBGraphicsPolygonItem* polygonItemFromLineSvg(const QColor& pDefaultBrushColor);
 
                 UBGraphicsPolygonItem* polygonItemFromPolygonSvg(const QColor& pDefaultBrushColor);
@@ -182,6 +220,8 @@ class UBSvgSubsetAdaptor
 
                 qreal normalizedZValue(bool* hasValue);
 
+                QPolygonF simplifiedStrokePoints(const QPolygonF& points);
+
                 QXmlStreamReader mXmlReader;
                 int mFileVersion;
                 std::shared_ptr<UBDocumentProxy> mProxy;
@@ -203,6 +243,19 @@ class UBSvgSubsetAdaptor
                 UBGraphicsStroke* currentStroke = nullptr;
                 UBGraphicsWidgetItem *currentWidget = nullptr;
                 bool mMustFinalize = false;
+
+                int mStrokePointsRead = 0;
+                int mStrokePointsKept = 0;
+
+                QByteArray mXmlData;
+                bool mIndexed = false;
+                QString mText;
+                QString mHeader;
+                QVector<IndexedElement> mElements;
+                IndexedElement mGroups;
+                int mNextElement = 0;
+                QStringList mNewStrokesGroupIds;
+                QHash<QString, QUuid> mShownStrokesGroups;
         };
 
         class UBSvgSubsetWriter
@@ -32,6 +32,7 @@
 #include <QtCore>
 
 #include "frameworks/UBFileSystemUtils.h"
+#include "frameworks/UBTrace.h"
 
 #include "core/UBPersistenceManager.h"
 #include "core/UBApplication.h"
@@ -39,12 +40,14 @@
 
 #include "board/UBBoardController.h"
 #include "board/UBBoardPaletteManager.h"
+#include "board/UBBoardView.h"
 
 #include "document/UBDocumentProxy.h"
 
 #include "domain/UBGraphicsScene.h"
 
 #include "UBSvgSubsetAdaptor.h"
+#include "UBThumbnailWriter.h"
 
 #include "core/memcheck.h"
 
@@ -58,7 +61,7 @@ void UBThumbnailAdaptor::generateMissingThumbnails(std::shared_ptr<UBDocumentPro
 
         QFile thumbFile(thumbFileName);
 
-        if (!thumbFile.exists())
+        if (!thumbFile.exists() && UBThumbnailWriter::writer()->pendingImage(thumbFileName).isNull())
         {
             bool displayMessage = (existingPageCount > 5);
 
@@ -99,6 +102,13 @@ QPixmap UBThumbnailAdaptor::generateMissingThumbnail(std::shared_ptr<UBDocumentP
         }
     }
 
+    QImage pending = UBThumbnailWriter::writer()->pendingImage(thumbFileName);
+
+    if (!pending.isNull())
+    {
+        return QPixmap::fromImage(pending);
+    }
+
     QPixmap pix;
     pix.load(thumbFileName);
     return pix;
@@ -108,6 +118,14 @@ QPixmap UBThumbnailAdaptor::get(std::shared_ptr<UBDocumentProxy> proxy, int page
 {
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
 
+    // the thumbnail may not be written yet
+    QImage pending = UBThumbnailWriter::writer()->pendingImage(fileName);
+
+    if (!pending.isNull())
+    {
+        return QPixmap::fromImage(pending);
+    }
+
     QFile file(fileName);
     if (!file.exists())
     {
@@ -137,9 +155,12 @@ void UBThumbnailAdaptor::persistScene(std::shared_ptr<UBDocumentProxy> proxy, st
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
 
     QFile thumbFile(fileName);
+    bool exists = thumbFile.exists() || !UBThumbnailWriter::writer()->pendingImage(fileName).isNull();
 
-    if (pScene->isModified() || overrideModified || !thumbFile.exists())
+    if (pScene->isModified() || overrideModified || !exists)
     {
+        UBTraceScope trace("UBThumbnailAdaptor::persistScene");
+
         qreal nominalWidth = pScene->nominalSize().width();
         qreal nominalHeight = pScene->nominalSize().height();
         qreal ratio = nominalWidth / nominalHeight;
@@ -148,33 +169,101 @@ void UBThumbnailAdaptor::persistScene(std::shared_ptr<UBDocumentProxy> proxy, st
         qreal width = UBSettings::maxThumbnailWidth;
         qreal height = width / ratio;
 
-        QImage thumb(width, height, QImage::Format_ARGB32);
-
         QRectF imageRect(0, 0, width, height);
+        bool darkBackground = pScene->isDarkBackground();
 
-        QPainter painter(&thumb);
-        painter.setRenderHint(QPainter::Antialiasing, true);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+        // patch the cached thumbnail when only its damaged area has to be rendered again
+        UBGraphicsScene::ThumbnailCache& cache = pScene->thumbnailCache();
+        bool incremental = !cache.image.isNull()
+                && cache.sceneRect == sceneRect
+                && cache.darkBackground == darkBackground
+                && cache.image.size() == QSize(width, height);
 
-        if (pScene->isDarkBackground())
+        QImage thumb;
+        QRectF targetRect = imageRect;
+        QRectF sourceRect = sceneRect;
+
+        if (incremental)
         {
-            painter.fillRect(imageRect, Qt::black);
+            thumb = cache.image;
+
+            QTransform toImage = QTransform::fromTranslate(-sceneRect.x(), -sceneRect.y())
+                    * QTransform::fromScale(width / sceneRect.width(), height / sceneRect.height());
+
+            if (cache.damage.isEmpty())
+            {
+                targetRect = QRectF();
+            }
+            else
+            {
+                // cover the damage with whole pixels to avoid seams of the antialiasing
+                targetRect = toImage.mapRect(cache.damage);
+                targetRect += QMarginsF(1, 1, 1, 1);
+                targetRect = targetRect.toRect();
+                targetRect &= imageRect;
+                sourceRect = toImage.inverted().mapRect(targetRect);
+            }
         }
         else
         {
-            painter.fillRect(imageRect, Qt::white);
+            thumb = QImage(width, height, QImage::Format_ARGB32);
+        }
+
+        if (targetRect.isValid())
+        {
+            UBTrace::counter("thumbnail pixels rendered", qRound(targetRect.width() * targetRect.height()));
+
+            QPainter painter(&thumb);
+            painter.setRenderHint(QPainter::Antialiasing, true);
+            painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+            if (darkBackground)
+            {
+                painter.fillRect(targetRect, Qt::black);
+            }
+            else
+            {
+                painter.fillRect(targetRect, Qt::white);
+            }
+
+            pScene->setRenderingContext(UBGraphicsScene::NonScreen);
+            pScene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
+
+            pScene->render(&painter, targetRect, sourceRect, incremental ? Qt::IgnoreAspectRatio : Qt::KeepAspectRatio);
+
+            pScene->setRenderingContext(UBGraphicsScene::Screen);
+            pScene->setRenderingQuality(UBItem::RenderingQualityNormal, UBItem::CacheAllowed);
         }
 
-        pScene->setRenderingContext(UBGraphicsScene::NonScreen);
-        pScene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
+        // only the scene shown in the board reports its damage
+        pScene->dropThumbnailCache();
 
-        pScene->render(&painter, imageRect, sceneRect, Qt::KeepAspectRatio);
+        if (isTrackedInBoard(pScene, sceneRect))
+        {
+            cache.image = thumb;
+            cache.sceneRect = sceneRect;
+            cache.darkBackground = darkBackground;
+        }
 
-        pScene->setRenderingContext(UBGraphicsScene::Screen);
-        pScene->setRenderingQuality(UBItem::RenderingQualityNormal, UBItem::CacheAllowed);
+        UBThumbnailWriter::writer()->write(fileName, thumb);
+    }
+}
 
-        thumb.scaled(width, height, Qt::KeepAspectRatio, Qt::SmoothTransformation).save(fileName, "JPG");
+/**
+ * @brief Whether the control view shows the scene and the whole thumbnail area
+ *
+ * Only then all later changes of the thumbnail area are painted and reported as damage.
+ */
+bool UBThumbnailAdaptor::isTrackedInBoard(std::shared_ptr<UBGraphicsScene> pScene, const QRectF& sceneRect)
+{
+    if (!UBApplication::boardController || UBApplication::boardController->activeScene() != pScene)
+    {
+        return false;
     }
+
+    UBBoardView* view = UBApplication::boardController->controlView();
+
+    return view && view->isVisible() && view->mapToScene(view->viewport()->rect()).boundingRect().contains(sceneRect);
 }
 
 
@@ -182,5 +271,8 @@ QUrl UBThumbnailAdaptor::thumbnailUrl(std::shared_ptr<UBDocumentProxy> proxy, in
 {
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
 
+    // the file is read by others, make sure it is written
+    UBThumbnailWriter::writer()->flush();
+
     return QUrl::fromLocalFile(fileName);
 }
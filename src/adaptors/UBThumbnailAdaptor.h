@@ -51,6 +51,7 @@ public:
 
 private:
     static void generateMissingThumbnails(std::shared_ptr<UBDocumentProxy> proxy);
+    static bool isTrackedInBoard(std::shared_ptr<UBGraphicsScene> pScene, const QRectF& sceneRect);
 
     UBThumbnailAdaptor() {}
 };
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBThumbnailWriter.h"
+
+#include <QtConcurrent>
+
+#include "frameworks/UBTrace.h"
+
+#include "core/memcheck.h"
+
+UBThumbnailWriter* UBThumbnailWriter::sWriter = nullptr;
+
+/** Time without new thumbnails before the pending ones are written */
+static const int sWriteDelayMs = 1000;
+
+UBThumbnailWriter* UBThumbnailWriter::writer()
+{
+    if (!sWriter)
+    {
+        sWriter = new UBThumbnailWriter();
+    }
+
+    return sWriter;
+}
+
+void UBThumbnailWriter::destroy()
+{
+    delete sWriter;
+    sWriter = nullptr;
+}
+
+UBThumbnailWriter::UBThumbnailWriter()
+    : QObject{nullptr}
+{
+}
+
+UBThumbnailWriter::~UBThumbnailWriter()
+{
+    flush();
+}
+
+/**
+ * @brief Schedule writing a thumbnail, replacing a pending image for the same file
+ */
+void UBThumbnailWriter::write(const QString& fileName, const QImage& image)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mPending.insert(fileName, image);
+    }
+
+    mTimer.start(sWriteDelayMs, this);
+}
+
+/**
+ * @brief Thumbnail image not yet written to the file, or a null image
+ */
+QImage UBThumbnailWriter::pendingImage(const QString& fileName) const
+{
+    QMutexLocker locker(&mMutex);
+
+    if (mPending.contains(fileName))
+    {
+        return mPending.value(fileName);
+    }
+
+    return mWriting.value(fileName);
+}
+
+/**
+ * @brief Write all pending thumbnails and wait until they are on disk
+ */
+void UBThumbnailWriter::flush()
+{
+    mTimer.stop();
+    mFuture.waitForFinished();
+
+    {
+        QMutexLocker locker(&mMutex);
+
+        if (mPending.isEmpty())
+        {
+            return;
+        }
+
+        mWriting.swap(mPending);
+    }
+
+    saveImages();
+}
+
+void UBThumbnailWriter::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != mTimer.timerId())
+    {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    if (mFuture.isRunning())
+    {
+        // try again when the previous files are written
+        return;
+    }
+
+    mTimer.stop();
+
+    {
+        QMutexLocker locker(&mMutex);
+        mWriting.swap(mPending);
+    }
+
+    mFuture = QtConcurrent::run([this](){ saveImages(); });
+}
+
+/**
+ * @brief Encode and write the images taken from the pending ones
+ *
+ * Runs on a worker thread, except when flushing.
+ */
+void UBThumbnailWriter::saveImages()
+{
+    UBTraceScope trace("UBThumbnailWriter::saveImages");
+
+    QHash<QString, QImage> images;
+
+    {
+        QMutexLocker locker(&mMutex);
+        images = mWriting;
+    }
+
+    for (auto it = images.cbegin(); it != images.cend(); ++it)
+    {
+        if (!it.value().save(it.key(), "JPG"))
+        {
+            qWarning() << "failed to write thumbnail" << it.key();
+        }
+    }
+
+    QMutexLocker locker(&mMutex);
+    mWriting.clear();
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QBasicTimer>
+#include <QFuture>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+
+/**
+ * Encodes and writes the page thumbnails in the background.
+ *
+ * Persisting a page only hands its thumbnail image to the writer. The JPEG files are
+ * written on a worker thread once no new thumbnail arrived for a short time, so that
+ * saving the same page repeatedly encodes its thumbnail only once. Images not yet
+ * written are returned by pendingImage() and flush() writes them before the thumbnail
+ * files are copied, moved or deleted.
+ */
+class UBThumbnailWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static UBThumbnailWriter* writer();
+    static void destroy();
+
+    void write(const QString& fileName, const QImage& image);
+    QImage pendingImage(const QString& fileName) const;
+    void flush();
+
+protected:
+    virtual void timerEvent(QTimerEvent* event) override;
+
+private:
+    UBThumbnailWriter();
+    virtual ~UBThumbnailWriter();
+
+    void saveImages();
+
+    static UBThumbnailWriter* sWriter;
+
+    mutable QMutex mMutex{};
+    QHash<QString, QImage> mPending{};
+    QHash<QString, QImage> mWriting{};
+    QFuture<void> mFuture{};
+    QBasicTimer mTimer{};
+};
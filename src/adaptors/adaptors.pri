@@ -2,6 +2,8 @@
 HEADERS      += src/adaptors/UBExportAdaptor.h\
     $$PWD/UBWidgetUpgradeAdaptor.h \
                 src/adaptors/UBExportPDF.h \
+                src/adaptors/UBExportPDFPipeline.h \
+                src/adaptors/UBBatchExporter.h \
                 src/adaptors/UBExportFullPDF.h \
                 src/adaptors/UBExportDocument.h \
                 src/adaptors/UBSvgSubsetAdaptor.h \
@@ -9,6 +11,7 @@ HEADERS      += src/adaptors/UBExportAdaptor.h\
                 src/adaptors/UBImportAdaptor.h \
                 src/adaptors/UBImportDocument.h \
                 src/adaptors/UBThumbnailAdaptor.h \
+                src/adaptors/UBThumbnailWriter.h \
                 src/adaptors/UBImportPDF.h \
                 src/adaptors/UBImportImage.h \
                 src/adaptors/UBExportWeb.h \
@@ -22,6 +25,8 @@ HEADERS      += src/adaptors/UBExportAdaptor.h\
 SOURCES      += src/adaptors/UBExportAdaptor.cpp\
     $$PWD/UBWidgetUpgradeAdaptor.cpp \
                 src/adaptors/UBExportPDF.cpp \
+                src/adaptors/UBExportPDFPipeline.cpp \
+                src/adaptors/UBBatchExporter.cpp \
                 src/adaptors/UBExportFullPDF.cpp \
                 src/adaptors/UBExportDocument.cpp \
                 src/adaptors/UBSvgSubsetAdaptor.cpp \
@@ -29,6 +34,7 @@ SOURCES      += src/adaptors/UBExportAdaptor.cpp\
                 src/adaptors/UBImportAdaptor.cpp \
                 src/adaptors/UBImportDocument.cpp \
                 src/adaptors/UBThumbnailAdaptor.cpp \
+                src/adaptors/UBThumbnailWriter.cpp \
                 src/adaptors/UBImportPDF.cpp \
                 src/adaptors/UBImportImage.cpp \
                 src/adaptors/UBExportWeb.cpp \
@@ -126,7 +126,7 @@ QObject* UBW3CWidgetAPI::preferences() const
 
 void UBW3CWidgetAPI::openURL(const QString& url)
 {
-    UBApplication::webController->loadUrl(QUrl(url));
+    UBApplication::webController()->loadUrl(QUrl(url));
 }
 
 // NOTE @letsfindaway all code from here to the end is obsolete
@@ -96,7 +96,7 @@ UBWidgetUniboardAPI::UBWidgetUniboardAPI(std::shared_ptr<UBGraphicsScene> pScene
         mDatastoreAPI = new UBDatastoreAPI(w3CGraphicsWidget);
     }
 
-    connect(UBDownloadManager::downloadManager(), SIGNAL(downloadFinished(bool,sDownloadFileDesc,QByteArray)), this, SLOT(onDownloadFinished(bool,sDownloadFileDesc,QByteArray)));
+    connect(UBDownloadManager::downloadManager(), SIGNAL(downloadFinished(bool,sDownloadFileDesc,QString)), this, SLOT(onDownloadFinished(bool,sDownloadFileDesc,QString)));
 }
 
 
@@ -582,7 +582,7 @@ bool UBWidgetUniboardAPI::ProcessDropEvent(QGraphicsSceneDragDropEvent *event)
     return true;
 }
 
-void UBWidgetUniboardAPI::onDownloadFinished(bool pSuccess, sDownloadFileDesc desc, QByteArray pData)
+void UBWidgetUniboardAPI::onDownloadFinished(bool pSuccess, sDownloadFileDesc desc, QString pLocalFile)
 {
     //if widget recieves is waiting for this id then process
     if (!takeIDWidget(desc.id))
@@ -610,15 +610,9 @@ void UBWidgetUniboardAPI::onDownloadFinished(bool pSuccess, sDownloadFileDesc de
     }
 
     QString destFileName = objDir + QUuid::createUuid().toString() + "." + extention;
-    QFile destFile(destFileName);
 
-    if (!destFile.open(QIODevice::WriteOnly)) {
-        qDebug() << "can't open" << destFileName << "for wrighting";
-        return;
-    }
-
-    if (destFile.write(pData) == -1) {
-        qDebug() << "can't implement data writing";
+    if (!QFile::copy(pLocalFile, destFileName)) {
+        qDebug() << "can't copy" << pLocalFile << "to" << destFileName;
         return;
     }
 
@@ -629,8 +623,6 @@ void UBWidgetUniboardAPI::onDownloadFinished(bool pSuccess, sDownloadFileDesc de
     QString mimeText = createMimeText(true, contentType, destFileName);
     dropMimeData.setData(tMimeText, mimeText.toLatin1());
 
-    destFile.close();
-
     //To make js interpreter accept drop event we need to generate move event first.
     QDragMoveEvent pseudoMove(dropPoint, desc.dropActions, &dropMimeData, desc.dropMouseButtons, desc.dropModifiers);
     QApplication::sendEvent(mGraphicsWidget,&pseudoMove);
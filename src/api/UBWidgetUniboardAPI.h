@@ -266,7 +266,7 @@ signals:
         void dropDataChanged(const QString& data);
 
 private slots:
-        void onDownloadFinished(bool pSuccess, sDownloadFileDesc desc, QByteArray pData);
+        void onDownloadFinished(bool pSuccess, sDownloadFileDesc desc, QString pLocalFile);
 
 private:
         inline void registerIDWidget(int id){webDownloadIds.append(id);}
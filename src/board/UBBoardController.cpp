@@ -143,7 +143,7 @@ void UBBoardController::init()
             , this, SLOT(lastWindowClosed()));
 
     connect(UBDownloadManager::downloadManager(), SIGNAL(downloadModalFinished()), this, SLOT(onDownloadModalFinished()));
-    connect(UBDownloadManager::downloadManager(), SIGNAL(addDownloadedFileToBoard(bool,QUrl,QUrl,QString,QByteArray,QPointF,QSize,bool)), this, SLOT(downloadFinished(bool,QUrl,QUrl,QString,QByteArray,QPointF,QSize,bool)));
+    connect(UBDownloadManager::downloadManager(), SIGNAL(addDownloadedFileToBoard(bool,QUrl,QUrl,QString,QString,QPointF,QSize,bool)), this, SLOT(downloadedFileFinished(bool,QUrl,QUrl,QString,QString,QPointF,QSize,bool)));
 
     auto persistenceManager{UBPersistenceManager::persistenceManager()};
     connect(persistenceManager, &UBPersistenceManager::documentSceneDuplicated, this, &UBBoardController::documentSceneDuplicated);
@@ -936,6 +936,7 @@ void UBBoardController::clearScene()
     if (mActiveScene)
     {
         freezeW3CWidgets(true);
+        UBPersistenceManager::persistenceManager()->completeSceneLoading(mActiveScene);
         mActiveScene->clearContent(UBGraphicsScene::clearItemsAndAnnotations);
         updateActionStates();
     }
@@ -947,6 +948,7 @@ void UBBoardController::clearSceneItems()
     if (mActiveScene)
     {
         freezeW3CWidgets(true);
+        UBPersistenceManager::persistenceManager()->completeSceneLoading(mActiveScene);
         mActiveScene->clearContent(UBGraphicsScene::clearItems);
         updateActionStates();
     }
@@ -957,6 +959,7 @@ void UBBoardController::clearSceneAnnotation()
 {
     if (mActiveScene)
     {
+        UBPersistenceManager::persistenceManager()->completeSceneLoading(mActiveScene);
         mActiveScene->clearContent(UBGraphicsScene::clearAnnotations);
         updateActionStates();
     }
@@ -966,6 +969,7 @@ void UBBoardController::clearSceneBackground()
 {
     if (mActiveScene)
     {
+        UBPersistenceManager::persistenceManager()->completeSceneLoading(mActiveScene);
         mActiveScene->clearContent(UBGraphicsScene::clearBackground);
         updateActionStates();
     }
@@ -1271,11 +1275,12 @@ void UBBoardController::downloadURL(const QUrl& url, QString contentSourceUrl, c
 }
 
 
-UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader,
-                                            QByteArray pData, QPointF pPos, QSize pSize,
-                                            bool isBackground, bool internalData)
+/**
+ * @brief Mime type of downloaded content, from its content type header or else from its url
+ */
+static QString downloadedMimeType(const QString& contentTypeHeader, const QUrl& sourceUrl)
 {
-    QString mimeType = pContentTypeHeader;
+    QString mimeType = contentTypeHeader;
 
     // In some cases "image/jpeg;charset=" is retourned by the drag-n-drop. That is
     // why we will check if an ; exists and take the first part (the standard allows this kind of mimetype)
@@ -1286,6 +1291,95 @@ UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl
     if(position != -1)
         mimeType=mimeType.left(position);
 
+    return mimeType;
+}
+
+
+UBItem *UBBoardController::downloadedFileFinished(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader,
+                                                  QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground)
+{
+    if (!pSuccess || pLocalFile.isEmpty())
+        return downloadFinished(pSuccess, sourceUrl, contentUrl, pContentTypeHeader, QByteArray(), pPos, pSize, isBackground);
+
+    QString mimeType = downloadedMimeType(pContentTypeHeader, sourceUrl);
+
+    UBMimeType::Enum itemMimeType = UBFileSystemUtils::mimeTypeFromString(mimeType);
+
+    if (UBMimeType::Video == itemMimeType || UBMimeType::Audio == itemMimeType)
+    {
+        mActiveScene->deselectAllItems();
+        UBApplication::showMessage(tr("Download finished"));
+
+        // media may be huge, so copy the downloaded file to the document instead of loading it
+        return addDownloadedMedia(itemMimeType, pLocalFile, nullptr, sourceUrl, contentUrl, pPos);
+    }
+    else if (UBMimeType::PDF == itemMimeType)
+    {
+        // shown here, the file url passed on is not reported as a download
+        UBApplication::showMessage(tr("Download finished"));
+
+        // imported from the downloaded file directly
+        return downloadFinished(true, QUrl::fromLocalFile(pLocalFile), contentUrl, pContentTypeHeader, QByteArray(), pPos, pSize, isBackground);
+    }
+
+    // images and widgets are small and are handled in memory
+    QByteArray data;
+    QFile file(pLocalFile);
+
+    if (file.open(QIODevice::ReadOnly))
+    {
+        data = file.readAll();
+        file.close();
+    }
+
+    return downloadFinished(true, sourceUrl, contentUrl, pContentTypeHeader, data, pPos, pSize, isBackground);
+}
+
+
+/**
+ * @brief Copy downloaded audio or video to the document and add it to the active scene
+ * @param sourcePath as the downloaded file, or the name of the source if data is given
+ * @param data as the downloaded content, or nullptr to copy the file at sourcePath
+ */
+UBGraphicsMediaItem *UBBoardController::addDownloadedMedia(UBMimeType::Enum mediaType, const QString& sourcePath, QByteArray *data,
+                                                           const QUrl& sourceUrl, const QUrl& contentUrl, const QPointF& pPos)
+{
+    QUuid uuid = QUuid::createUuid();
+    QString destFile;
+    QString destDirectory = UBMimeType::Video == mediaType
+            ? UBPersistenceManager::videoDirectory
+            : UBPersistenceManager::audioDirectory;
+
+    if (!UBPersistenceManager::persistenceManager()->addFileToDocument(selectedDocument(), sourcePath, destDirectory, uuid, destFile, data))
+    {
+        UBApplication::showMessage(tr("Add file operation failed: file copying error"));
+        return NULL;
+    }
+
+    UBGraphicsMediaItem *mediaItem = mActiveScene->addMedia(QUrl::fromLocalFile(destFile), false, pPos);
+
+    if (mediaItem)
+    {
+        if (contentUrl.isEmpty())
+            mediaItem->setSourceUrl(sourceUrl);
+        else
+            mediaItem->setSourceUrl(contentUrl);
+        mediaItem->setUuid(uuid);
+        connect(this, SIGNAL(activeSceneChanged()), mediaItem, SLOT(activeSceneChanged()));
+    }
+
+    UBDrawingController::drawingController()->setStylusTool(UBStylusTool::Selector);
+
+    return mediaItem;
+}
+
+
+UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader,
+                                            QByteArray pData, QPointF pPos, QSize pSize,
+                                            bool isBackground, bool internalData)
+{
+    QString mimeType = downloadedMimeType(pContentTypeHeader, sourceUrl);
+
     UBMimeType::Enum itemMimeType = UBFileSystemUtils::mimeTypeFromString(mimeType);
 
     if (!pSuccess)
@@ -1417,39 +1511,20 @@ UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl
     {
         qDebug() << "accepting mime type" << mimeType << "as video";
 
-        UBGraphicsMediaItem *mediaVideoItem = 0;
-        QUuid uuid = QUuid::createUuid();
         if (pData.length() > 0)
         {
-            QString destFile;
-            bool b = UBPersistenceManager::persistenceManager()->addFileToDocument(selectedDocument(),
-                sourceUrl.toString(),
-                UBPersistenceManager::videoDirectory,
-                uuid,
-                destFile,
-                &pData);
-            if (!b)
-            {
-                UBApplication::showMessage(tr("Add file operation failed: file copying error"));
-                return NULL;
-            }
-
-            QUrl url = QUrl::fromLocalFile(destFile);
-
-            mediaVideoItem = mActiveScene->addMedia(url, false, pPos);
-        }
-        else
-        {
-            qDebug() << sourceUrl.toString();
-            mediaVideoItem = addVideo(sourceUrl, false, pPos, true);
+            return addDownloadedMedia(itemMimeType, sourceUrl.toString(), &pData, sourceUrl, contentUrl, pPos);
         }
 
+        qDebug() << sourceUrl.toString();
+        UBGraphicsMediaItem *mediaVideoItem = addVideo(sourceUrl, false, pPos, true);
+
         if(mediaVideoItem){
             if (contentUrl.isEmpty())
                 mediaVideoItem->setSourceUrl(sourceUrl);
             else
                 mediaVideoItem->setSourceUrl(contentUrl);
-            mediaVideoItem->setUuid(uuid);
+            mediaVideoItem->setUuid(QUuid::createUuid());
             connect(this, SIGNAL(activeSceneChanged()), mediaVideoItem, SLOT(activeSceneChanged()));
         }
 
@@ -1461,39 +1536,19 @@ UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl
     {
         qDebug() << "accepting mime type" << mimeType << "as audio";
 
-        UBGraphicsMediaItem *audioMediaItem = 0;
-
-        QUuid uuid = QUuid::createUuid();
         if (pData.length() > 0)
         {
-            QString destFile;
-            bool b = UBPersistenceManager::persistenceManager()->addFileToDocument(selectedDocument(),
-                sourceUrl.toString(),
-                UBPersistenceManager::audioDirectory,
-                uuid,
-                destFile,
-                &pData);
-            if (!b)
-            {
-                UBApplication::showMessage(tr("Add file operation failed: file copying error"));
-                return NULL;
-            }
-
-            QUrl url = QUrl::fromLocalFile(destFile);
-
-            audioMediaItem = mActiveScene->addMedia(url, false, pPos);
-        }
-        else
-        {
-            audioMediaItem = addAudio(sourceUrl, false, pPos, true);
+            return addDownloadedMedia(itemMimeType, sourceUrl.toString(), &pData, sourceUrl, contentUrl, pPos);
         }
 
+        UBGraphicsMediaItem *audioMediaItem = addAudio(sourceUrl, false, pPos, true);
+
         if(audioMediaItem){
             if (contentUrl.isEmpty())
                 audioMediaItem->setSourceUrl(sourceUrl);
             else
                 audioMediaItem->setSourceUrl(contentUrl);
-            audioMediaItem->setUuid(uuid);
+            audioMediaItem->setUuid(QUuid::createUuid());
             connect(this, SIGNAL(activeSceneChanged()), audioMediaItem, SLOT(activeSceneChanged()));
         }
 
@@ -1695,7 +1750,7 @@ std::shared_ptr<UBGraphicsScene> UBBoardController::setActiveDocumentScene(std::
     if (index >= sceneCount && sceneCount > 0)
         index = sceneCount - 1;
 
-    std::shared_ptr<UBGraphicsScene> targetScene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, index);
+    std::shared_ptr<UBGraphicsScene> targetScene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, index, true, true);
 
     bool sceneChange = targetScene != mActiveScene;
 
@@ -1711,6 +1766,12 @@ std::shared_ptr<UBGraphicsScene> UBBoardController::setActiveDocumentScene(std::
             UBApplication::undoStack->clear();
         }
 
+        if (mActiveScene && sceneChange)
+        {
+            // the damage of a scene is only tracked while it is shown
+            mActiveScene->dropThumbnailCache();
+        }
+
         mActiveScene = targetScene;
         mActiveSceneIndex = index;
 
@@ -2823,7 +2884,7 @@ void UBBoardController::addItem()
 void UBBoardController::importPage()
 {
     int pageCount = selectedDocument()->pageCount();
-    if (UBApplication::documentController->addFileToDocument(selectedDocument()))
+    if (UBApplication::documentController()->addFileToDocument(selectedDocument()))
     {
         setActiveDocumentScene(selectedDocument(), pageCount, true);
     }
@@ -2844,6 +2905,12 @@ void UBBoardController::displayMetaData(QMap<QString, QString> metadatas)
     emit displayMetadata(metadatas);
 }
 
+/**
+ * @brief Freeze or resume the web widgets of the active scene
+ *
+ * Despite the name, this covers both W3C and Apple widgets: a frozen widget gives its web view
+ * back to the pool and shows its snapshot.
+ */
 void UBBoardController::freezeW3CWidgets(bool freeze)
 {
     if (mActiveSceneIndex >= 0)
@@ -2858,9 +2925,11 @@ void UBBoardController::freezeW3CWidgets(bool freeze)
 
 void UBBoardController::freezeW3CWidget(QGraphicsItem *item, bool freeze)
 {
-    if (item->type() == UBGraphicsW3CWidgetItem::Type)
+    // W3C and Apple widgets share the type of UBGraphicsWidgetItem
+    UBGraphicsWidgetItem* widget = qgraphicsitem_cast<UBGraphicsWidgetItem*>(item);
+
+    if (widget)
     {
-        UBGraphicsWidgetItem* widget = qgraphicsitem_cast<UBGraphicsWidgetItem*>(item);
         widget->setWebActive(!freeze);
     }
 }
@@ -222,6 +222,8 @@ class UBBoardController : public UBDocumentContainer
         UBItem *downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pHeader,
                                  QByteArray pData, QPointF pPos, QSize pSize,
                                  bool isBackground = false, bool internalData = false);
+        UBItem *downloadedFileFinished(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pHeader,
+                                       QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground = false);
         void changeBackground(bool isDark, UBPageBackground pageBackground);
         void setToolCursor(int tool);
         void showMessage(const QString& message, bool showSpinningWheel = false);
@@ -290,6 +292,8 @@ class UBBoardController : public UBDocumentContainer
         void appMainModeChanged(UBApplicationController::MainMode);
 
     private:
+        UBGraphicsMediaItem *addDownloadedMedia(UBMimeType::Enum mediaType, const QString& sourcePath, QByteArray *data,
+                                                const QUrl& sourceUrl, const QUrl& contentUrl, const QPointF& pPos);
         void initBackgroundGridSize();
         void updatePageSizeState();
         int autosaveTimeoutFromSettings() const;
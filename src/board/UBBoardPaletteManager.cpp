@@ -391,14 +391,14 @@ void UBBoardPaletteManager::erasePaletteButtonReleased()
 void UBBoardPaletteManager::linkClicked(const QUrl& url)
 {
       UBApplication::applicationController->showInternet();
-      UBApplication::webController->loadUrl(url);
+      UBApplication::webController()->loadUrl(url);
 }
 
 
 void UBBoardPaletteManager::purchaseLinkActivated(const QString& link)
 {
     UBApplication::applicationController->showInternet();
-    UBApplication::webController->loadUrl(QUrl(link));
+    UBApplication::webController()->loadUrl(QUrl(link));
 }
 
 void UBBoardPaletteManager::connectPalettes()
@@ -804,8 +804,8 @@ void UBBoardPaletteManager::changeMode(eUBDockPaletteWidgetMode newMode, bool is
             {
                 mLeftPalette->setVisible(leftPaletteVisible);
                 mRightPalette->setVisible(rightPaletteVisible);
-                mLeftPalette->assignParent(UBApplication::documentController->controlView());
-                mRightPalette->assignParent(UBApplication::documentController->controlView());
+                mLeftPalette->assignParent(UBApplication::documentController()->controlView());
+                mRightPalette->assignParent(UBApplication::documentController()->controlView());
                 if (UBPlatformUtils::hasVirtualKeyboard()
                     && mKeyboardPalette != NULL
                     && UBSettings::settings()->useSystemOnScreenKeyboard->get().toBool() == false)
@@ -814,11 +814,11 @@ void UBBoardPaletteManager::changeMode(eUBDockPaletteWidgetMode newMode, bool is
                     if(mKeyboardPalette->m_isVisible)
                     {
                         mKeyboardPalette->hide();
-                        mKeyboardPalette->setParent(UBApplication::documentController->controlView());
+                        mKeyboardPalette->setParent(UBApplication::documentController()->controlView());
                         mKeyboardPalette->show();
                     }
                     else
-                        mKeyboardPalette->setParent(UBApplication::documentController->controlView());
+                        mKeyboardPalette->setParent(UBApplication::documentController()->controlView());
                 }
                 if (mWebToolsCurrentPalette)
                     mWebToolsCurrentPalette->hide();
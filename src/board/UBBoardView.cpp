@@ -38,6 +38,7 @@
 
 #include "frameworks/UBGeometryUtils.h"
 #include "frameworks/UBPlatformUtils.h"
+#include "frameworks/UBTrace.h"
 
 #include "core/UBSettings.h"
 #include "core/UBMimeData.h"
@@ -335,6 +336,9 @@ bool UBBoardView::event (QEvent * e)
 
 void UBBoardView::tabletEvent (QTabletEvent * event)
 {
+    UBTraceScope trace("UBBoardView::tabletEvent");
+    traceInput();
+
     if (!mUseHighResTabletEvent) {
         event->setAccepted (false);
         return;
@@ -1244,6 +1248,9 @@ void UBBoardView::mousePressEvent (QMouseEvent *event)
 
 void UBBoardView::mouseMoveEvent (QMouseEvent *event)
 {
+    UBTraceScope trace("UBBoardView::mouseMoveEvent");
+    traceInput();
+
     //    static QTime lastCallTime;
     //    if (!lastCallTime.isNull()) {
     //        qDebug() << "time interval is " << lastCallTime.msecsTo(QTime::currentTime());
@@ -1762,30 +1769,38 @@ void UBBoardView::leaveEvent (QEvent * event)
 
 void UBBoardView::drawItems (QPainter *painter, int numItems, QGraphicsItem* items[], const QStyleOptionGraphicsItem options[])
 {
-    if (!mFilterZIndex)
-        QGraphicsView::drawItems (painter, numItems, items, options);
-    else
-    {
-        int count = 0;
+    UBTraceScope trace("UBBoardView::drawItems");
 
-        QGraphicsItem** itemsFiltered = new QGraphicsItem*[numItems];
-        QStyleOptionGraphicsItem *optionsFiltered = new QStyleOptionGraphicsItem[numItems];
+    int count = 0;
 
-        for (int i = 0; i < numItems; i++)
-        {
-            if (shouldDisplayItem (items[i]))
-            {
-                itemsFiltered[count] = items[i];
-                optionsFiltered[count] = options[i];
-                count++;
-            }
-        }
+    QGraphicsItem** itemsFiltered = new QGraphicsItem*[numItems];
+    QStyleOptionGraphicsItem *optionsFiltered = new QStyleOptionGraphicsItem[numItems];
+
+    const QTransform& viewTransform = painter->worldTransform();
+
+    for (int i = 0; i < numItems; i++)
+    {
+        if (mFilterZIndex && !shouldDisplayItem (items[i]))
+            continue;
 
-        QGraphicsView::drawItems (painter, count, itemsFiltered, optionsFiltered);
+        // items smaller than a pixel on screen are not painted at all, strokes as a whole
+        const QGraphicsItem* lodItem = UBItem::levelOfDetailItem(items[i]);
+        QRectF deviceRect = lodItem->deviceTransform(viewTransform).mapRect(lodItem->boundingRect());
 
-        delete[] optionsFiltered;
-        delete[] itemsFiltered;
+        if (UBItem::levelOfDetail(painter, deviceRect) == UBItem::LevelOfDetailHidden)
+            continue;
+
+        itemsFiltered[count] = items[i];
+        optionsFiltered[count] = options[i];
+        count++;
     }
+
+    UBTrace::counter("items drawn", count);
+    UBTrace::counter("items culled", numItems - count);
+    QGraphicsView::drawItems (painter, count, itemsFiltered, optionsFiltered);
+
+    delete[] optionsFiltered;
+    delete[] itemsFiltered;
 }
 
 void UBBoardView::dragMoveEvent(QDragMoveEvent *event)
@@ -1860,7 +1875,30 @@ void UBBoardView::resizeEvent (QResizeEvent * event)
 
 void UBBoardView::paintEvent(QPaintEvent *event)
 {
-    QGraphicsView::paintEvent(event);
+    {
+        UBTraceScope trace("UBBoardView::paintEvent");
+        QGraphicsView::paintEvent(event);
+    }
+
+    if (mTracedInput >= 0)
+    {
+        // from the first input event handled since the last paint to the end of this paint
+        UBTrace::complete("input to paint", mTracedInput, UBTrace::timestamp());
+        mTracedInput = -1;
+    }
+
+    if (bIsControl)
+    {
+        UBStartupTrace::firstFrame();
+
+        auto currentScene = scene();
+
+        if (currentScene)
+        {
+            const QRectF visibleRect = mapToScene(viewport()->rect()).boundingRect();
+            currentScene->addThumbnailDamage(mapToScene(event->rect()).boundingRect(), visibleRect);
+        }
+    }
 
     // ignore paint events under the left palette
     int paletteWidth = UBApplication::boardController->paletteManager()->leftPalette()->width();
@@ -1871,6 +1909,33 @@ void UBBoardView::paintEvent(QPaintEvent *event)
     }
 }
 
+void UBBoardView::hideEvent(QHideEvent *event)
+{
+    // changes made while hidden are not painted, so they would be missing in the thumbnail
+    auto currentScene = scene();
+
+    if (bIsControl && currentScene)
+    {
+        currentScene->dropThumbnailCache();
+    }
+
+    QGraphicsView::hideEvent(event);
+}
+
+/**
+ * @brief Remember the time of the first input event since the last paint, when tracing
+ */
+void UBBoardView::traceInput()
+{
+    if (UBTrace::isEnabled())
+    {
+        UBTrace::instant("input");
+
+        if (mTracedInput < 0)
+            mTracedInput = UBTrace::timestamp();
+    }
+}
+
 void UBBoardView::drawBackground (QPainter *painter, const QRectF &rect)
 {
     // draw the background of the QGraphicsScene
@@ -1911,6 +1976,8 @@ void UBBoardView::drawBackground (QPainter *painter, const QRectF &rect)
 
 void UBBoardView::drawForeground(QPainter* painter, const QRectF& rect)
 {
+    mWetInk.paint(painter, rect);
+
     QTransform transform{viewportTransform()};
     QRect viewportRect(0, 0, viewport()->width(), viewport()->height());
     QRectF visible{mapToScene(viewportRect).boundingRect()};
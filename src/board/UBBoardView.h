@@ -38,6 +38,8 @@
 #include "core/UB.h"
 #include "domain/UBGraphicsDelegateFrame.h"
 
+#include "UBWetInkOverlay.h"
+
 class UBBoardController;
 class UBGraphicsScene;
 class UBGraphicsWidgetItem;
@@ -69,6 +71,8 @@ public:
     void setBoxing(const QMargins& margins);
     void updateSnapIndicator(Qt::Corner corner, QPointF snapPoint, double angle = 0);
 
+    UBWetInkOverlay* wetInk() { return &mWetInk; }
+
     // work around for handling tablet events on MAC OS with Qt 4.8.0 and above
 #if defined(Q_OS_OSX)
     bool directTabletEvent(QEvent *event);
@@ -118,6 +122,7 @@ protected:
     virtual void resizeEvent(QResizeEvent * event);
 
     virtual void paintEvent(QPaintEvent *event);
+    virtual void hideEvent(QHideEvent *event);
 
     virtual void drawBackground(QPainter *painter, const QRectF &rect);
     virtual void drawForeground(QPainter *painter, const QRectF &rect);
@@ -212,8 +217,11 @@ private:
 
     QMargins mMargins{};
     UBSnapIndicator* mSnapIndicator{nullptr};
+    UBWetInkOverlay mWetInk{this};
+    qint64 mTracedInput{-1};
 
     static bool hasSelectedParents(QGraphicsItem * item);
+    void traceInput();
 
 private slots:
     void settingChanged(QVariant newValue);
@@ -313,6 +313,7 @@ bool UBFeature::inTrash() const
 
 UBFeaturesController::UBFeaturesController(QWidget *pParentWidget) :
     QObject(pParentWidget)
+    ,mScanStarted(false)
     ,featuresList(0)
     ,mLastItemOffsetIndex(0)
 {
@@ -375,8 +376,21 @@ UBFeaturesController::UBFeaturesController(QWidget *pParentWidget) :
     connect(&mCThread, SIGNAL(scanCategory(QString)), this, SIGNAL(scanCategory(QString)));
     connect(&mCThread, SIGNAL(scanPath(QString)), this, SIGNAL(scanPath(QString)));
     connect(UBApplication::boardController, SIGNAL(npapiWidgetCreated(QString)), this, SLOT(createNpApiFeature(QString)));
+}
 
-    QTimer::singleShot(0, this, SLOT(startThread()));
+/**
+ * @brief Start scanning the library folders, unless already done
+ *
+ * The library is scanned on first use rather than at startup, so that it does not
+ * compete with showing the board.
+ */
+void UBFeaturesController::startScan()
+{
+    if (!mScanStarted)
+    {
+        mScanStarted = true;
+        startThread();
+    }
 }
 
 void UBFeaturesController::startThread()
@@ -1025,7 +1039,7 @@ UBFeature UBFeaturesController::getDestinationFeatureForMimeType(const QString &
     return UBFeature();
 }
 
-void UBFeaturesController::addDownloadedFile(const QUrl &sourceUrl, const QByteArray &pData, const QString pContentSource, const QString pTitle)
+void UBFeaturesController::addDownloadedFile(const QUrl &sourceUrl, const QString &pLocalFile, const QString pContentSource, const QString pTitle)
 {
     UBFeature dest = getDestinationFeatureForMimeType(pContentSource);
 
@@ -1045,7 +1059,7 @@ void UBFeaturesController::addDownloadedFile(const QUrl &sourceUrl, const QByteA
 
         filePath = dest.getFullPath().toLocalFile() + "/" + fileName;
 
-        QImage::fromData(pData).save(filePath);
+        QImage(pLocalFile).save(filePath);
 
         UBFeature downloadedFeature = UBFeature(dest.getFullVirtualPath() + "/" + fileName, getIcon( filePath, fileTypeFromUrl(filePath)),
                                                  fileName, QUrl::fromLocalFile(filePath), FEATURE_ITEM);
@@ -1057,12 +1071,8 @@ void UBFeaturesController::addDownloadedFile(const QUrl &sourceUrl, const QByteA
         fileName = QFileInfo( sourceUrl.toString() ).fileName();
         filePath = dest.getFullPath().toLocalFile() + "/" + fileName;
 
-        QFile file( filePath );
-        if ( file.open(QIODevice::WriteOnly ))
+        if ( QFile::copy(pLocalFile, filePath) )
         {
-            file.write(pData);
-            file.close();
-
             UBFeature downloadedFeature = UBFeature(dest.getFullVirtualPath() + "/" + fileName, getIcon( filePath, fileTypeFromUrl(filePath)),
                                                     fileName, QUrl::fromLocalFile(filePath), FEATURE_ITEM);
             if (downloadedFeature != UBFeature()) {
@@ -173,6 +173,7 @@ public:
 
     const QString& getRootPath()const {return rootPath;}
     void scanFS();
+    void startScan();
 
     void addItemToPage(const UBFeature &item);
     void addItemAsBackground(const UBFeature &item);
@@ -181,7 +182,7 @@ public:
     void setCurrentElement( const UBFeature &elem ) {currentElement = elem;}
     const UBFeature & getTrashElement () const { return trashElement; }
 
-    void addDownloadedFile( const QUrl &sourceUrl, const QByteArray &pData, const QString pContentSource, const QString pTitle );
+    void addDownloadedFile( const QUrl &sourceUrl, const QString &pLocalFile, const QString pContentSource, const QString pTitle );
 
     UBFeature moveItemToFolder( const QUrl &url, const UBFeature &destination );
     UBFeature copyItemToFolder( const QUrl &url, const UBFeature &destination );
@@ -262,6 +263,7 @@ private:
 
     QAbstractItemModel *curListModel;
     UBFeaturesComputingThread mCThread;
+    bool mScanStarted;
 
 private:
 
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBWetInkOverlay.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QGraphicsPolygonItem>
+#include <QGraphicsView>
+#include <QPainter>
+#include <QPainterPath>
+
+#include "core/UB.h"
+
+#include "core/memcheck.h"
+
+/** Margin around the repainted rectangles, covering antialiasing and rounding */
+static const int sUpdateMargin = 2;
+
+#ifdef UB_PROFILING
+/** Monotonic clock of the latency measurement and time of the last input event */
+static QElapsedTimer sLatencyClock;
+static qint64 sLastInput = -1;
+#endif
+
+UBWetInkOverlay::UBWetInkOverlay(QGraphicsView* view)
+    : mView(view)
+{
+}
+
+/**
+ * @brief Render a new polygon of the current stroke and repaint the area it covers
+ *
+ * The polygon must stay alive until the overlay is cleared.
+ */
+void UBWetInkOverlay::addPolygon(const QGraphicsPolygonItem* polygon)
+{
+    mScene = mView->scene();
+    mPolygons << polygon;
+
+#ifdef UB_PROFILING
+    if (mPendingInput < 0)
+    {
+        mPendingInput = sLastInput;
+    }
+#endif
+
+    if (!isBufferValid())
+    {
+        // paint() renders all polygons again
+        mView->viewport()->update();
+        return;
+    }
+
+    QPainter painter(&mBuffer);
+    painter.setTransform(mBufferTransform * QTransform::fromScale(mBuffer.devicePixelRatio(), mBuffer.devicePixelRatio()));
+    paintPolygon(&painter, polygon);
+    painter.end();
+
+    const QRect rect = viewportRect(polygon);
+    mDirtyRect |= rect;
+    mView->viewport()->update(rect);
+}
+
+/**
+ * @brief Set the polygon joining the stroke to the pen position
+ *
+ * This polygon is replaced at each move, so it is painted directly instead of being
+ * rendered into the buffer. The previous polygon must still be alive when it is replaced.
+ */
+void UBWetInkOverlay::setTemporaryPolygon(const QGraphicsPolygonItem* polygon)
+{
+    if (mTemporaryPolygon)
+    {
+        mView->viewport()->update(viewportRect(mTemporaryPolygon));
+    }
+
+    mScene = mView->scene();
+    mTemporaryPolygon = polygon;
+
+    if (mTemporaryPolygon)
+    {
+        mView->viewport()->update(viewportRect(mTemporaryPolygon));
+    }
+}
+
+/**
+ * @brief Forget the stroke and repaint the area it covered
+ */
+void UBWetInkOverlay::clear()
+{
+    setTemporaryPolygon(nullptr);
+
+    if (!mDirtyRect.isNull())
+    {
+        mView->viewport()->update(mDirtyRect);
+    }
+
+    mScene = nullptr;
+    mPolygons.clear();
+    mBuffer = QImage();
+    mDirtyRect = QRect();
+}
+
+/**
+ * @brief Paint the wet ink on top of the view
+ *
+ * Called by the view when drawing its foreground, with the painter in scene coordinates.
+ * The buffer is rendered again after the view was scrolled, zoomed or resized. Tools are
+ * stacked above the drawings, so the wet ink is clipped out of the tools in the exposed rect.
+ */
+void UBWetInkOverlay::paint(QPainter* painter, const QRectF& exposed)
+{
+    if ((mPolygons.isEmpty() && !mTemporaryPolygon) || mView->scene() != mScene)
+    {
+        return;
+    }
+
+    painter->save();
+
+    const QPainterPath tools = toolsShape(exposed);
+
+    if (!tools.isEmpty())
+    {
+        QPainterPath clip;
+        clip.addRect(exposed);
+        painter->setClipPath(clip.subtracted(tools), Qt::IntersectClip);
+    }
+
+    if (!mPolygons.isEmpty())
+    {
+        if (!isBufferValid())
+        {
+            rebuild();
+        }
+
+        painter->save();
+        painter->resetTransform();
+        painter->drawImage(QPointF(0, 0), mBuffer);
+        painter->restore();
+    }
+
+    if (mTemporaryPolygon)
+    {
+        paintPolygon(painter, mTemporaryPolygon);
+    }
+
+    painter->restore();
+
+#ifdef UB_PROFILING
+    if (mPendingInput >= 0)
+    {
+        static qint64 totalNsecs = 0;
+        static qint64 maxNsecs = 0;
+        static int paintCount = 0;
+        static const int reportInterval = 200;
+
+        const qint64 nsecs = sLatencyClock.nsecsElapsed() - mPendingInput;
+        totalNsecs += nsecs;
+        maxNsecs = qMax(maxNsecs, nsecs);
+        mPendingInput = -1;
+
+        if (++paintCount == reportInterval)
+        {
+            qDebug() << "wet ink input to paint:" << totalNsecs / reportInterval / 1000. << "us on average,"
+                     << maxNsecs / 1000. << "us at most";
+
+            totalNsecs = 0;
+            maxNsecs = 0;
+            paintCount = 0;
+        }
+    }
+#endif
+}
+
+#ifdef UB_PROFILING
+/**
+ * @brief Record the time at which the scene received a pen event
+ *
+ * The latency is measured from the first event drawn since the last paint of the view.
+ */
+void UBWetInkOverlay::recordInput()
+{
+    if (!sLatencyClock.isValid())
+    {
+        sLatencyClock.start();
+    }
+
+    sLastInput = sLatencyClock.nsecsElapsed();
+}
+#endif
+
+void UBWetInkOverlay::rebuild()
+{
+    const qreal ratio = mView->viewport()->devicePixelRatioF();
+
+    mBufferTransform = mView->viewportTransform();
+    mBuffer = QImage(mView->viewport()->size() * ratio, QImage::Format_ARGB32_Premultiplied);
+    mBuffer.setDevicePixelRatio(ratio);
+    mBuffer.fill(Qt::transparent);
+
+    QPainter painter(&mBuffer);
+    painter.setTransform(mBufferTransform * QTransform::fromScale(ratio, ratio));
+
+    foreach (const QGraphicsPolygonItem* polygon, mPolygons)
+    {
+        paintPolygon(&painter, polygon);
+    }
+
+    mDirtyRect = QRect(QPoint(0, 0), mView->viewport()->size());
+}
+
+void UBWetInkOverlay::paintPolygon(QPainter* painter, const QGraphicsPolygonItem* polygon) const
+{
+    painter->save();
+    painter->setTransform(polygon->sceneTransform(), true);
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(polygon->pen());
+    painter->setBrush(polygon->brush());
+    painter->drawPolygon(polygon->polygon(), polygon->fillRule());
+    painter->restore();
+}
+
+QPainterPath UBWetInkOverlay::toolsShape(const QRectF& exposed) const
+{
+    QPainterPath shape;
+    shape.setFillRule(Qt::WindingFill);
+
+    const QRect rect = mView->viewportTransform().mapRect(exposed).toAlignedRect();
+
+    foreach (const QGraphicsItem* item, mView->items(rect))
+    {
+        if (item->parentItem() || !item->isVisible())
+        {
+            continue;
+        }
+
+        // a new stroke is above all drawings and objects, only the tool layers can cover it
+        const int layer = item->data(UBGraphicsItemData::itemLayerType).toInt();
+
+        if (layer == itemLayerType::ToolItem || layer == itemLayerType::CppTool || layer == itemLayerType::Curtain)
+        {
+            shape.addPath(item->sceneTransform().map(item->shape()));
+        }
+    }
+
+    return shape;
+}
+
+QRect UBWetInkOverlay::viewportRect(const QGraphicsPolygonItem* polygon) const
+{
+    const QRectF sceneRect = polygon->sceneTransform().mapRect(polygon->boundingRect());
+
+    return mView->viewportTransform().mapRect(sceneRect).toAlignedRect()
+            .adjusted(-sUpdateMargin, -sUpdateMargin, sUpdateMargin, sUpdateMargin);
+}
+
+bool UBWetInkOverlay::isBufferValid() const
+{
+    return !mBuffer.isNull()
+            && mBuffer.devicePixelRatio() == mView->viewport()->devicePixelRatioF()
+            && mBuffer.size() == mView->viewport()->size() * mBuffer.devicePixelRatio()
+            && mBufferTransform == mView->viewportTransform();
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QTransform>
+
+class QGraphicsPolygonItem;
+class QGraphicsScene;
+class QGraphicsView;
+class QPainter;
+class QPainterPath;
+class QRectF;
+
+/**
+ * Shows the stroke being drawn before it is added to the scene.
+ *
+ * Each polygon of the stroke is rendered once into an image of the size of the viewport
+ * and only the rectangle it covers is repainted. Polygons are not inserted into the scene
+ * while the pen is down, so that the scene index and the change tracking of the scene
+ * are not involved in drawing wet ink. The scene commits the stroke on pen up and clears
+ * the overlay.
+ */
+class UBWetInkOverlay
+{
+public:
+    explicit UBWetInkOverlay(QGraphicsView* view);
+
+    void addPolygon(const QGraphicsPolygonItem* polygon);
+    void setTemporaryPolygon(const QGraphicsPolygonItem* polygon);
+    void clear();
+
+    void paint(QPainter* painter, const QRectF& exposed);
+
+#ifdef UB_PROFILING
+    static void recordInput();
+#endif
+
+private:
+    void rebuild();
+    void paintPolygon(QPainter* painter, const QGraphicsPolygonItem* polygon) const;
+    QPainterPath toolsShape(const QRectF& exposed) const;
+    QRect viewportRect(const QGraphicsPolygonItem* polygon) const;
+    bool isBufferValid() const;
+
+    QGraphicsView* mView{nullptr};
+    // scene of the stroke, the overlay is not painted when the view shows another one
+    const QGraphicsScene* mScene{nullptr};
+    QImage mBuffer{};
+    QTransform mBufferTransform{};
+    QList<const QGraphicsPolygonItem*> mPolygons{};
+    const QGraphicsPolygonItem* mTemporaryPolygon{nullptr};
+    QRect mDirtyRect{};
+
+#ifdef UB_PROFILING
+    qint64 mPendingInput{-1};
+#endif
+};
@@ -3,13 +3,15 @@ HEADERS      += src/board/UBBoardController.h \
                 src/board/UBBoardPaletteManager.h \
                 src/board/UBBoardView.h \
                 src/board/UBDrawingController.h \
-		src/board/UBFeaturesController.h
+		src/board/UBFeaturesController.h \
+                src/board/UBWetInkOverlay.h
 
 SOURCES      += src/board/UBBoardController.cpp \
                 src/board/UBBoardPaletteManager.cpp \
                 src/board/UBBoardView.cpp \
                 src/board/UBDrawingController.cpp \
-		src/board/UBFeaturesController.cpp
+		src/board/UBFeaturesController.cpp \
+                src/board/UBWetInkOverlay.cpp
 
     
     
@@ -37,16 +37,21 @@
 #include "frameworks/UBPlatformUtils.h"
 #include "frameworks/UBFileSystemUtils.h"
 #include "frameworks/UBStringUtils.h"
+#include "frameworks/UBTrace.h"
 
 #include "UBSettings.h"
 #include "UBSetting.h"
 #include "UBPersistenceManager.h"
+#include "UBSceneReclaimer.h"
 #include "UBDocumentManager.h"
 #include "UBPreferencesController.h"
 #include "UBIdleTimer.h"
 #include "UBApplicationController.h"
 #include "UBShortcutManager.h"
 
+#include "adaptors/UBBatchExporter.h"
+#include "adaptors/UBThumbnailWriter.h"
+
 #include "board/UBBoardController.h"
 #include "board/UBDrawingController.h"
 #include "board/UBBoardView.h"
@@ -56,6 +61,10 @@
 #include "document/UBDocumentController.h"
 #include "document/UBDocumentProxy.h"
 
+#include "domain/UBUndoHistory.h"
+#include "domain/UBWidgetViewPool.h"
+
+#include "gui/UBCaptureService.h"
 #include "gui/UBMainWindow.h"
 #include "gui/UBResources.h"
 #include "gui/UBThumbnail.h"
@@ -74,12 +83,13 @@ QPointer<QUndoStack> UBApplication::undoStack;
 UBDisplayManager* UBApplication::displayManager = nullptr;
 UBApplicationController* UBApplication::applicationController = 0;
 UBBoardController* UBApplication::boardController = 0;
-UBWebController* UBApplication::webController = 0;
-UBDocumentController* UBApplication::documentController = 0;
+UBWebController* UBApplication::sWebController = 0;
+UBDocumentController* UBApplication::sDocumentController = 0;
 
 UBMainWindow* UBApplication::mainWindow = 0;
 
 bool UBApplication::isClosing = false;
+bool UBApplication::isHeadless = false;
 
 const QString UBApplication::mimeTypeUniboardDocument = QString("application/vnd.mnemis-uniboard-document");
 const QString UBApplication::mimeTypeUniboardPage = QString("application/vnd.mnemis-uniboard-page");
@@ -101,6 +111,8 @@ UBApplication::UBApplication(const QString &id, int &argc, char **argv) : Single
   , mQtGuiTranslator(NULL)
 {
     Q_UNUSED(id)
+    UBStartupTrace::phase("application setup");
+
     staticMemoryCleaner = new QObject(0); // deleted in UBApplication destructor
 
     setOrganizationName("Open Education Foundation");
@@ -131,7 +143,10 @@ UBApplication::UBApplication(const QString &id, int &argc, char **argv) : Single
     UBResources::resources();
 
     if (!undoStack)
+    {
         undoStack = new QUndoStack(staticMemoryCleaner);
+        new UBUndoHistory(undoStack, undoStack);
+    }
 
     UBPlatformUtils::init();
 
@@ -165,11 +180,25 @@ UBApplication::~UBApplication()
 
     UBFileSystemUtils::deleteAllTempDirCreatedDuringSession();
 
+    if (UBTrace::isEnabled())
+    {
+        UBTrace::setEnabled(false);
+        saveTrace();
+    }
+
     delete mainWindow;
     mainWindow = 0;
 
+    UBCaptureService::destroy();
+
     UBPersistenceManager::destroy();
 
+    UBThumbnailWriter::destroy();
+
+    UBSceneReclaimer::destroy();
+
+    UBWidgetViewPool::destroy();
+
     UBDownloadManager::destroy();
 
     UBDrawingController::destroy();
@@ -310,6 +339,11 @@ int UBApplication::exec(const QString& pFileToImport)
 {
     QPixmapCache::setCacheLimit(1024 * 100);
 
+    if (UBSettings::settings()->appPerformanceTrace->get().toBool())
+        UBTrace::setEnabled(true);
+
+    UBStartupTrace::phase("main window");
+
     displayManager = new UBDisplayManager(staticMemoryCleaner);
 
     if (UBSettings::settings()->appRunInWindow->get().toBool()) {
@@ -340,14 +374,23 @@ int UBApplication::exec(const QString& pFileToImport)
     connect(mainWindow->actionQuit, SIGNAL(triggered()), this, SLOT(closing()));
     connect(mainWindow, SIGNAL(closeEvent_Signal(QCloseEvent*)), this, SLOT(closeEvent(QCloseEvent*)));
 
+    QAction* traceAction = new QAction(tr("Performance trace"), mainWindow);
+    traceAction->setObjectName("actionPerformanceTrace");
+    traceAction->setToolTip(tr("Start or stop recording a performance trace"));
+    traceAction->setShortcut(QKeySequence(Qt::CTRL | Qt::ALT | Qt::SHIFT | Qt::Key_T));
+    connect(traceAction, &QAction::triggered, this, &UBApplication::toggleTrace);
+    UBShortcutManager::shortcutManager()->addActions(tr("Diagnostics"), { traceAction }, mainWindow);
+
+    // the web and document controllers are created on first use, see webController() and documentController()
+    UBStartupTrace::phase("board controller");
+
     boardController = new UBBoardController(mainWindow);
     boardController->init();
 
-    webController = new UBWebController(mainWindow);
-    documentController = new UBDocumentController(mainWindow);
-
     UBDrawingController::drawingController()->setStylusTool((int)UBStylusTool::Pen);
 
+    UBStartupTrace::phase("application controller");
+
     applicationController = new UBApplicationController(boardController->controlView(),
                                                         boardController->displayView(),
                                                         mainWindow,
@@ -380,6 +423,8 @@ int UBApplication::exec(const QString& pFileToImport)
     connect(mainWindow->actionHideApplication, SIGNAL(triggered()), mainWindow, SLOT(showMinimized()));
 #endif
 
+    UBStartupTrace::phase("preferences");
+
     mPreferencesController = new UBPreferencesController(mainWindow);
 
     connect(mainWindow->actionPreferences, SIGNAL(triggered()), mPreferencesController, SLOT(show()));
@@ -398,6 +443,8 @@ int UBApplication::exec(const QString& pFileToImport)
     connect(mainWindow->actionCopy, SIGNAL(triggered()), applicationController, SLOT(actionCopy()));
     connect(mainWindow->actionPaste, SIGNAL(triggered()), applicationController, SLOT(actionPaste()));
 
+    UBStartupTrace::phase("screen layout");
+
     applicationController->initScreenLayout(bUseMultiScreen);
     boardController->setupLayout();
 
@@ -409,6 +456,8 @@ int UBApplication::exec(const QString& pFileToImport)
             applicationController->showMessage(tr("Cannot open your UBX file directly. Please import it in Documents mode instead"), false);
     }
 
+    UBStartupTrace::phase("first frame");
+
     if (UBSettings::settings()->appStartMode->get().toInt() == 1)
         applicationController->showDesktop();
     else if (UBSettings::settings()->appStartMode->get().toInt() == 2)
@@ -416,6 +465,10 @@ int UBApplication::exec(const QString& pFileToImport)
     else
         applicationController->showBoard();
 
+    // the board view ends the startup when painting, other modes end it with the first event loop iteration
+    if (UBSettings::settings()->appStartMode->get().toInt() != 0)
+        QTimer::singleShot(0, this, [](){ UBStartupTrace::firstFrame(); });
+
     if(UBSettings::settings()->appStartupHintsEnabled->get().toBool())
     {
         UBApplication::boardController->paletteManager()->tipsPalette()->show();
@@ -428,11 +481,60 @@ int UBApplication::exec(const QString& pFileToImport)
     return QApplication::exec();
 }
 
+int UBApplication::execBatchExport()
+{
+    // exporters only need the display manager for the screen resolution
+    isHeadless = true;
+    displayManager = new UBDisplayManager(staticMemoryCleaner);
+
+    UBBatchExporter exporter;
+    return exporter.run(arguments());
+}
+
 void UBApplication::onScreenCountChanged(int newCount)
 {
     mainWindow->actionMultiScreen->setEnabled(newCount > 1);
 }
 
+void UBApplication::toggleTrace()
+{
+    if (!UBTrace::isEnabled())
+    {
+        UBTrace::setEnabled(true);
+        showMessage(tr("Recording a performance trace"));
+        return;
+    }
+
+    UBTrace::setEnabled(false);
+
+    QString filename = saveTrace();
+
+    if (filename.isEmpty())
+        showMessage(tr("Could not save the performance trace"));
+    else
+        showMessage(tr("Performance trace saved to %1").arg(QDir::toNativeSeparators(filename)));
+}
+
+/**
+ * @brief Save the recorded trace in the traces directory of the user data
+ *
+ * Returns the name of the file or an empty string on failure.
+ */
+QString UBApplication::saveTrace()
+{
+    QString directory = UBSettings::userDataDirectory() + "/traces";
+    QString filename = directory + "/trace-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".json";
+
+    if (!QDir().mkpath(directory) || !UBTrace::save(filename))
+    {
+        qWarning() << "Cannot write performance trace" << filename;
+        return QString();
+    }
+
+    qDebug() << "Performance trace saved to" << filename;
+    return filename;
+}
+
 void UBApplication::showMinimized()
 {
 #ifdef Q_OS_OSX
@@ -464,7 +566,7 @@ void UBApplication::showBoard()
 void UBApplication::showInternet()
 {
     applicationController->showInternet();
-    webController->showTabAtTop(true);
+    webController()->showTabAtTop(true);
 }
 
 void UBApplication::showDocument()
@@ -491,7 +593,8 @@ void UBApplication::toolBarPositionChanged(QVariant topOrBottom)
     mainWindow->addToolBar(area, mainWindow->webToolBar);
     mainWindow->addToolBar(area, mainWindow->documentToolBar);
 
-    webController->showTabAtTop(topOrBottom.toBool());
+    if (sWebController)
+        sWebController->showTabAtTop(topOrBottom.toBool());
 
 }
 
@@ -519,9 +622,9 @@ void UBApplication::closing()
     if (UBSettings::settings()->emptyTrashForOlderDocuments->get().toBool())
     {
         UBDocumentTreeModel *docModel = UBPersistenceManager::persistenceManager()->mDocumentTreeStructureModel;
-        documentController->deleteDocumentsInFolderOlderThan(docModel->trashIndex(), UBSettings::settings()->emptyTrashDaysValue->get().toInt());
+        documentController()->deleteDocumentsInFolderOlderThan(docModel->trashIndex(), UBSettings::settings()->emptyTrashDaysValue->get().toInt());
         if (docModel->hasChildren(docModel->trashIndex()))
-            documentController->deleteEmptyFolders(docModel->trashIndex());
+            documentController()->deleteEmptyFolders(docModel->trashIndex());
     }
 
     if (boardController)
@@ -530,8 +633,8 @@ void UBApplication::closing()
     if (applicationController)
         applicationController->closing();
 
-    if (webController)
-        webController->closing();
+    if (sWebController)
+        sWebController->closing();
 
     UBSettings::settings()->closing();
 
@@ -672,7 +775,8 @@ bool UBApplication::eventFilter(QObject *obj, QEvent *event)
 
     else if (event->type() == QEvent::ApplicationActivate)
     {
-        boardController->controlView()->setMultiselection(false);
+        if (boardController)
+            boardController->controlView()->setMultiselection(false);
 
 #if defined(Q_OS_OSX)
         if (bIsMinimized) {
@@ -741,13 +845,53 @@ void UBApplication::cleanup()
 {
     if (applicationController) delete applicationController;
     if (boardController) delete boardController;
-    if (webController) delete webController;
-    if (documentController) delete documentController;
+    if (sWebController) delete sWebController;
+    if (sDocumentController) delete sDocumentController;
 
     applicationController = NULL;
     boardController = NULL;
-    webController = NULL;
-    documentController = NULL;
+    sWebController = NULL;
+    sDocumentController = NULL;
+}
+
+/**
+ * @brief The web controller, created on first use
+ *
+ * Creating it sets up the web engine profile, which is slow, so it is not done at startup.
+ * Returns NULL when there is no main window, e.g. when exporting in batch mode.
+ */
+UBWebController* UBApplication::webController()
+{
+    if (!sWebController && mainWindow)
+    {
+        UBTraceScope trace("UBApplication::webController");
+
+        sWebController = new UBWebController(mainWindow);
+
+        connect(displayManager, SIGNAL(screenLayoutChanged()), sWebController, SLOT(screenLayoutChanged()));
+
+        sWebController->screenLayoutChanged();
+        sWebController->adaptToolBar();
+    }
+
+    return sWebController;
+}
+
+/**
+ * @brief The document controller, created on first use
+ *
+ * Returns NULL when there is no main window, e.g. when exporting in batch mode.
+ */
+UBDocumentController* UBApplication::documentController()
+{
+    if (!sDocumentController && mainWindow)
+    {
+        UBTraceScope trace("UBApplication::documentController");
+
+        sDocumentController = new UBDocumentController(mainWindow);
+    }
+
+    return sDocumentController;
 }
 
 QString UBApplication::urlFromHtml(QString html)
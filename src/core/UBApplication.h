@@ -65,6 +65,7 @@ class UBApplication : public SingleApplication
         virtual ~UBApplication();
 
         int exec(const QString& pFileToImport);
+        int execBatchExport();
 
         void cleanup();
 
@@ -73,12 +74,15 @@ class UBApplication : public SingleApplication
         static UBDisplayManager* displayManager;
         static UBApplicationController *applicationController;
         static UBBoardController* boardController;
-        static UBWebController* webController;
-        static UBDocumentController* documentController;
+        static UBWebController* webController();
+        static UBDocumentController* documentController();
+        static bool hasWebController() { return sWebController; }
+        static bool hasDocumentController() { return sDocumentController; }
 
         static UBMainWindow* mainWindow;
 
         static bool isClosing;
+        static bool isHeadless;
 
         static UBApplication* app()
         {
@@ -136,8 +140,13 @@ class UBApplication : public SingleApplication
         void showMinimized();
 //#endif
         void onScreenCountChanged(int newCount);
+        void toggleTrace();
 
     private:
+        static UBWebController* sWebController;
+        static UBDocumentController* sDocumentController;
+
+        QString saveTrace();
         void updateProtoActionsState();
         void setupTranslators(QStringList args);
         QList<QMenu*> mProtoMenus;
@@ -96,7 +96,6 @@ UBApplicationController::UBApplicationController(UBBoardView *pControlView,
 
     connect(displayManager, SIGNAL(screenLayoutChanged()), this, SLOT(screenLayoutChanged()));
     connect(displayManager, SIGNAL(screenLayoutChanged()), mUninoteController, SLOT(screenLayoutChanged()));
-    connect(displayManager, SIGNAL(screenLayoutChanged()), UBApplication::webController, SLOT(screenLayoutChanged()));
     connect(displayManager, &UBDisplayManager::availableScreenCountChanged,this,  [this](){
         initPreviousViews();
         UBApplication::displayManager->setPreviousDisplaysWidgets(mPreviousViews);
@@ -112,9 +111,6 @@ UBApplicationController::UBApplicationController(UBBoardView *pControlView,
         mMirror = new UBScreenMirror();
     }
 
-    connect(UBApplication::webController, SIGNAL(imageCaptured(const QPixmap &, bool, const QUrl&))
-            , this, SLOT(addCapturedPixmap(const QPixmap &, bool, const QUrl&)));
-
     mNetworkAccessManager = new QNetworkAccessManager (this);
     QTimer::singleShot (1000, this, SLOT (checkAtLaunch()));
 }
@@ -208,18 +204,21 @@ void UBApplicationController::adaptToolBar()
 
     if (Document == mMainMode)
     {
-        connect(UBApplication::instance(), SIGNAL(focusChanged(QWidget *, QWidget *)), UBApplication::documentController, SLOT(focusChanged(QWidget *, QWidget *)));
+        connect(UBApplication::instance(), SIGNAL(focusChanged(QWidget *, QWidget *)), UBApplication::documentController(), SLOT(focusChanged(QWidget *, QWidget *)));
     }
     else
     {
-        disconnect(UBApplication::instance(), SIGNAL(focusChanged(QWidget *, QWidget *)), UBApplication::documentController, SLOT(focusChanged(QWidget *, QWidget *)));
+        if (UBApplication::hasDocumentController())
+            disconnect(UBApplication::instance(), SIGNAL(focusChanged(QWidget *, QWidget *)), UBApplication::documentController(), SLOT(focusChanged(QWidget *, QWidget *)));
+
         if (Board == mMainMode)
             mMainWindow->actionDuplicate->setEnabled(true);
     }
 
     UBApplication::boardController->setToolbarTexts();
 
-    UBApplication::webController->adaptToolBar();
+    if (UBApplication::hasWebController())
+        UBApplication::webController()->adaptToolBar();
 
 }
 
@@ -393,6 +392,10 @@ void UBApplicationController::showBoard()
 
 void UBApplicationController::showInternet()
 {
+    UBWebController* webController = UBApplication::webController();
+
+    connect(webController, SIGNAL(imageCaptured(const QPixmap &, bool, const QUrl&))
+            , this, SLOT(addCapturedPixmap(const QPixmap &, bool, const QUrl&)), Qt::UniqueConnection);
 
     if (UBApplication::boardController)
     {
@@ -403,7 +406,7 @@ void UBApplicationController::showInternet()
     if (UBSettings::settings()->webUseExternalBrowser->get().toBool())
     {
         showDesktop(true);
-        UBApplication::webController->show();
+        webController->show();
     }
     else
     {
@@ -418,7 +421,7 @@ void UBApplicationController::showInternet()
         mMainWindow->show();
         mUninoteController->hideWindow();
 
-        UBApplication::webController->show();
+        webController->show();
 
         UBApplication::displayManager->adjustScreens();
 
@@ -429,6 +432,9 @@ void UBApplicationController::showInternet()
 
 void UBApplicationController::showDocument()
 {
+    // creating the document controller adds the documents widget to the main window
+    UBDocumentController* documentController = UBApplication::documentController();
+
     mMainWindow->webToolBar->hide();
     mMainWindow->boardToolBar->hide();
     UBPlatformUtils::hideMenuBarAndDock();
@@ -450,10 +456,7 @@ void UBApplicationController::showDocument()
         UBApplication::boardController->hide();
     }
 
-    if (UBApplication::documentController)
-    {
-        UBApplication::documentController->show();
-    }
+    documentController->show();
 
     mMainWindow->show();
 
@@ -678,8 +681,8 @@ void UBApplicationController::closing()
 
     /*
 
-    if (UBApplication::documentController)
-        UBApplication::documentController->closing();
+    if (UBApplication::hasDocumentController())
+        UBApplication::documentController()->closing();
 
     */
 
@@ -694,11 +697,13 @@ void UBApplicationController::showMessage(const QString& message, bool showSpinn
         if (mMainMode == Document)
         {
             UBApplication::boardController->hideMessage();
-            UBApplication::documentController->showMessage(message, showSpinningWheel);
+            UBApplication::documentController()->showMessage(message, showSpinningWheel);
         }
         else
         {
-            UBApplication::documentController->hideMessage();
+            if (UBApplication::hasDocumentController())
+                UBApplication::documentController()->hideMessage();
+
             UBApplication::boardController->showMessage(message, showSpinningWheel);
         }
     }
@@ -725,9 +730,9 @@ void UBApplicationController::importFile(const QString& pFilePath)
             UBApplication::boardController->setActiveDocumentScene(document, 0, true, true);
         }
 
-        if (UBApplication::documentController)
+        if (UBApplication::hasDocumentController())
         {
-            UBApplication::documentController->selectDocument(document, true, true);
+            UBApplication::documentController()->selectDocument(document, true, true);
         }
 
         // This import operation happens when double-clicking on a UBZ for example.
@@ -795,11 +800,11 @@ void UBApplicationController::actionCut()
         }
         else if(mMainMode == Document)
         {
-            UBApplication::documentController->cut();
+            UBApplication::documentController()->cut();
         }
         else if(mMainMode == Internet)
         {
-            UBApplication::webController->cut();
+            UBApplication::webController()->cut();
         }
     }
 }
@@ -815,11 +820,11 @@ void UBApplicationController::actionCopy()
         }
         else if(mMainMode == Document)
         {
-            UBApplication::documentController->copy();
+            UBApplication::documentController()->copy();
         }
         else if(mMainMode == Internet)
         {
-            UBApplication::webController->copy();
+            UBApplication::webController()->copy();
         }
     }
 }
@@ -835,11 +840,11 @@ void UBApplicationController::actionPaste()
         }
         else if (mMainMode == Document)
         {
-            UBApplication::documentController->paste();
+            UBApplication::documentController()->paste();
         }
         else if(mMainMode == Internet)
         {
-            UBApplication::webController->paste();
+            UBApplication::webController()->paste();
         }
     }
 }
@@ -93,7 +93,7 @@ void UBAsyncLocalFileDownloader::run()
             QFile::remove(mTo);
     }
     else
-        emit signal_asyncCopyFinished(mDesc.id, !mTo.isEmpty(), QUrl::fromLocalFile(mTo), QUrl::fromLocalFile(mDesc.originalSrcUrl), "", NULL, mDesc.pos, mDesc.size, mDesc.isBackground);
+        emit signal_asyncCopyFinished(mDesc.id, !mTo.isEmpty(), QUrl::fromLocalFile(mTo), QUrl::fromLocalFile(mDesc.originalSrcUrl), "", QString(), mDesc.pos, mDesc.size, mDesc.isBackground);
 }
 
 void UBAsyncLocalFileDownloader::abort()
@@ -275,7 +275,7 @@ void UBDownloadManager::onDownloadProgress(int id, qint64 received, qint64 total
  * @param desc as the current downloaded file description
  */
 
-void UBDownloadManager::onDownloadFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground)
+void UBDownloadManager::onDownloadFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground)
 {
 //    Temporary data for dnd do not delete it please
     Q_UNUSED(pPos)
@@ -289,21 +289,25 @@ void UBDownloadManager::onDownloadFinished(int id, bool pSuccess, QUrl sourceUrl
         {
             if (desc.dest == sDownloadFileDesc::graphicsWidget) {
                 desc.contentTypeHeader = pContentTypeHeader;
-                emit downloadFinished(pSuccess, desc, pData);
+                emit downloadFinished(pSuccess, desc, pLocalFile);
 
             } else if(desc.dest == sDownloadFileDesc::board) {
                 // The downloaded file is modal so we must put it on the board
-                emit addDownloadedFileToBoard(pSuccess, sourceUrl, contentUrl, pContentTypeHeader, pData, pPos, pSize, isBackground);
+                emit addDownloadedFileToBoard(pSuccess, sourceUrl, contentUrl, pContentTypeHeader, pLocalFile, pPos, pSize, isBackground);
             }
             else
             {
-                emit addDownloadedFileToLibrary(pSuccess, sourceUrl, pContentTypeHeader, pData, desc.name);
+                emit addDownloadedFileToLibrary(pSuccess, sourceUrl, pContentTypeHeader, pLocalFile, desc.name);
             }
 
             break;
         }
     }
 
+    // The consumers copied what they needed, the temporary download is no longer useful
+    if (!pLocalFile.isEmpty() && QFile::exists(pLocalFile))
+        QFile::remove(pLocalFile);
+
     // Then do this
     updateFileCurrentSize(id);
 }
@@ -387,7 +391,7 @@ void UBDownloadManager::startFileDownload(sDownloadFileDesc desc)
     if (desc.srcUrl.startsWith("file://") || desc.srcUrl.startsWith("/"))
     {
         UBAsyncLocalFileDownloader * cpHelper = new UBAsyncLocalFileDownloader(desc, this);
-        connect(cpHelper, SIGNAL(signal_asyncCopyFinished(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)), this, SLOT(onDownloadFinished(int, bool, QUrl, QUrl,QString, QByteArray, QPointF, QSize, bool)));
+        connect(cpHelper, SIGNAL(signal_asyncCopyFinished(int, bool, QUrl, QUrl, QString, QString, QPointF, QSize, bool)), this, SLOT(onDownloadFinished(int, bool, QUrl, QUrl,QString, QString, QPointF, QSize, bool)));
         QObject *res = dynamic_cast<QObject *>(cpHelper->download());
         if (!res)
             delete res;
@@ -398,10 +402,13 @@ void UBDownloadManager::startFileDownload(sDownloadFileDesc desc)
     {    
         UBDownloadHttpFile* http = new UBDownloadHttpFile(desc.id, this);
         connect(http, SIGNAL(downloadProgress(int, qint64,qint64)), this, SLOT(onDownloadProgress(int,qint64,qint64)));
-        connect(http, SIGNAL(downloadFinished(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)), this, SLOT(onDownloadFinished(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)));
+        connect(http, SIGNAL(downloadFinished(int, bool, QUrl, QUrl, QString, QString, QPointF, QSize, bool)), this, SLOT(onDownloadFinished(int, bool, QUrl, QUrl, QString, QString, QPointF, QSize, bool)));
     
         //the desc.srcUrl is encoded. So we have to decode it before.
         QUrl url = QUrl::fromEncoded(desc.srcUrl.toUtf8());
+
+        // The content is streamed to disk, so that big media never have to fit in memory
+        http->setDestinationFile(UBDownloadHttpFile::temporaryFilePath(url));
         // We send here the request and store its reply in order to be able to cancel it if needed
         mDownloads[desc.id] = dynamic_cast<QObject *>(http->get(url, desc.pos, desc.size, desc.isBackground));
     } 
@@ -569,6 +576,22 @@ UBDownloadHttpFile::~UBDownloadHttpFile()
 
 }
 
+/**
+ * \brief Get a unique temporary file to stream the download of the given URL to
+ * @param url as the downloaded URL
+ * @return the path of the temporary file, keeping the file suffix of the URL
+ */
+QString UBDownloadHttpFile::temporaryFilePath(const QUrl& url)
+{
+    QString suffix = QFileInfo(url.path()).suffix();
+    QString fileName = "download-" + QUuid::createUuid().toString().remove('{').remove('}');
+
+    if (!suffix.isEmpty())
+        fileName += "." + suffix;
+
+    return UBFileSystemUtils::defaultTempDirPath() + "/downloads/" + fileName;
+}
+
 /**
  * \brief Handles the download progress notification
  * @param bytesReceived as the number of received bytes
@@ -584,14 +607,28 @@ void UBDownloadHttpFile::onDownloadProgress(qint64 bytesReceived, qint64 bytesTo
  * @param pSuccess as the success indicator
  * @param sourceUrl as the source URL
  * @param pContentTypeHeader as the response content type header
- * @param pData as the packet data
+ * @param pData as the packet data, empty as the content is streamed to the destination file
  * @param pPos as the item position in the board
  * @param psize as the item size (GUI)
  * @param isBackground as the background mdoe indicator
  */
 void UBDownloadHttpFile::onDownloadFinished(bool pSuccess, QUrl sourceUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground)
 {
+    Q_UNUSED(pData)
+
+    QString localFile = destinationFile();
+
+    if (pSuccess && !localFile.isEmpty() && QFileInfo(localFile).suffix().isEmpty())
+    {
+        // The URL did not tell the file type, so use the one of the response
+        // as the consumers rely on the suffix to handle the file
+        QString extension = UBFileSystemUtils::fileExtensionFromMimeType(pContentTypeHeader);
+
+        if (!extension.isEmpty() && QFile::rename(localFile, localFile + "." + extension))
+            localFile += "." + extension;
+    }
+
     // Notify the end of the download
-    emit downloadFinished(mId, pSuccess, sourceUrl, sourceUrl, pContentTypeHeader, pData, pPos, pSize, isBackground);
+    emit downloadFinished(mId, pSuccess, sourceUrl, sourceUrl, pContentTypeHeader, localFile, pPos, pSize, isBackground);
 }
 
@@ -89,9 +89,11 @@ public:
     UBDownloadHttpFile(int fileId, QObject* parent=0);
     ~UBDownloadHttpFile();
 
+    static QString temporaryFilePath(const QUrl& url);
+
 signals:
     void downloadProgress(int id, qint64 current,qint64 total);
-    void downloadFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground);
+    void downloadFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground);
 
 private slots:
     void onDownloadFinished(bool pSuccess, QUrl sourceUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground);
@@ -113,7 +115,7 @@ public:
 
 signals:
     void finished(QString srcUrl, QString resUrl);
-    void signal_asyncCopyFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground);
+    void signal_asyncCopyFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground);
 
 
 private:
@@ -142,18 +144,17 @@ signals:
     void fileAddedToDownload();
     void downloadUpdated(int id, qint64 crnt, qint64 total);
     void downloadFinished(int id);
-    void downloadFinished(bool pSuccess, int id, QUrl sourceUrl, QString pContentTypeHeader, QByteArray pData);
-    void downloadFinished(bool pSuccess, sDownloadFileDesc desc, QByteArray pData);
+    void downloadFinished(bool pSuccess, sDownloadFileDesc desc, QString pLocalFile);
     void downloadModalFinished();
-    void addDownloadedFileToBoard(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground);
-    void addDownloadedFileToLibrary(bool pSuccess, QUrl sourceUrl, QString pContentTypeHeader, QByteArray pData, QString pTitle);
+    void addDownloadedFileToBoard(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground);
+    void addDownloadedFileToLibrary(bool pSuccess, QUrl sourceUrl, QString pContentTypeHeader, QString pLocalFile, QString pTitle);
     void cancelAllDownloads();
     void allDownloadsFinished();
 
 private slots:
     void onUpdateDownloadLists();
     void onDownloadProgress(int id, qint64 received, qint64 total);
-    void onDownloadFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground);
+    void onDownloadFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground);
 
 private:
     void init();
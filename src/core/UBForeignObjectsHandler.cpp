@@ -30,6 +30,8 @@
 #include <QtXml>
 #include "UBSettings.h"
 
+#include "adaptors/UBSvgSubsetAdaptor.h"
+
 const QString tVideo = "video";
 const QString tAudio = "audio";
 const QString tImage = "image";
@@ -168,25 +170,18 @@ static QDomDocument createDomFromSvg(const QString &svgUrl)
 
     if (QFileInfo(mFoldersXmlStorageName).exists()) {
         QDomDocument xmlDom;
-        QFile inFile(mFoldersXmlStorageName);
-        if (inFile.open(QIODevice::ReadOnly)) {
-            QString domString(inFile.readAll());
-
-            int errorLine = 0; int errorColumn = 0;
-            QString errorStr;
-
-            if (xmlDom.setContent(domString, &errorStr, &errorLine, &errorColumn)) {
-                return xmlDom;
-            } else {
-                qDebug() << "Error reading content of " << mFoldersXmlStorageName << '\n'
-                         << "Error:" << inFile.errorString()
-                         << "Line:" << errorLine
-                         << "Column:" << errorColumn;
-            }
-            inFile.close();
+        QString domString(UBSvgSubsetAdaptor::readPageFile(mFoldersXmlStorageName));
+
+        int errorLine = 0; int errorColumn = 0;
+        QString errorStr;
+
+        if (xmlDom.setContent(domString, &errorStr, &errorLine, &errorColumn)) {
+            return xmlDom;
         } else {
-            qDebug() << "Error reading" << mFoldersXmlStorageName << '\n'
-                     << "Error:" << inFile.errorString();
+            qDebug() << "Error reading content of " << mFoldersXmlStorageName << '\n'
+                     << "Error:" << errorStr
+                     << "Line:" << errorLine
+                     << "Column:" << errorColumn;
         }
     }
 
@@ -38,6 +38,7 @@
 
 #include "frameworks/UBPlatformUtils.h"
 #include "frameworks/UBFileSystemUtils.h"
+#include "frameworks/UBFileOperation.h"
 
 #include "core/UBApplication.h"
 #include "core/UBSettings.h"
@@ -49,6 +50,7 @@
 #include "adaptors/UBExportPDF.h"
 #include "adaptors/UBSvgSubsetAdaptor.h"
 #include "adaptors/UBThumbnailAdaptor.h"
+#include "adaptors/UBThumbnailWriter.h"
 #include "adaptors/UBMetadataDcSubsetAdaptor.h"
 
 #include "domain/UBGraphicsMediaItem.h"
@@ -80,6 +82,9 @@ const QString UBPersistenceManager::aName = "name";
 
 UBPersistenceManager * UBPersistenceManager::sSingleton = 0;
 
+/** Time a file operation may take before its progress is shown */
+static const int sFileOperationDialogDelayMs = 300;
+
 UBPersistenceManager::UBPersistenceManager(QObject *pParent)
     : QObject(pParent)
     , mHasPurgedDocuments(false)
@@ -103,6 +108,12 @@ UBPersistenceManager::UBPersistenceManager(QObject *pParent)
     mDocumentTreeStructureModel = new UBDocumentTreeModel(this);
     createDocumentProxiesStructure();
 
+    // documents whose deletion was interrupted by closing the application
+    foreach (QFileInfo deleted, QDir(deletionDirectory()).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        deleteDirInBackground(deleted.absoluteFilePath());
+    }
+
     mThread = new QThread;
     mWorker = new UBPersistenceWorker();
     mWorker->moveToThread(mThread);
@@ -287,7 +298,8 @@ QDialog::DialogCode UBPersistenceManager::processInteractiveReplacementDialog(st
 {
     QDialog::DialogCode result = QDialog::Rejected;
 
-    if (UBApplication::documentController && UBApplication::documentController->mainWidget())
+    // GUI mode; the document controller only exists once the Documents mode was opened
+    if (UBApplication::mainWindow)
     {
         QString docGroupName = pProxy->metaData(UBSettings::documentGroupName).toString();
         QModelIndex parentIndex = mDocumentTreeStructureModel->goTo(docGroupName);
@@ -337,9 +349,9 @@ QDialog::DialogCode UBPersistenceManager::processInteractiveReplacementDialog(st
                         // create new index before trying to select it (if avtive index)
                         mDocumentTreeStructureModel->addDocument(pProxy, parentIndex);
 
-                        if (UBApplication::documentController->selectedDocument() == replacedProxy)
+                        if (UBApplication::hasDocumentController() && UBApplication::documentController()->selectedDocument() == replacedProxy)
                         {
-                            UBApplication::documentController->pureSetDocument(pProxy);
+                            UBApplication::documentController()->pureSetDocument(pProxy);
                         }
 
                         if (UBApplication::boardController->selectedDocument() == replacedProxy)
@@ -398,9 +410,9 @@ QDialog::DialogCode UBPersistenceManager::processInteractiveReplacementDialog(st
                         // create new index before trying to select it (if avtive index)
                         mDocumentTreeStructureModel->addDocument(pProxy, parentIndex);
 
-                        if (UBApplication::documentController->selectedDocument() == replacedProxy)
+                        if (UBApplication::hasDocumentController() && UBApplication::documentController()->selectedDocument() == replacedProxy)
                         {
-                            UBApplication::documentController->pureSetDocument(pProxy);
+                            UBApplication::documentController()->pureSetDocument(pProxy);
                         }
 
                         if (UBApplication::boardController->selectedDocument() == replacedProxy)
@@ -717,8 +729,23 @@ void UBPersistenceManager::deleteDocument(std::shared_ptr<UBDocumentProxy> pDocu
     qWarning() << "deleting dir with path: " << pDocumentProxy->persistencePath();
     checkIfDocumentRepositoryExists();
 
+    // no pending thumbnail may be written to the deleted folder later
+    UBThumbnailWriter::writer()->flush();
+
     if (QFileInfo(pDocumentProxy->persistencePath()).exists())
-        UBFileSystemUtils::deleteDir(pDocumentProxy->persistencePath());
+    {
+        // move the folder out of the repository at once, so that a document deleted partially
+        // is not found again at the next start, then delete its files in the background
+        QString path = pDocumentProxy->persistencePath();
+        QString deletedPath = deletionDirectory() + "/" + QUuid::createUuid().toString().remove('{').remove('}');
+
+        if (QDir().mkpath(deletionDirectory()) && QDir().rename(path, deletedPath))
+        {
+            path = deletedPath;
+        }
+
+        deleteDirInBackground(path);
+    }
 
     mSceneCache.removeAllScenes(pDocumentProxy);
 }
@@ -731,7 +758,16 @@ std::shared_ptr<UBDocumentProxy> UBPersistenceManager::duplicateDocument(std::sh
 
     generatePathIfNeeded(copy);
 
-    UBFileSystemUtils::copyDir(pDocumentProxy->persistencePath(), copy->persistencePath());
+    UBThumbnailWriter::writer()->flush();
+
+    UBFileOperation* copyOperation = UBFileOperation::copyDir(pDocumentProxy->persistencePath(), copy->persistencePath());
+    QString documentName = pDocumentProxy->metaData(UBSettings::documentName).toString();
+
+    if (!waitForFileOperation(copyOperation, tr("Duplicating document %1").arg(documentName)))
+    {
+        deleteDirInBackground(copy->persistencePath());
+        return nullptr;
+    }
 
     // regenerate scenes UUIDs
     for(int i = 0; i < pDocumentProxy->pageCount(); i++)
@@ -764,6 +800,9 @@ void UBPersistenceManager::deleteDocumentScenes(std::shared_ptr<UBDocumentProxy>
 {
     checkIfDocumentRepositoryExists();
 
+    // pending thumbnails must be written before their files are moved
+    UBThumbnailWriter::writer()->flush();
+
     int pageCount = proxy->pageCount();
 
     QList<int> compactedIndexes;
@@ -786,6 +825,9 @@ void UBPersistenceManager::deleteDocumentScenes(std::shared_ptr<UBDocumentProxy>
     QString sourceName = proxy->metaData(UBSettings::documentName).toString();
     std::shared_ptr<UBDocumentProxy> trashDocProxy = createDocument(UBSettings::trashedDocumentGroupNamePrefix/* + sourceGroupName*/, sourceName, false);
 
+    QList<std::shared_ptr<UBGraphicsScene>> trashedScenes;
+    QList<QPair<QString, QString>> trashedFiles;
+
     foreach(int index, compactedIndexes)
     {
         std::shared_ptr<UBGraphicsScene> scene = loadDocumentScene(proxy, index);
@@ -797,16 +839,25 @@ void UBPersistenceManager::deleteDocumentScenes(std::shared_ptr<UBDocumentProxy>
                 QString source = scene->document()->persistencePath() + "/" + relativeFile.toString();
                 QString target = trashDocProxy->persistencePath() + "/" + relativeFile.toString();
 
-                QFileInfo fi(target);
-                QDir d = fi.dir();
-
-                d.mkpath(d.absolutePath());
-                QFile::copy(source, target);
+                // a missing file must not stop copying the others
+                if (QFileInfo::exists(source))
+                {
+                    trashedFiles << qMakePair(source, target);
+                }
             }
-            insertDocumentSceneAt(trashDocProxy, scene, trashDocProxy->pageCount(), true, true);
+
+            trashedScenes << scene;
         }
     }
 
+    // the media of all pages are copied together, on the I/O threads
+    waitForFileOperation(UBFileOperation::copyFiles(trashedFiles), tr("Moving pages to the trash"), false);
+
+    foreach(std::shared_ptr<UBGraphicsScene> scene, trashedScenes)
+    {
+        insertDocumentSceneAt(trashDocProxy, scene, trashDocProxy->pageCount(), true, true);
+    }
+
     for (int i = 1; i < indexes.size(); i++)
     {
         renamePage(trashDocProxy, i , i - 1);
@@ -962,6 +1013,7 @@ void UBPersistenceManager::copyDocumentScene(std::shared_ptr<UBDocumentProxy> fr
     }
 
     checkIfDocumentRepositoryExists();
+    UBThumbnailWriter::writer()->flush();
 
     for (int i = to->pageCount(); i > toIndex; i--) {
         renamePage(to, i - 1, i);
@@ -983,8 +1035,11 @@ void UBPersistenceManager::copyDocumentScene(std::shared_ptr<UBDocumentProxy> fr
     Q_ASSERT(QFileInfo(thumbTmp).exists());
     Q_ASSERT(QFileInfo(thumbTo).exists());
     auto pix = std::make_shared<QPixmap>(thumbTmp);
-    UBDocumentController *ctrl = UBApplication::documentController;
-    ctrl->TreeViewSelectionChanged(ctrl->firstSelectedTreeIndex(), QModelIndex());
+    if (UBApplication::hasDocumentController())
+    {
+        UBDocumentController *ctrl = UBApplication::documentController();
+        ctrl->TreeViewSelectionChanged(ctrl->firstSelectedTreeIndex(), QModelIndex());
+    }
 }
 
 
@@ -1041,6 +1096,7 @@ void UBPersistenceManager::insertDocumentSceneAt(std::shared_ptr<UBDocumentProxy
 void UBPersistenceManager::moveSceneToIndex(std::shared_ptr<UBDocumentProxy> proxy, int source, int target)
 {
     checkIfDocumentRepositoryExists();
+    UBThumbnailWriter::writer()->flush();
 
     if (source == target)
         return;
@@ -1055,6 +1111,7 @@ void UBPersistenceManager::moveSceneToIndex(std::shared_ptr<UBDocumentProxy> pro
     }
 
     QFile svgTmp(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", source));
+    UBSvgSubsetAdaptor::forgetPageHeader(svgTmp.fileName());
     svgTmp.rename(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.tmp", target));
 
     QFile thumbTmp(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", source));
@@ -1077,6 +1134,7 @@ void UBPersistenceManager::moveSceneToIndex(std::shared_ptr<UBDocumentProxy> pro
 
     QFile svg(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.tmp", target));
     svg.rename(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", target));
+    UBSvgSubsetAdaptor::forgetPageHeader(svg.fileName());
 
     QFile thumb(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.tmp", target));
     thumb.rename(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", target));
@@ -1085,10 +1143,15 @@ void UBPersistenceManager::moveSceneToIndex(std::shared_ptr<UBDocumentProxy> pro
 }
 
 
-std::shared_ptr<UBGraphicsScene> UBPersistenceManager::loadDocumentScene(std::shared_ptr<UBDocumentProxy> proxy, int sceneIndex, bool cacheNeighboringScenes)
+/**
+ * @brief Load the scene of a page, using the cache
+ * @param visibleFirst If true, a huge page may be returned once its visible part is loaded, the
+ * rest being loaded in the background; the scene is completed before being persisted.
+ */
+std::shared_ptr<UBGraphicsScene> UBPersistenceManager::loadDocumentScene(std::shared_ptr<UBDocumentProxy> proxy, int sceneIndex, bool cacheNeighboringScenes, bool visibleFirst)
 {
     mSceneCache.prepareLoading(proxy, sceneIndex);
-    auto scene = mSceneCache.value(proxy, sceneIndex);
+    auto scene = visibleFirst ? mSceneCache.visibleValue(proxy, sceneIndex) : mSceneCache.value(proxy, sceneIndex);
     qDebug() << "loadDocumentScene: got result from cache";
 
     if (cacheNeighboringScenes)
@@ -1106,8 +1169,11 @@ std::shared_ptr<UBGraphicsScene> UBPersistenceManager::loadDocumentScene(std::sh
     return scene;
 }
 
-std::shared_ptr<UBGraphicsScene> UBPersistenceManager::getDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex)
+std::shared_ptr<UBGraphicsScene> UBPersistenceManager::getDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex, bool visibleFirst)
 {
+    if (visibleFirst)
+        return mSceneCache.visibleValue(pDocumentProxy, sceneIndex);
+
     return mSceneCache.value(pDocumentProxy, sceneIndex);
 }
 
@@ -1116,10 +1182,21 @@ void UBPersistenceManager::reassignDocProxy(std::shared_ptr<UBDocumentProxy> new
     return mSceneCache.reassignDocProxy(newDocument, oldDocument);
 }
 
+/**
+ * @brief Read the rest of a page shown while it was loading, before an operation on the whole page
+ */
+void UBPersistenceManager::completeSceneLoading(std::shared_ptr<UBGraphicsScene> pScene)
+{
+    mSceneCache.completeLoading(pScene);
+}
+
 void UBPersistenceManager::persistDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, std::shared_ptr<UBGraphicsScene> pScene, const int pSceneIndex, bool isAnAutomaticBackup, bool forceImmediateSaving)
 {
     checkIfDocumentRepositoryExists();
 
+    // a page shown while it was loading must be complete before it is written
+    mSceneCache.completeLoading(pScene);
+
     if (!isAnAutomaticBackup)
         pScene->deselectAllItems();
 
@@ -1170,8 +1247,12 @@ std::shared_ptr<UBDocumentProxy> UBPersistenceManager::persistDocumentMetadata(s
 void UBPersistenceManager::renamePage(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const int sourceIndex, const int targetIndex)
 {
     UBApplication::showMessage(tr("Renaming pages (%1/%2)").arg(sourceIndex).arg(pDocumentProxy->pageCount()));
+    UBThumbnailWriter::writer()->flush();
+
     QFile svg(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", sourceIndex));
+    UBSvgSubsetAdaptor::forgetPageHeader(svg.fileName());
     svg.rename(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",  targetIndex));
+    UBSvgSubsetAdaptor::forgetPageHeader(svg.fileName());
 
     QFile thumb(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", sourceIndex));
     thumb.rename(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", targetIndex));
@@ -1180,8 +1261,13 @@ void UBPersistenceManager::renamePage(std::shared_ptr<UBDocumentProxy> pDocument
 
 void UBPersistenceManager::copyPage(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const int sourceIndex, const int targetIndex)
 {
+    UBThumbnailWriter::writer()->flush();
+
     QFile svg(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",sourceIndex));
-    svg.copy(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", targetIndex));
+    const QString targetFileName = pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", targetIndex);
+    svg.copy(targetFileName);
+    UBSvgSubsetAdaptor::forgetPageHeader(svg.fileName());
+    UBSvgSubsetAdaptor::forgetPageHeader(targetFileName);
 
     UBSvgSubsetAdaptor::setSceneUuid(pDocumentProxy, targetIndex, QUuid::createUuid());
 
@@ -1258,6 +1344,8 @@ bool UBPersistenceManager::addDirectoryContentToDocument(const QString& document
     if (sourceScenes.empty())
         return false;
 
+    UBThumbnailWriter::writer()->flush();
+
     int targetPageCount = pDocument->pageCount();
 
     for(int sourceIndex = 0 ; sourceIndex < sourceScenes.size(); sourceIndex++)
@@ -1478,11 +1566,11 @@ void UBPersistenceManager::cleanupDocument(std::shared_ptr<UBDocumentProxy> pDoc
 
         for (const QString& page : pages)
         {
-            QFile svgFile(path + page);
+            // pages may be compressed
+            const QString content = UBSvgSubsetAdaptor::readPageFile(path + page);
 
-            if (svgFile.open(QFile::ReadOnly))
+            if (!content.isEmpty())
             {
-                const QString content = svgFile.readAll();
                 auto matches = uuidPattern.globalMatch(content);
 
                 while (matches.hasNext())
@@ -1531,6 +1619,69 @@ void UBPersistenceManager::cleanupDocument(std::shared_ptr<UBDocumentProxy> pDoc
     }
 }
 
+/**
+ * @brief Wait for a file operation and delete it, returns whether it was successful
+ *
+ * A progress dialog, optionally allowing to cancel the operation, is shown when it takes longer.
+ */
+bool UBPersistenceManager::waitForFileOperation(UBFileOperation* operation, const QString& label, bool cancelable)
+{
+    if (!operation->wait(sFileOperationDialogDelayMs))
+    {
+        mProgress.setLabelText(label);
+        mProgress.setRange(0, 0);
+
+        if (cancelable)
+        {
+            mProgress.setCancelButtonText(tr("Cancel"));
+        }
+        else
+        {
+            mProgress.setCancelButton(nullptr);
+        }
+
+        connect(operation, &UBFileOperation::progress, &mProgress, [this](int done, int total){
+            mProgress.setRange(0, total);
+            mProgress.setValue(done);
+        });
+        connect(operation, &UBFileOperation::finished, &mProgress, &QProgressDialog::reset);
+        connect(&mProgress, &QProgressDialog::canceled, operation, &UBFileOperation::cancel);
+
+        // the finished signal may have been emitted before it was connected
+        if (!operation->wait(0))
+        {
+            mProgress.exec();
+        }
+
+        operation->wait();
+
+        // deliver the last progress signals before the dialog is reset
+        QCoreApplication::sendPostedEvents(&mProgress, QEvent::MetaCall);
+        mProgress.reset();
+    }
+
+    bool success = operation->isSuccessful();
+    delete operation;
+    return success;
+}
+
+/**
+ * @brief Delete a directory without waiting, the operation is canceled when closing
+ */
+void UBPersistenceManager::deleteDirInBackground(const QString& path)
+{
+    UBFileOperation* operation = UBFileOperation::deleteDir(path, this);
+    connect(operation, &UBFileOperation::finished, operation, &QObject::deleteLater);
+}
+
+/**
+ * @brief Directory collecting the deleted documents until their files are deleted
+ */
+QString UBPersistenceManager::deletionDirectory() const
+{
+    return QFileInfo(mDocumentRepositoryPath).absolutePath() + "/deleted";
+}
+
 bool UBPersistenceManager::mayHaveVideo(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
 {
     QDir videoDir(pDocumentProxy->persistencePath() + "/" + UBPersistenceManager::videoDirectory);
@@ -41,6 +41,7 @@ class UBDocumentProxy;
 class UBGraphicsScene;
 class UBDocumentTreeNode;
 class UBDocumentTreeModel;
+class UBFileOperation;
 
 class UBPersistenceManager : public QObject
 {
@@ -112,9 +113,10 @@ class UBPersistenceManager : public QObject
 
         virtual void moveSceneToIndex(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int source, int target);
 
-        virtual std::shared_ptr<UBGraphicsScene> loadDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex, bool cacheNeighboringScenes = true);
-        std::shared_ptr<UBGraphicsScene> getDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex);
+        virtual std::shared_ptr<UBGraphicsScene> loadDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex, bool cacheNeighboringScenes = true, bool visibleFirst = false);
+        std::shared_ptr<UBGraphicsScene> getDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex, bool visibleFirst = false);
         void reassignDocProxy(std::shared_ptr<UBDocumentProxy> newDocument, std::shared_ptr<UBDocumentProxy> oldDocument);
+        void completeSceneLoading(std::shared_ptr<UBGraphicsScene> pScene);
 
 //        QList<QPointer<UBDocumentProxy> > documentProxies;
         UBDocumentTreeNode *mDocumentTreeStructure;
@@ -182,6 +184,10 @@ private:
 
         void cleanupDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy) const;
 
+        bool waitForFileOperation(UBFileOperation* operation, const QString& label, bool cancelable = true);
+        void deleteDirInBackground(const QString& path);
+        QString deletionDirectory() const;
+
         QString xmlFolderStructureFilename;
 
         UBSceneCache mSceneCache;
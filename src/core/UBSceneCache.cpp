@@ -33,13 +33,21 @@
 #include <adaptors/UBSvgSubsetAdaptor.h>
 
 #include "core/UBApplication.h"
+#include "core/UBSceneReclaimer.h"
 #include "core/UBSettings.h"
 #include "core/UBSetting.h"
 
 #include "document/UBDocumentProxy.h"
+#include "frameworks/UBTrace.h"
 
 #include "core/memcheck.h"
 
+/** Time spent reading a page in the background before giving control back to the event loop */
+static const int sLoadingSliceMs = 10;
+
+/** Size of the rect loaded first, relative to the page size visible at the last zoom factor */
+static const qreal sVisibleMargin = 1.5;
+
 UBSceneCache::UBSceneCache()
 {
     // NOOP
@@ -65,9 +73,12 @@ std::shared_ptr<UBGraphicsScene> UBSceneCache::prepareLoading(std::shared_ptr<UB
 {
     if (mSceneCache.contains({proxy, pageIndex}))
     {
+        UBTrace::instant("scene cache hit");
         return value(proxy, pageIndex);
     }
 
+    UBTrace::instant("scene cache miss");
+
     // no entry in cache; create a cache entry to load scene
     qDebug() << "Preparing to load scene" << pageIndex;
     auto cacheEntry = std::make_shared<SceneCacheEntry>(proxy, pageIndex);
@@ -87,7 +98,7 @@ void UBSceneCache::insert (std::shared_ptr<UBDocumentProxy> proxy, int pageIndex
     {
         auto entry = mSceneCache.value(key);
 
-        if (entry->isSceneAvailable() && entry->scene() == scene)
+        if (entry->isSceneAvailable() && entry->loadedScene() == scene)
         {
             mSceneCache.remove(key);
             mCachedKeyFIFO.removeAll(key);
@@ -111,6 +122,48 @@ bool UBSceneCache::contains(std::shared_ptr<UBDocumentProxy> proxy, int pageInde
 }
 
 
+/**
+ * @brief Return the scene of a page, possibly before it is completely loaded
+ *
+ * A huge page is loaded progressively: only the elements visible in the view last used for
+ * the page are read before returning, the others are read in the background. Use value() to
+ * get a complete scene.
+ */
+std::shared_ptr<UBGraphicsScene> UBSceneCache::visibleValue(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex)
+{
+    UBSceneCacheID key{proxy, pageIndex};
+
+    if (mSceneCache.contains(key))
+    {
+        auto entry = mSceneCache.value(key);
+
+        mCachedKeyFIFO.removeAll(key);
+        mCachedKeyFIFO.enqueue(key);
+
+        return entry->visibleScene(mViewStates.value(key));
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+
+/**
+ * @brief Finish loading a scene returned by visibleValue(), e.g. before persisting it
+ */
+void UBSceneCache::completeLoading(std::shared_ptr<UBGraphicsScene> scene)
+{
+    for (const auto& entry : std::as_const(mSceneCache))
+    {
+        if (entry->isLoading() && entry->loadedScene() == scene)
+        {
+            entry->scene();
+        }
+    }
+}
+
+
 std::shared_ptr<UBGraphicsScene> UBSceneCache::value(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex)
 {
     UBSceneCacheID key{proxy, pageIndex};
@@ -142,14 +195,14 @@ void UBSceneCache::removeScene(std::shared_ptr<UBDocumentProxy> proxy, int pageI
 
     auto entry = mSceneCache.value(key);
 
-    if (!entry->isSceneAvailable() || !entry->scene()->isActive())
+    if (!entry->isSceneAvailable() || !entry->loadedScene()->isActive())
     {
         int count = mSceneCache.remove(key);
         mCachedKeyFIFO.removeAll(key);
 
         if (entry->isSceneAvailable())
         {
-            mViewStates.insert(key, entry->scene()->viewState());
+            mViewStates.insert(key, entry->loadedScene()->viewState());
         }
     }
 }
@@ -225,7 +278,7 @@ void UBSceneCache::reassignDocProxy(std::shared_ptr<UBDocumentProxy> newDocument
 
         if (entry->isSceneAvailable())
         {
-            entry->scene()->setDocument(newDocument);
+            entry->loadedScene()->setDocument(newDocument);
         }
 
         mCachedKeyFIFO.removeAll(sourceKey);
@@ -281,14 +334,14 @@ void UBSceneCache::insertEntry(UBSceneCacheID key, std::shared_ptr<SceneCacheEnt
     // remove LRU entries if cache size grows beyond limit
     auto entries = mCachedKeyFIFO.size();
 
-    while (entries-- > UBSettings::settings()->pageCacheSize->get().toInt())
+    while (entries-- > UBSettings::settings()->snapshot().pageCacheSize)
     {
         qDebug() << "cache full, size" << entries;
         const auto key = mCachedKeyFIFO.dequeue();
         auto entry = mSceneCache.value(key);
 
         // remove if still loading or inactive
-        if ((entry->isSceneAvailable() && !entry->scene()->isActive())
+        if ((entry->isSceneAvailable() && !entry->loadedScene()->isActive())
                 || !entry->isSceneAvailable())
         {
             qDebug() << "removing page" << key.pageIndex << "of" << key.documentProxy->documentFolderName();
@@ -316,6 +369,12 @@ UBSceneCache::SceneCacheEntry::~SceneCacheEntry()
     {
         delete mTimer;
     }
+
+    // tear down dropped scenes in the background
+    if (mScene)
+    {
+        UBSceneReclaimer::reclaimer()->reclaim(std::move(mScene));
+    }
 }
 
 void UBSceneCache::SceneCacheEntry::startLoading()
@@ -331,7 +390,15 @@ void UBSceneCache::SceneCacheEntry::startLoading()
 
         if (mContext)
         {
-            mContext->step();
+            // read elements for a slice of time, so that huge pages still load in a reasonable time
+            QElapsedTimer slice;
+            slice.start();
+
+            do
+            {
+                mContext->step();
+            }
+            while (!mContext->isFinished() && slice.elapsed() < sLoadingSliceMs);
 
             if (mContext->isFinished())
             {
@@ -352,9 +419,19 @@ bool UBSceneCache::SceneCacheEntry::isSceneAvailable() const
     return mScene != nullptr;
 }
 
+bool UBSceneCache::SceneCacheEntry::isLoading() const
+{
+    return mContext != nullptr;
+}
+
+std::shared_ptr<UBGraphicsScene> UBSceneCache::SceneCacheEntry::loadedScene() const
+{
+    return mScene;
+}
+
 std::shared_ptr<UBGraphicsScene> UBSceneCache::SceneCacheEntry::scene()
 {
-    if (mContext && !mScene)
+    if (mContext)
     {
         // finish loading
         if (mTimer)
@@ -375,3 +452,34 @@ std::shared_ptr<UBGraphicsScene> UBSceneCache::SceneCacheEntry::scene()
 
     return mScene;
 }
+
+std::shared_ptr<UBGraphicsScene> UBSceneCache::SceneCacheEntry::visibleScene(const UBGraphicsScene::SceneViewState& viewState)
+{
+    if (!mContext || !mContext->isProgressive())
+    {
+        return scene();
+    }
+
+    if (!mScene)
+    {
+        auto partialScene = mContext->partialScene();
+        QSize nominalSize = partialScene->nominalSize();
+
+        if (!nominalSize.isValid())
+            nominalSize = UBSettings::settings()->pageSize->get().toSize();
+
+        // the view shows about the nominal page size at the last zoom factor, with some margin
+        QSizeF visibleSize = QSizeF(nominalSize) * sVisibleMargin / qMax(viewState.zoomFactor, qreal(0.01));
+        QRectF visibleRect(viewState.mLastSceneCenter - QPointF(visibleSize.width(), visibleSize.height()) / 2, visibleSize);
+
+        mContext->loadRegion(visibleRect);
+
+        // the partial page is shown and editable, edits made while the rest is read must be undoable
+        partialScene->enableUndoRedoStack();
+
+        // the rest of the page is read by the loading timer
+        mScene = partialScene;
+    }
+
+    return mScene;
+}
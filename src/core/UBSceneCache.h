@@ -90,6 +90,10 @@ public:
 
     std::shared_ptr<UBGraphicsScene> value(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex);
 
+    std::shared_ptr<UBGraphicsScene> visibleValue(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex);
+
+    void completeLoading(std::shared_ptr<UBGraphicsScene> scene);
+
     void removeScene(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex);
 
     void removeAllScenes(std::shared_ptr<UBDocumentProxy> proxy);
@@ -110,7 +114,10 @@ private:
         ~SceneCacheEntry();
         void startLoading();
         bool isSceneAvailable() const;
+        bool isLoading() const;
+        std::shared_ptr<UBGraphicsScene> loadedScene() const;
         std::shared_ptr<UBGraphicsScene> scene();
+        std::shared_ptr<UBGraphicsScene> visibleScene(const UBGraphicsScene::SceneViewState& viewState);
 
     private:
         std::shared_ptr<UBSvgSubsetAdaptor::UBSvgReaderContext> mContext = nullptr;
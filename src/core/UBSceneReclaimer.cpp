@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBSceneReclaimer.h"
+
+#include <QElapsedTimer>
+
+#include "core/UBApplication.h"
+#include "domain/UBGraphicsScene.h"
+
+#include "core/memcheck.h"
+
+UBSceneReclaimer* UBSceneReclaimer::sReclaimer = nullptr;
+
+/** Time spent deleting items at each idle step */
+static const qint64 sStepBudgetMs = 4;
+
+/** Items deleted between two checks of the time budget */
+static const int sItemsPerCheck = 32;
+
+UBSceneReclaimer* UBSceneReclaimer::reclaimer()
+{
+    if (!sReclaimer)
+    {
+        sReclaimer = new UBSceneReclaimer();
+    }
+
+    return sReclaimer;
+}
+
+void UBSceneReclaimer::destroy()
+{
+    delete sReclaimer;
+    sReclaimer = nullptr;
+}
+
+UBSceneReclaimer::UBSceneReclaimer()
+    : QObject{nullptr}
+{
+}
+
+UBSceneReclaimer::~UBSceneReclaimer()
+{
+    // remaining scenes are deleted at once
+    mTimer.stop();
+}
+
+/**
+ * @brief Take the last reference of a scene and delete it later
+ *
+ * Scenes still referenced elsewhere are left to their other owners.
+ */
+void UBSceneReclaimer::reclaim(std::shared_ptr<UBGraphicsScene> scene)
+{
+    if (!scene || scene.use_count() > 1 || UBApplication::isClosing)
+    {
+        return;
+    }
+
+    mScenes.push_back(std::move(scene));
+
+    if (!mTimer.isActive())
+    {
+        mTimer.start(0, this);
+    }
+}
+
+void UBSceneReclaimer::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != mTimer.timerId())
+    {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    while (!mScenes.empty() && elapsed.elapsed() < sStepBudgetMs)
+    {
+        if (mScenes.front()->deleteItemsStep(sItemsPerCheck))
+        {
+            // the remaining items are few, the destructor is cheap now
+            mScenes.pop_front();
+        }
+    }
+
+    if (mScenes.empty())
+    {
+        mTimer.stop();
+    }
+}
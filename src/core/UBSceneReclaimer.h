@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QBasicTimer>
+#include <QObject>
+
+#include <deque>
+#include <memory>
+
+class UBGraphicsScene;
+
+/**
+ * Deletes the scenes dropped from the scene cache in small steps.
+ *
+ * Deleting a page with many strokes takes long, as each item is removed from the scene
+ * and deleted. The reclaimer keeps the last reference of such scenes and deletes their
+ * items a few at a time, whenever the event loop is idle, so that the GUI thread is
+ * never blocked for more than a few milliseconds.
+ */
+class UBSceneReclaimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static UBSceneReclaimer* reclaimer();
+    static void destroy();
+
+    void reclaim(std::shared_ptr<UBGraphicsScene> scene);
+
+protected:
+    virtual void timerEvent(QTimerEvent* event) override;
+
+private:
+    UBSceneReclaimer();
+    virtual ~UBSceneReclaimer();
+
+    static UBSceneReclaimer* sReclaimer;
+
+    std::deque<std::shared_ptr<UBGraphicsScene>> mScenes{};
+    QBasicTimer mTimer{};
+};
@@ -195,6 +195,13 @@ UBSettings::UBSettings(QObject *parent)
 
 UBSettings::~UBSettings()
 {
+#ifdef UB_PROFILING
+    dumpReadStatistics();
+#endif
+
+    delete mSnapshot.loadAcquire();
+    qDeleteAll(mRetiredSnapshots);
+
     delete mAppSettings;
 
     if(supportedKeyboardSizes)
@@ -270,6 +277,8 @@ void UBSettings::init()
 
     appStartMode = new UBSetting(this, "App", "StartMode", "");
     appRunInWindow = new UBSetting(this, "App", "RunInWindow", false);
+    // record a performance trace from startup, it can also be toggled with Ctrl+Alt+Shift+T
+    appPerformanceTrace = new UBSetting(this, "App", "PerformanceTrace", false);
 
     featureSliderPosition = new UBSetting(this, "Board", "FeatureSliderPosition", 40);
 
@@ -288,11 +297,14 @@ void UBSettings::init()
 
     boardInterpolatePenStrokes = new UBSetting(this, "Board", "InterpolatePenStrokes", true);
     boardSimplifyPenStrokes = new UBSetting(this, "Board", "SimplifyPenStrokes", true);
-    boardSimplifyPenStrokesThresholdAngle = new UBSetting(this, "Board", "SimplifyPenStrokesThresholdAngle", 2);
-    boardSimplifyPenStrokesThresholdWidthDifference = new UBSetting(this, "Board", "SimplifyPenStrokesThresholdWidthDifference", 2.0);
+    // in screen pixels while drawing, in scene units when simplifying strokes of loaded pages
+    boardSimplifyPenStrokesTolerance = new UBSetting(this, "Board", "SimplifyPenStrokesTolerance", 0.5);
+    boardSimplifyStrokesOnLoad = new UBSetting(this, "Board", "SimplifyStrokesOnLoad", true);
 
     boardInterpolateMarkerStrokes = new UBSetting(this, "Board", "InterpolateMarkerStrokes", true);
     boardSimplifyMarkerStrokes = new UBSetting(this, "Board", "SimplifyMarkerStrokes", true);
+    // draw pen and marker strokes on an overlay of the views until pen up
+    boardWetInk = new UBSetting(this, "Board", "WetInk", true);
 
     boardKeyboardPaletteKeyBtnSize = new UBSetting(this, "Board", "KeyboardPaletteKeyBtnSize", "16x16");
     ValidateKeyboardPaletteKeyBtnSize();
@@ -301,6 +313,12 @@ void UBSettings::init()
 
     boardCrossColorDarkBackground = new UBSetting(this, "Board", "CrossColorDarkBackground", "#C8C0C0C0");
     boardCrossColorLightBackground = new UBSetting(this, "Board", "CrossColorLightBackground", "#A5E1FF");
+    // paint the background grid from a cached tile instead of drawing each line
+    boardTiledBackground = new UBSetting(this, "Board", "TiledBackground", true);
+    // number of widgets running a web page at the same time, the others show a snapshot
+    boardMaxLiveWidgets = new UBSetting(this, "Board", "MaxLiveWidgets", 8);
+    // on-screen size in pixels below which items are painted from a simplified representation, 0 for full detail
+    boardLevelOfDetailSize = new UBSetting(this, "Board", "LevelOfDetailSize", 32);
 
     QStringList gridLightBackgroundColors;
     gridLightBackgroundColors << "#000000" << "#FF0000" << "#004080" << "#008000" << "#FFDD00" << "#C87400" << "#800040" << "#008080" << "#A5E1FF";
@@ -375,6 +393,11 @@ void UBSettings::init()
 
     pageCacheSize = new UBSetting(this, "App", "PageCacheSize", 20);
 
+    // in MB, items removed by older undo commands are spilled to disk above this budget
+    undoMemoryBudget = new UBSetting(this, "App", "UndoMemoryBudget", 64);
+    // in ms, consecutive strokes or erasures within this interval are undone together, 0 to disable
+    undoCoalescingInterval = new UBSetting(this, "App", "UndoCoalescingInterval", 400);
+
     bitmapFileExtensions << "jpg" << "jpeg" <<  "png" <<  "tiff" << "tif" << "bmp" << "gif";
     vectoFileExtensions << "svg" <<  "svgz";
     imageFileExtensions << bitmapFileExtensions << vectoFileExtensions;
@@ -453,6 +476,8 @@ void UBSettings::init()
     documentSplitterLeftSize    = new UBSetting(this, "Document", "SplitterLeftSize", UBSettings::defaultSplitterLeftSize);
     documentSplitterRightSize   = new UBSetting(this, "Document", "SplitterRightSize", UBSettings::defaultSplitterRightSize);
     showBrokenDocumentWarning   = new UBSetting(this, "Document", "ShowBrokenDocumentWarning", true);
+    // gzip the page files, which versions before this one cannot read
+    documentCompressPages       = new UBSetting(this, "Document", "CompressPages", false);
     supportEmail                = new UBSetting(this, "App", "SupportEmail", "");
 
     libraryShowDetailsForLocalItems = new UBSetting(this, "Library", "ShowDetailsForLocalItems", false);
@@ -490,6 +515,44 @@ void UBSettings::init()
 
     cleanNonPersistentSettings();
     checkNewSettings();
+
+    refreshSnapshot();
+
+    QList<UBSetting*> snapshotSettings;
+    snapshotSettings << boardCrossColorDarkBackground << boardCrossColorLightBackground << boardTiledBackground << pageCacheSize
+                     << boardSimplifyPenStrokes << boardSimplifyMarkerStrokes << boardWetInk << documentCompressPages
+                     << boardSimplifyPenStrokesTolerance << boardSimplifyStrokesOnLoad << boardLevelOfDetailSize;
+
+    foreach (UBSetting* setting, snapshotSettings)
+        connect(setting, SIGNAL(changed(QVariant)), this, SLOT(refreshSnapshot()));
+}
+
+/**
+ * @brief Publish a new snapshot of the hot settings
+ *
+ * Readers get either the former or the new snapshot, never a partially updated one.
+ */
+void UBSettings::refreshSnapshot()
+{
+    UBSettingsSnapshot* snapshot = new UBSettingsSnapshot;
+
+    snapshot->crossColorDarkBackground = QColor(boardCrossColorDarkBackground->get().toString());
+    snapshot->crossColorLightBackground = QColor(boardCrossColorLightBackground->get().toString());
+    snapshot->seyesRuledBackground = isSeyesRuledBackground();
+    snapshot->tiledBackground = boardTiledBackground->get().toBool();
+    snapshot->pageCacheSize = pageCacheSize->get().toInt();
+    snapshot->simplifyPenStrokes = boardSimplifyPenStrokes->get().toBool();
+    snapshot->simplifyMarkerStrokes = boardSimplifyMarkerStrokes->get().toBool();
+    snapshot->simplifyStrokesTolerance = boardSimplifyPenStrokesTolerance->get().toReal();
+    snapshot->simplifyStrokesOnLoad = boardSimplifyStrokesOnLoad->get().toBool();
+    snapshot->levelOfDetailSize = boardLevelOfDetailSize->get().toInt();
+    snapshot->wetInk = boardWetInk->get().toBool();
+    snapshot->compressPages = documentCompressPages->get().toBool();
+
+    const UBSettingsSnapshot* previous = mSnapshot.fetchAndStoreOrdered(snapshot);
+
+    if (previous)
+        mRetiredSnapshots << previous;
 }
 
 
@@ -504,6 +567,29 @@ void UBSettings::init()
  */
 QVariant UBSettings::value ( const QString & key, const QVariant & defaultValue)
 {
+#ifdef UB_PROFILING
+    QElapsedTimer timer;
+    timer.start();
+
+    struct ReadRecorder
+    {
+        ~ReadRecorder()
+        {
+            const qint64 nsecs = timer.nsecsElapsed();
+
+            // settings are also read from worker threads
+            QMutexLocker lock(&settings->mReadStatisticsMutex);
+            ReadStatistics& statistics = settings->mReadStatistics[key];
+            statistics.count++;
+            statistics.nsecs += nsecs;
+        }
+
+        UBSettings* settings;
+        const QString& key;
+        const QElapsedTimer& timer;
+    } recorder{this, key, timer};
+#endif
+
     // Check first the settings queue, then the app settings, then the user settings.
     // If the key exists in neither of these, then defaultValue is returned.
 
@@ -857,6 +943,7 @@ void UBSettings::setPageBackground(UBPageBackground background)
 void UBSettings::setSeyesRuledBackground(bool isSeyesRuledBackground)
 {
     setValue("Board/SeyesRuledBackground", isSeyesRuledBackground);
+    refreshSnapshot();
 }
 
 void UBSettings::setPenPressureSensitive(bool sensitive)
@@ -1483,6 +1570,32 @@ void UBSettings::removeSetting(const QString &setting)
         mSettingsQueue.remove(setting);
 }
 
+#ifdef UB_PROFILING
+/**
+ * @brief Log the settings read the most often, with the time spent reading them
+ */
+void UBSettings::dumpReadStatistics() const
+{
+    QMutexLocker lock(&mReadStatisticsMutex);
+    QList<QPair<qint64, QString>> totals;
+
+    for (auto it = mReadStatistics.constBegin(); it != mReadStatistics.constEnd(); ++it)
+        totals << qMakePair(it.value().nsecs, it.key());
+
+    std::sort(totals.begin(), totals.end(), [](const QPair<qint64, QString>& a, const QPair<qint64, QString>& b) {
+        return a.first > b.first;
+    });
+
+    qDebug() << "settings read time, most expensive first:";
+
+    for (int i = 0; i < totals.size() && i < 20; ++i)
+    {
+        const ReadStatistics statistics = mReadStatistics.value(totals.at(i).second);
+        qDebug() << "   " << totals.at(i).second << statistics.count << "reads," << statistics.nsecs / 1000 << "us";
+    }
+}
+#endif
+
 void UBSettings::checkNewSettings()
 {
     /*
@@ -36,6 +36,7 @@
 
 #include "UB.h"
 #include "UBSetting.h"
+#include "UBSettingsSnapshot.h"
 
 class UBSettings : public QObject
 {
@@ -264,6 +265,7 @@ class UBSettings : public QObject
         UBSetting* appToolBarOrientationVertical;
         UBSetting* appPreferredLanguage;
         UBSetting* appRunInWindow;
+        UBSetting* appPerformanceTrace;
 
         UBSetting* appIsInSoftwareUpdateProcess;
 
@@ -290,10 +292,11 @@ class UBSettings : public QObject
 
         UBSetting* boardInterpolatePenStrokes;
         UBSetting* boardSimplifyPenStrokes;
-        UBSetting* boardSimplifyPenStrokesThresholdAngle;
-        UBSetting* boardSimplifyPenStrokesThresholdWidthDifference;
+        UBSetting* boardSimplifyPenStrokesTolerance;
+        UBSetting* boardSimplifyStrokesOnLoad;
         UBSetting* boardInterpolateMarkerStrokes;
         UBSetting* boardSimplifyMarkerStrokes;
+        UBSetting* boardWetInk;
 
         UBSetting* boardKeyboardPaletteKeyBtnSize;
 
@@ -303,6 +306,9 @@ class UBSettings : public QObject
 
         UBSetting* boardCrossColorDarkBackground;
         UBSetting* boardCrossColorLightBackground;
+        UBSetting* boardTiledBackground;
+        UBSetting* boardMaxLiveWidgets;
+        UBSetting* boardLevelOfDetailSize;
 
         UBColorListSetting* boardGridLightBackgroundColors;
         UBColorListSetting* boardGridDarkBackgroundColors;
@@ -340,6 +346,9 @@ class UBSettings : public QObject
 
         UBSetting* pageCacheSize;
 
+        UBSetting* undoMemoryBudget;
+        UBSetting* undoCoalescingInterval;
+
         UBSetting* boardZoomBase;
         UBSetting* boardZoomFactor;
 
@@ -392,6 +401,7 @@ class UBSettings : public QObject
         UBSetting* documentSplitterLeftSize;
         UBSetting* documentSplitterRightSize;
         UBSetting* showBrokenDocumentWarning;
+        UBSetting* documentCompressPages;
         UBSetting* supportEmail;
         UBSetting* imageThumbnailWidth;
         UBSetting* videoThumbnailWidth;
@@ -457,8 +467,14 @@ class UBSettings : public QObject
         QVariant value ( const QString & key, const QVariant & defaultValue = QVariant() );
         void setValue (const QString & key,const QVariant & value);
 
+        // Typed values of the hot settings, lock-free and without any lookup
+        const UBSettingsSnapshot& snapshot() const { return *mSnapshot.loadAcquire(); }
+
         void colorChanged() { emit colorContextChanged(); }
 
+    public slots:
+        void refreshSnapshot();
+
     signals:
         void colorContextChanged();
 
@@ -469,6 +485,22 @@ class UBSettings : public QObject
 
         QHash<QString, QVariant> mSettingsQueue;
 
+        QAtomicPointer<const UBSettingsSnapshot> mSnapshot;
+        // readers may still hold a reference to a former snapshot, they are released with the settings
+        QList<const UBSettingsSnapshot*> mRetiredSnapshots;
+
+#ifdef UB_PROFILING
+        struct ReadStatistics
+        {
+            qint64 count = 0;
+            qint64 nsecs = 0;
+        };
+
+        QHash<QString, ReadStatistics> mReadStatistics;
+        mutable QMutex mReadStatisticsMutex;
+        void dumpReadStatistics() const;
+#endif
+
         static const int sDefaultFontPixelSize;
         static const char *sDefaultFontFamily;
         static const char *sDefaultFontStyleName;
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QColor>
+
+/**
+ * Typed copy of the settings read in per-frame and per-event paths.
+ *
+ * UBSettings publishes a new immutable snapshot each time one of these settings
+ * changes, so that reading them is a plain member access without any string
+ * lookup or QVariant conversion, from any thread.
+ */
+struct UBSettingsSnapshot
+{
+    // background
+    QColor crossColorDarkBackground{};
+    QColor crossColorLightBackground{};
+    bool seyesRuledBackground{false};
+    bool tiledBackground{true};
+
+    // scene cache
+    int pageCacheSize{20};
+
+    // stroke simplification
+    bool simplifyPenStrokes{true};
+    bool simplifyMarkerStrokes{false};
+    qreal simplifyStrokesTolerance{0.5};
+    bool simplifyStrokesOnLoad{true};
+
+    // level of detail
+    int levelOfDetailSize{32};
+
+    // pen input
+    bool wetInk{true};
+
+    // persistence
+    bool compressPages{false};
+};
@@ -4,8 +4,10 @@ HEADERS      += src/core/UB.h \
                 src/core/UBApplication.h \
                 src/core/UBSettings.h \
                 src/core/UBSetting.h \
+                src/core/UBSettingsSnapshot.h \
                 src/core/UBPersistenceManager.h \
                 src/core/UBSceneCache.h \
+                src/core/UBSceneReclaimer.h \
                 src/core/UBPreferencesController.h \
                 src/core/UBMimeData.h \
                 src/core/UBIdleTimer.h \
@@ -25,6 +27,7 @@ SOURCES      += src/core/main.cpp \
                 src/core/UBSetting.cpp \
                 src/core/UBPersistenceManager.cpp \
                 src/core/UBSceneCache.cpp \
+                src/core/UBSceneReclaimer.cpp \
                 src/core/UBPreferencesController.cpp \
                 src/core/UBMimeData.cpp \
                 src/core/UBIdleTimer.cpp \
@@ -106,18 +106,22 @@ int main(int argc, char *argv[])
     qInstallMessageHandler(ub_message_output);
 
     bool hasProcessFlag = false;
+    bool batchExport = false;
 
     for (int i = 1; i < argc; ++i)
     {
         QString arg = QString::fromLocal8Bit(argv[i]);
 
         if (arg == "--single-process" || arg == "--process-per-site")
-         {
-             hasProcessFlag = true;
-             break;
-         }
+            hasProcessFlag = true;
+        else if (arg == "--export")
+            batchExport = true;
     }
 
+    // a batch export never shows a window and must also run without a display
+    if (batchExport && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     std::vector<const char*> argv_vector(argv, argv + argc);
 
     /*
@@ -141,6 +145,13 @@ int main(int argc, char *argv[])
     if (!logDir.exists())
         logDir.mkdir(dumpPath);
 
+    if (batchExport)
+    {
+        int result = app.execBatchExport();
+        app.cleanup();
+        return result;
+    }
+
     QString fileToOpen;
 
     if (args.size() > 2) {
@@ -134,8 +134,8 @@ void UBGraphicsItemPlayAudioAction::play()
 QStringList UBGraphicsItemPlayAudioAction::save()
 {
     //Another hack
-    if(UBApplication::documentController && UBApplication::documentController->selectedDocument()){
-        QString documentPath = UBApplication::documentController->selectedDocument()->persistencePath() + "/";
+    if(UBApplication::hasDocumentController() && UBApplication::documentController()->selectedDocument()){
+        QString documentPath = UBApplication::documentController()->selectedDocument()->persistencePath() + "/";
         return QStringList() << QString("%1").arg(eLinkToAudio) <<  mAudioPath.replace(documentPath,"");
     }
     else{
@@ -208,7 +208,7 @@ UBGraphicsItemLinkToWebPageAction::UBGraphicsItemLinkToWebPageAction(QString url
 void UBGraphicsItemLinkToWebPageAction::play()
 {
     if (mUrl.length() > 0)
-        UBApplication::webController->loadUrl(QUrl(mUrl));
+        UBApplication::webController()->loadUrl(QUrl(mUrl));
 }
 
 QStringList UBGraphicsItemLinkToWebPageAction::save()
@@ -838,6 +838,7 @@ bool UBDocumentTreeModel::removeRows(int row, int count, const QModelIndex &pare
                 }
             }
         }
+        removeFromIndexes(curChildNode);
         parentNode->removeChild(i);
 
     }
@@ -877,7 +878,17 @@ QModelIndex UBDocumentTreeModel::indexForNode(UBDocumentTreeNode *pNode) const
         return QModelIndex();
     }
 
-    return pIndexForNode(QModelIndex(), pNode);
+    // only nodes attached to this tree have an index
+    UBDocumentTreeNode *ancestor = pNode;
+    while (ancestor->parentNode()) {
+        ancestor = ancestor->parentNode();
+    }
+
+    if (ancestor != mRootNode || pNode == mRootNode) {
+        return QModelIndex();
+    }
+
+    return createIndex(pNode->parentNode()->children().indexOf(pNode), 0, pNode);
 }
 
 QPersistentModelIndex UBDocumentTreeModel::persistentIndexForNode(UBDocumentTreeNode *pNode)
@@ -887,29 +898,21 @@ QPersistentModelIndex UBDocumentTreeModel::persistentIndexForNode(UBDocumentTree
 
 std::shared_ptr<UBDocumentProxy> UBDocumentTreeModel::findDocumentByFolderName(QString folderName) const
 {
-    const auto children = mMyDocumentsNode->children();
-    for(auto&& child: children)
-    {
-        if (UBDocumentTreeNode::Catalog != child->nodeType())
-        {
-            std::shared_ptr<UBDocumentProxy> proxy = child->proxyData();
-            if (proxy)
-            {
-                if (proxy->documentFolderName() == folderName)
-                {
-                    return proxy;
-                }
-            }
-        }
-        else if (child->children().count())
-        {
-            std::shared_ptr<UBDocumentProxy> recursiveDescendResult = findDocumentByFolderName(child, folderName);
-            if (recursiveDescendResult)
-                return recursiveDescendResult;
+    UBDocumentTreeNode *node = mNodesByFolderName.value(folderName);
+    if (node && node->proxyData() && node->proxyData()->documentFolderName() == folderName && mMyDocumentsNode->findNode(node)) {
+        return node->proxyData();
+    }
+
+    // not indexed, e.g. the indexed node was a reference copy removed since
+    std::shared_ptr<UBDocumentProxy> proxy = findDocumentByFolderName(mMyDocumentsNode, folderName);
+    if (proxy) {
+        node = findProxy(proxy, mMyDocumentsNode);
+        if (node) {
+            cacheNode(node);
         }
     }
 
-    return nullptr;
+    return proxy;
 }
 
 std::shared_ptr<UBDocumentProxy> UBDocumentTreeModel::findDocumentByFolderName(UBDocumentTreeNode* node, QString folderName) const
@@ -939,6 +942,25 @@ std::shared_ptr<UBDocumentProxy> UBDocumentTreeModel::findDocumentByFolderName(U
     return nullptr;
 }
 
+UBDocumentTreeNode *UBDocumentTreeModel::findProxy(std::shared_ptr<UBDocumentProxy> pSearch) const
+{
+    if (!pSearch) {
+        return 0;
+    }
+
+    UBDocumentTreeNode *node = mNodesByPath.value(pSearch->persistencePath());
+    if (node && node->proxyData() && node->proxyData()->theSameDocument(pSearch)) {
+        return node;
+    }
+
+    node = findProxy(pSearch, mRootNode);
+    if (node) {
+        cacheNode(node);
+    }
+
+    return node;
+}
+
 UBDocumentTreeNode *UBDocumentTreeModel::findProxy(std::shared_ptr<UBDocumentProxy> pSearch, UBDocumentTreeNode *pParent) const
 {
     foreach (UBDocumentTreeNode *curNode, pParent->children())
@@ -952,29 +974,13 @@ UBDocumentTreeNode *UBDocumentTreeModel::findProxy(std::shared_ptr<UBDocumentPro
         {
             UBDocumentTreeNode *recursiveDescendResult = findProxy(pSearch, curNode);
             if (recursiveDescendResult)
-                return findProxy(pSearch, curNode);
+                return recursiveDescendResult;
         }
     }
 
     return 0;
 }
 
-QModelIndex UBDocumentTreeModel::pIndexForNode(const QModelIndex &parent, UBDocumentTreeNode *pNode) const
-{
-    for (int i = 0; i < rowCount(parent); i++) {
-        QModelIndex curIndex = index(i, 0, parent);
-        if (curIndex.internalPointer() == pNode) {
-            return curIndex;
-        } else if (rowCount(curIndex) > 0) {
-            QModelIndex recursiveDescendIndex = pIndexForNode(curIndex, pNode);
-            if (recursiveDescendIndex.isValid()) {
-                return recursiveDescendIndex;
-            }
-        }
-    }
-    return QModelIndex();
-}
-
 //N/C - NNE - 20140411
 void UBDocumentTreeModel::copyIndexToNewParent(const QModelIndexList &list, const QModelIndex &newParent, eCopyMode pMode)
 {
@@ -1007,6 +1013,12 @@ QPersistentModelIndex UBDocumentTreeModel::copyIndexToNewParent(const QModelInde
         std::shared_ptr<UBDocumentProxy> duplicatedProxy = nullptr;
         if (nodeSource->nodeType() == UBDocumentTreeNode::Document && nodeSource->proxyData()) {
             duplicatedProxy = UBPersistenceManager::persistenceManager()->duplicateDocument(nodeSource->proxyData());
+
+            if (!duplicatedProxy) {
+                // copy canceled or failed
+                return QModelIndex();
+            }
+
             QDateTime now = QDateTime::currentDateTime();
             duplicatedProxy->setMetaData(UBSettings::documentUpdatedAt, UBStringUtils::toUtcIsoDateTime(now));
             UBMetadataDcSubsetAdaptor::persist(duplicatedProxy);
@@ -1095,7 +1107,7 @@ void UBDocumentTreeModel::moveIndex(const QModelIndex &what, const QModelIndex &
 
 void UBDocumentTreeModel::setCurrentDocument(std::shared_ptr<UBDocumentProxy> pDocument)
 {
-    UBDocumentTreeNode *testCurNode = findProxy(pDocument, mRootNode);
+    UBDocumentTreeNode *testCurNode = findProxy(pDocument);
 
     if (testCurNode) {
         setCurrentNode(testCurNode);
@@ -1104,7 +1116,7 @@ void UBDocumentTreeModel::setCurrentDocument(std::shared_ptr<UBDocumentProxy> pD
 
 QModelIndex UBDocumentTreeModel::indexForProxy(std::shared_ptr<UBDocumentProxy> pSearch) const
 {
-    UBDocumentTreeNode *proxy = findProxy(pSearch, mRootNode);
+    UBDocumentTreeNode *proxy = findProxy(pSearch);
     if (!proxy) {
         return QModelIndex();
     }
@@ -1115,6 +1127,15 @@ QModelIndex UBDocumentTreeModel::indexForProxy(std::shared_ptr<UBDocumentProxy>
 void UBDocumentTreeModel::setRootNode(UBDocumentTreeNode *pRoot)
 {
     mRootNode = pRoot;
+
+    mNodesByPath.clear();
+    mNodesByFolderName.clear();
+    mPathOfNode.clear();
+    mSearchIndex.clear();
+
+    if (mRootNode) {
+        addToIndexes(mRootNode);
+    }
     //reset();
 }
 
@@ -1335,6 +1356,7 @@ void UBDocumentTreeModel::setNewName(const QModelIndex &index, const QString &ne
         QString fullNewName = newName;
         if (!newName.contains(magicSeparator)) {
             indexNode->setNodeName(fullNewName);
+            mSearchIndex.update(indexNode);
             QString virtualDir = virtualDirForIndex(index);
             fullNewName.prepend(virtualDir.isEmpty() ? "" : virtualDir + magicSeparator);
         }
@@ -1353,6 +1375,7 @@ void UBDocumentTreeModel::setNewName(const QModelIndex &index, const QString &ne
         } else {
             indexNode->setNodeName(newName);
             indexNode->proxyData()->setMetaData(UBSettings::documentName, newName);
+            mSearchIndex.update(indexNode);
             indexNode->proxyData()->setMetaData(UBSettings::documentUpdatedAt, UBStringUtils::toUtcIsoDateTime(QDateTime::currentDateTime()));
         }
 
@@ -1396,10 +1419,65 @@ void UBDocumentTreeModel::fixNodeName(const QModelIndex &source, const QModelInd
             || !inTrash(dest))) {
         newName = adjustNameForParentIndex(newName, dest);
         srcNode->setNodeName(newName);
-        nodeFromIndex(source)->setNodeName(newName);
+        mSearchIndex.update(srcNode);
+    }
+}
+
+void UBDocumentTreeModel::addToIndexes(UBDocumentTreeNode *pNode)
+{
+    cacheNode(pNode);
+    mSearchIndex.insert(pNode);
+
+    foreach (UBDocumentTreeNode *child, pNode->children()) {
+        addToIndexes(child);
     }
 }
 
+void UBDocumentTreeModel::removeFromIndexes(UBDocumentTreeNode *pNode)
+{
+    foreach (UBDocumentTreeNode *child, pNode->children()) {
+        removeFromIndexes(child);
+    }
+
+    uncacheNode(pNode);
+    mSearchIndex.remove(pNode);
+}
+
+void UBDocumentTreeModel::cacheNode(UBDocumentTreeNode *pNode) const
+{
+    if (pNode->nodeType() != UBDocumentTreeNode::Document || !pNode->proxyData()) {
+        return;
+    }
+
+    uncacheNode(pNode);
+
+    const QString path = pNode->proxyData()->persistencePath();
+    mNodesByPath.insert(path, pNode);
+    mNodesByFolderName.insert(pNode->proxyData()->documentFolderName(), pNode);
+    mPathOfNode.insert(pNode, path);
+}
+
+void UBDocumentTreeModel::uncacheNode(UBDocumentTreeNode *pNode) const
+{
+    const auto it = mPathOfNode.constFind(pNode);
+    if (it == mPathOfNode.constEnd()) {
+        return;
+    }
+
+    // a reference copy shares the proxy, keep the entries of the other node
+    const QString path = it.value();
+    if (mNodesByPath.value(path) == pNode) {
+        mNodesByPath.remove(path);
+    }
+
+    const QString folderName = QFileInfo(path).fileName();
+    if (mNodesByFolderName.value(folderName) == pNode) {
+        mNodesByFolderName.remove(folderName);
+    }
+
+    mPathOfNode.erase(it);
+}
+
 void UBDocumentTreeModel::updateIndexNameBindings(UBDocumentTreeNode *nd)
 {
     Q_ASSERT(nd);
@@ -1444,6 +1522,7 @@ QModelIndex UBDocumentTreeModel::addNode(UBDocumentTreeNode *pFreeNode, const QM
     int newIndex = pMode == aDetectPosition ? positionForParent(pFreeNode, tstParent): tstParent->children().size();
     beginInsertRows(pParent, newIndex, newIndex);
     tstParent->insertChild(newIndex, pFreeNode);
+    addToIndexes(pFreeNode);
     endInsertRows();
 
     return createIndex(newIndex, 0, pFreeNode);
@@ -1548,7 +1627,7 @@ void UBDocumentTreeView::hSliderRangeChanged(int min, int max)
 void UBDocumentTreeView::mousePressEvent(QMouseEvent *event)
 {
     QTreeView::mousePressEvent(event);
-    UBApplication::documentController->clearThumbnailsSelection();
+    UBApplication::documentController()->clearThumbnailsSelection();
 }
 
 void UBDocumentTreeView::dragEnterEvent(QDragEnterEvent *event)
@@ -1724,7 +1803,7 @@ void UBDocumentTreeView::dropEvent(QDropEvent *event)
     {
         if(targetIsInTrash)
         {
-            UBApplication::documentController->moveIndexesToTrash(dropIndex, docModel);
+            UBApplication::documentController()->moveIndexesToTrash(dropIndex, docModel);
         }else{
             docModel->moveIndexes(dropIndex, targetIndex);
         }
@@ -1734,7 +1813,7 @@ void UBDocumentTreeView::dropEvent(QDropEvent *event)
 
     QTreeView::dropEvent(event);
 
-    UBApplication::documentController->pageSelectionChanged();
+    UBApplication::documentController()->pageSelectionChanged();
 }
 
 void UBDocumentTreeView::paintEvent(QPaintEvent *event)
@@ -1818,7 +1897,7 @@ void UBDocumentTreeItemDelegate::commitAndCloseEditor()
         //emit closeEditor(lineEditor);
         }
 
-        emit UBApplication::documentController->reorderDocumentsRequested();
+        emit UBApplication::documentController()->reorderDocumentsRequested();
     }
 }
 
@@ -2374,6 +2453,12 @@ void UBDocumentController::setupViews()
 
         connect(mDocumentUI->sortKind, SIGNAL(activated(int)), this, SLOT(onSortKindChanged(int)));
         connect(mDocumentUI->sortOrder, SIGNAL(toggled(bool)), this, SLOT(onSortOrderChanged(bool)));
+        connect(mDocumentUI->searchField, &QLineEdit::textChanged, this, [this](const QString& text){
+            mSortFilterProxyModel->setSearchText(text);
+
+            if (!text.isEmpty())
+                mDocumentUI->documentTreeView->expandAll();
+        });
 
         connect(mDocumentUI->splitter, SIGNAL(splitterMoved(int,int)), this, SLOT(onSplitterMoved(int, int)));
 
@@ -2620,11 +2705,20 @@ void UBDocumentController::duplicateSelectedItem()
 
         Q_ASSERT(!docModel->isConstant(selectedIndex) && !docModel->inTrash(selectedIndex));
 
-        UBApplication::showMessage(tr("Duplicating Document %1").arg(""), true);
+        const QString documentName = docModel->nodeFromIndex(selectedIndex)->displayName();
+
+        UBApplication::showMessage(tr("Duplicating Document %1").arg(documentName), true);
 
-        docModel->copyIndexToNewParent(selectedIndex, selectedIndex.parent(), UBDocumentTreeModel::aContentCopy);
+        QPersistentModelIndex copiedIndex = docModel->copyIndexToNewParent(selectedIndex, selectedIndex.parent(), UBDocumentTreeModel::aContentCopy);
 
-        UBApplication::showMessage(tr("Document %1 copied").arg(""), false);
+        if (copiedIndex.isValid())
+        {
+            UBApplication::showMessage(tr("Document %1 copied").arg(documentName), false);
+        }
+        else
+        {
+            UBApplication::showMessage(tr("Copy of Document %1 canceled").arg(documentName), false);
+        }
     }
 
     emit reorderDocumentsRequested();
@@ -3253,7 +3347,7 @@ void UBDocumentController::importFile()
             }
         }
 
-        emit UBApplication::documentController->reorderDocumentsRequested();
+        emit UBApplication::documentController()->reorderDocumentsRequested();
     }
 
     QApplication::restoreOverrideCursor();
@@ -36,6 +36,7 @@
 
 
 #include "document/UBSortFilterProxyModel.h"
+#include "document/UBDocumentSearchIndex.h"
 
 namespace Ui
 {
@@ -245,6 +246,7 @@ public:
     QModelIndex highLighted() {return mHighLighted;}
     std::shared_ptr<UBDocumentProxy> findDocumentByFolderName(QString folderName) const;
     std::shared_ptr<UBDocumentProxy> findDocumentByFolderName(UBDocumentTreeNode* node, QString folderName) const;
+    UBDocumentSearchIndex& searchIndex() {return mSearchIndex;}
 
     //N/C - NNE - 20140407
     bool ascendingOrder() const{ return mAscendingOrder; }
@@ -266,8 +268,12 @@ private:
     UBDocumentTreeNode *mMyDocumentsNode;
     UBDocumentTreeNode *mCurrentNode;
 
+    UBDocumentTreeNode *findProxy(std::shared_ptr<UBDocumentProxy>pSearch) const;
     UBDocumentTreeNode *findProxy(std::shared_ptr<UBDocumentProxy>pSearch, UBDocumentTreeNode *pParent) const;
-    QModelIndex pIndexForNode(const QModelIndex &parent, UBDocumentTreeNode *pNode) const;
+    void addToIndexes(UBDocumentTreeNode *pNode);
+    void removeFromIndexes(UBDocumentTreeNode *pNode);
+    void cacheNode(UBDocumentTreeNode *pNode) const;
+    void uncacheNode(UBDocumentTreeNode *pNode) const;
     QModelIndex addNode(UBDocumentTreeNode *pFreeNode, const QModelIndex &pParent, eAddItemMode pMode = aDetectPosition);
     int positionForParent(UBDocumentTreeNode *pFreeNode, UBDocumentTreeNode *pParentNode);
     void fixNodeName(const QModelIndex &source, const QModelIndex &dest);
@@ -279,6 +285,12 @@ private:
 
     QModelIndex mHighLighted;
 
+    // document nodes by persistence path and by folder name, hits are verified before use
+    mutable QHash<QString, UBDocumentTreeNode*> mNodesByPath;
+    mutable QHash<QString, UBDocumentTreeNode*> mNodesByFolderName;
+    mutable QHash<UBDocumentTreeNode*, QString> mPathOfNode;
+    UBDocumentSearchIndex mSearchIndex;
+
     //N/C - NNE - 20140407
     bool mAscendingOrder;
 
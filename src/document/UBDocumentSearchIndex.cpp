@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBDocumentSearchIndex.h"
+
+#include "document/UBDocumentController.h"
+
+#include "core/memcheck.h"
+
+void UBDocumentSearchIndex::clear()
+{
+    mTexts.clear();
+    ++mGeneration;
+}
+
+void UBDocumentSearchIndex::insert(UBDocumentTreeNode* node)
+{
+    mTexts.insert(node, searchText(node));
+    ++mGeneration;
+}
+
+void UBDocumentSearchIndex::remove(UBDocumentTreeNode* node)
+{
+    if (mTexts.remove(node))
+    {
+        ++mGeneration;
+    }
+}
+
+void UBDocumentSearchIndex::update(UBDocumentTreeNode* node)
+{
+    const auto it = mTexts.find(node);
+
+    if (it != mTexts.end())
+    {
+        *it = searchText(node);
+        ++mGeneration;
+    }
+}
+
+QSet<UBDocumentTreeNode*> UBDocumentSearchIndex::find(const QString& text)
+{
+    const QString query = text.simplified().toCaseFolded();
+    QSet<UBDocumentTreeNode*> result;
+
+    if (query.isEmpty())
+    {
+        mLastQuery.clear();
+        mLastMatches.clear();
+        return result;
+    }
+
+    QList<UBDocumentTreeNode*> matches;
+
+    if (mLastGeneration == mGeneration && !mLastQuery.isEmpty() && query.contains(mLastQuery))
+    {
+        // refine the previous matches, a longer query can only match less
+        for (UBDocumentTreeNode* node : std::as_const(mLastMatches))
+        {
+            if (mTexts.value(node).contains(query))
+            {
+                matches << node;
+            }
+        }
+    }
+    else
+    {
+        for (auto it = mTexts.cbegin(); it != mTexts.cend(); ++it)
+        {
+            if (it.value().contains(query))
+            {
+                matches << it.key();
+            }
+        }
+    }
+
+    for (UBDocumentTreeNode* node : std::as_const(matches))
+    {
+        if (node->nodeType() == UBDocumentTreeNode::Catalog)
+        {
+            addSubtree(node, result);
+        }
+        else
+        {
+            result.insert(node);
+        }
+
+        // ancestors are needed to reach the match in the tree
+        for (UBDocumentTreeNode* ancestor = node->parentNode(); ancestor; ancestor = ancestor->parentNode())
+        {
+            if (result.contains(ancestor))
+            {
+                break;
+            }
+
+            result.insert(ancestor);
+        }
+    }
+
+    mLastQuery = query;
+    mLastGeneration = mGeneration;
+    mLastMatches = matches;
+
+    return result;
+}
+
+int UBDocumentSearchIndex::generation() const
+{
+    return mGeneration;
+}
+
+QString UBDocumentSearchIndex::searchText(const UBDocumentTreeNode* node)
+{
+    QString text = node->displayName();
+
+    if (node->proxyData())
+    {
+        const QString documentName = node->proxyData()->name();
+
+        if (documentName != text)
+        {
+            text += QLatin1Char('\n') + documentName;
+        }
+    }
+
+    return text.toCaseFolded();
+}
+
+void UBDocumentSearchIndex::addSubtree(UBDocumentTreeNode* node, QSet<UBDocumentTreeNode*>& result)
+{
+    result.insert(node);
+
+    for (UBDocumentTreeNode* child : node->children())
+    {
+        addSubtree(child, result);
+    }
+}
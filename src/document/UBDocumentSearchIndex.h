@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+class UBDocumentTreeNode;
+
+/**
+ * @brief Case folded names of the document tree nodes, kept up to date by the
+ * UBDocumentTreeModel so that filtering does not walk the tree and re-fold
+ * every name on each keystroke.
+ */
+class UBDocumentSearchIndex
+{
+public:
+    void clear();
+    void insert(UBDocumentTreeNode* node);
+    void remove(UBDocumentTreeNode* node);
+    void update(UBDocumentTreeNode* node);
+
+    /**
+     * @brief Nodes whose name contains the text, together with their ancestors
+     * and, for matching catalogs, their descendants.
+     *
+     * When the text extends the previous query and the index did not change
+     * in between, only the previous matches are searched again.
+     */
+    QSet<UBDocumentTreeNode*> find(const QString& text);
+
+    /** @brief Incremented on every change of the index */
+    int generation() const;
+
+private:
+    static QString searchText(const UBDocumentTreeNode* node);
+    static void addSubtree(UBDocumentTreeNode* node, QSet<UBDocumentTreeNode*>& result);
+
+    QHash<UBDocumentTreeNode*, QString> mTexts{};
+    int mGeneration{0};
+
+    QString mLastQuery{};
+    int mLastGeneration{-1};
+    QList<UBDocumentTreeNode*> mLastMatches{};
+};
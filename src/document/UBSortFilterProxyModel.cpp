@@ -23,3 +23,40 @@ bool UBSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex
 
     return QSortFilterProxyModel::lessThan(left, right);
 }
+
+void UBSortFilterProxyModel::setSearchText(const QString &text)
+{
+    if (text == mSearchText)
+        return;
+
+    mSearchText = text;
+    mMatchesGeneration = -1;
+    invalidateFilter();
+}
+
+bool UBSortFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (mSearchText.isEmpty())
+        return true;
+
+    UBDocumentTreeModel *model = dynamic_cast<UBDocumentTreeModel*>(sourceModel());
+
+    if (!model)
+        return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+
+    UBDocumentTreeNode *node = model->nodeFromIndex(model->index(sourceRow, 0, sourceParent));
+
+    //always keep myDocuments and trash folders
+    if (!node || node->isTopLevel())
+        return true;
+
+    UBDocumentSearchIndex &searchIndex = model->searchIndex();
+
+    if (mMatchesGeneration != searchIndex.generation())
+    {
+        mMatches = searchIndex.find(mSearchText);
+        mMatchesGeneration = searchIndex.generation();
+    }
+
+    return mMatches.contains(node);
+}
@@ -1,15 +1,30 @@
 #ifndef UBSORTFILTERPROXYMODEL_H
 #define UBSORTFILTERPROXYMODEL_H
 
+#include <QSet>
 #include <QSortFilterProxyModel>
 #include "core/UBPersistenceManager.h"
 
+class UBDocumentTreeNode;
+
 class UBSortFilterProxyModel : public QSortFilterProxyModel
 {
 public:
     UBSortFilterProxyModel();
 
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
+
+    void setSearchText(const QString &text);
+    QString searchText() const {return mSearchText;}
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
+
+private:
+    QString mSearchText;
+    // nodes shown for mSearchText, taken from the search index of the source model
+    mutable QSet<UBDocumentTreeNode*> mMatches;
+    mutable int mMatchesGeneration = -1;
 };
 
 #endif // UBSORTFILTERPROXYMODEL_H
@@ -3,6 +3,7 @@ HEADERS += \
     src/document/UBDocumentContainer.h \
     src/document/UBDocumentController.h \
     src/document/UBDocumentProxy.h \
+    src/document/UBDocumentSearchIndex.h \
     src/document/UBDocumentToc.h \
     src/document/UBDocumentVersionConverter.h \
     src/document/UBSortFilterProxyModel.h \
@@ -12,6 +13,7 @@ SOURCES += \
     src/document/UBDocumentContainer.cpp \
     src/document/UBDocumentController.cpp \
     src/document/UBDocumentProxy.cpp \
+    src/document/UBDocumentSearchIndex.cpp \
     src/document/UBDocumentToc.cpp \
     src/document/UBDocumentVersionConverter.cpp \
     src/document/UBSortFilterProxyModel.cpp \
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBBackgroundRenderer.h"
+
+#include <QDebug>
+#include <QPaintEngine>
+#include <QPainter>
+
+#include "frameworks/UBTrace.h"
+
+#include "core/memcheck.h"
+
+/** Range of the pattern period in device pixels for which a tile is used */
+static const int sMinPixelPeriod = 4;
+static const int sMaxPixelPeriod = 512;
+
+/** Number of tiles kept, e.g. for the patterns of a few zoom levels */
+static const int sMaxTileCount = 8;
+
+/**
+ * @brief Paint the background lines of *rect* from cached tiles
+ *
+ * Returns false without painting anything if the painter is not suited for tiling,
+ * e.g. when printing or exporting vector output, or if the pattern is too dense or too
+ * large on the device. The caller then draws the lines directly.
+ */
+bool UBBackgroundRenderer::draw(QPainter* painter, const QRectF& rect, const Parameters& parameters)
+{
+    const QPaintEngine* engine = painter->paintEngine();
+
+    if (!engine || (engine->type() != QPaintEngine::Raster && engine->type() != QPaintEngine::OpenGL2))
+    {
+        return false;
+    }
+
+    const QTransform deviceTransform = painter->deviceTransform();
+
+    if (deviceTransform.type() > QTransform::TxScale || !qFuzzyCompare(qAbs(deviceTransform.m11()), qAbs(deviceTransform.m22())))
+    {
+        return false;
+    }
+
+    const bool seyes = parameters.background == UBPageBackground::ruled && parameters.seyes;
+    const qreal period = seyes ? 2 * parameters.gridSize : parameters.gridSize;
+
+    // the tile is rendered with an integer size and stretched by less than half a pixel
+    // per period, so that lines stay aligned with the scene whatever the zoom
+    const int pixelPeriod = qRound(period * qAbs(deviceTransform.m11()));
+
+    if (pixelPeriod < sMinPixelPeriod || pixelPeriod > sMaxPixelPeriod)
+    {
+        return false;
+    }
+
+    TileKey key{Pattern::Grid, pixelPeriod, parameters.color.rgba(), parameters.intermediateLines};
+
+    switch (parameters.background)
+    {
+    case UBPageBackground::crossed:
+        fill(painter, rect, key, period, QPointF());
+        break;
+
+    case UBPageBackground::ruled:
+        if (seyes)
+        {
+            const int nbMarginCase = 1; // a small left margin of one gridSize
+
+            key.color = 0;
+            key.intermediateLines = false;
+
+            key.pattern = Pattern::SeyesRules;
+            fill(painter, rect, key, period, QPointF());
+
+            QPen redLineMargin(QColor("red"));
+            redLineMargin.setWidthF(2.);
+
+            const qreal marginX = nbMarginCase * period - parameters.nominalWidth / 2.;
+            painter->setPen(redLineMargin);
+            painter->drawLine(QLineF(marginX, rect.y(), marginX, rect.y() + rect.height()));
+
+            const qreal firstX = (nbMarginCase + 1) * period - parameters.nominalWidth / 2.;
+            QRectF columnsRect = rect;
+            columnsRect.setLeft(qMax(rect.left(), firstX - period / 2.));
+
+            if (columnsRect.isValid())
+            {
+                key.pattern = Pattern::SeyesColumns;
+                fill(painter, columnsRect, key, period, QPointF(firstX, 0));
+            }
+        }
+        else
+        {
+            key.pattern = Pattern::Rules;
+            fill(painter, rect, key, period, QPointF());
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Return the tile for *key*, rendering it on first use
+ *
+ * The tile covers one *period* of the pattern. Lines lying on its border are drawn on
+ * both sides, so that their halves join when the tile is repeated.
+ */
+const QImage& UBBackgroundRenderer::tile(const TileKey& key, qreal period)
+{
+    auto it = mTiles.constFind(key);
+
+    if (it != mTiles.constEnd())
+    {
+        UBTrace::instant("background tile hit");
+        return *it;
+    }
+
+    UBTrace::instant("background tile miss");
+
+    if (mTiles.size() >= sMaxTileCount)
+    {
+        mTiles.clear();
+    }
+
+    QImage image(key.pixelPeriod, key.pixelPeriod, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.scale(key.pixelPeriod / period, key.pixelPeriod / period);
+
+    const QColor color = QColor::fromRgba(key.color);
+    QColor intermediateColor = color;
+    intermediateColor.setAlphaF(0.5 * color.alphaF());
+
+    switch (key.pattern)
+    {
+    case Pattern::Grid:
+        painter.setPen(color);
+        painter.drawLine(QLineF(0, 0, period, 0));
+        painter.drawLine(QLineF(0, period, period, period));
+        painter.drawLine(QLineF(0, 0, 0, period));
+        painter.drawLine(QLineF(period, 0, period, period));
+
+        if (key.intermediateLines)
+        {
+            painter.setPen(intermediateColor);
+            painter.drawLine(QLineF(0, period / 2, period, period / 2));
+            painter.drawLine(QLineF(period / 2, 0, period / 2, period));
+        }
+        break;
+
+    case Pattern::Rules:
+        painter.setPen(color);
+        painter.drawLine(QLineF(0, 0, period, 0));
+        painter.drawLine(QLineF(0, period, period, period));
+
+        if (key.intermediateLines)
+        {
+            painter.setPen(intermediateColor);
+            painter.drawLine(QLineF(0, period / 2, period, period / 2));
+        }
+        break;
+
+    case Pattern::SeyesRules:
+    {
+        QPen seyesSquare(QColor("#8e7cc3"));
+        seyesSquare.setWidthF(2.);
+
+        QColor interlineColor("#6fa8dc");
+        interlineColor.setAlphaF(0.6);
+        QPen interlinePen(interlineColor);
+        interlinePen.setWidthF(2.);
+
+        painter.setPen(seyesSquare);
+        painter.drawLine(QLineF(0, 0, period, 0));
+        painter.drawLine(QLineF(0, period, period, period));
+
+        painter.setPen(interlinePen);
+
+        for (int i = 1; i < 4; ++i)
+        {
+            painter.drawLine(QLineF(0, i * period / 4, period, i * period / 4));
+        }
+        break;
+    }
+
+    case Pattern::SeyesColumns:
+    {
+        QPen seyesSquare(QColor("#8e7cc3"));
+        seyesSquare.setWidthF(2.);
+
+        painter.setPen(seyesSquare);
+        painter.drawLine(QLineF(0, 0, 0, period));
+        painter.drawLine(QLineF(period, 0, period, period));
+        break;
+    }
+    }
+
+    painter.end();
+
+    return *mTiles.insert(key, image);
+}
+
+/**
+ * @brief Fill *rect* with the tile of *key*, its top left corner being aligned on *origin*
+ */
+void UBBackgroundRenderer::fill(QPainter* painter, const QRectF& rect, const TileKey& key, qreal period, const QPointF& origin)
+{
+    QBrush brush(tile(key, period));
+
+    QTransform transform;
+    transform.translate(origin.x(), origin.y());
+    transform.scale(period / key.pixelPeriod, period / key.pixelPeriod);
+    brush.setTransform(transform);
+
+    painter->fillRect(rect, brush);
+}
+
+#ifdef UB_PROFILING
+/**
+ * @brief Log the average time spent painting the background, tiled or not
+ */
+void UBBackgroundRenderer::recordPaintTime(bool tiled, qint64 nsecs)
+{
+    static qint64 totalNsecs[2] = {0, 0};
+    static int paintCount[2] = {0, 0};
+    static const int reportInterval = 500;
+
+    totalNsecs[tiled] += nsecs;
+
+    if (++paintCount[tiled] == reportInterval)
+    {
+        qDebug() << (tiled ? "tiled" : "direct") << "background paint:" << totalNsecs[tiled] / reportInterval / 1000. << "us on average";
+
+        totalNsecs[tiled] = 0;
+        paintCount[tiled] = 0;
+    }
+}
+#endif
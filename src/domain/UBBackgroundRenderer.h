@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QRectF>
+
+#include "core/UB.h"
+
+class QPainter;
+
+/**
+ * Paints the crossed and ruled page backgrounds from small cached tiles.
+ *
+ * A tile holds exactly one period of the pattern, rendered at the device resolution
+ * of the painter, and is repeated with a texture brush instead of drawing every grid
+ * line at each paint. Tiles are keyed by pattern, period in device pixels and colour,
+ * so that a new tile is only rendered when the grid size, zoom or colour changes.
+ */
+class UBBackgroundRenderer
+{
+public:
+    struct Parameters
+    {
+        UBPageBackground background{UBPageBackground::plain};
+        qreal gridSize{0};
+        QColor color{};
+        bool intermediateLines{false};
+        bool seyes{false};
+        qreal nominalWidth{0};
+    };
+
+    bool draw(QPainter* painter, const QRectF& rect, const Parameters& parameters);
+
+#ifdef UB_PROFILING
+    static void recordPaintTime(bool tiled, qint64 nsecs);
+#endif
+
+private:
+    enum class Pattern
+    {
+        Grid,
+        Rules,
+        SeyesRules,
+        SeyesColumns
+    };
+
+    struct TileKey
+    {
+        Pattern pattern;
+        int pixelPeriod;
+        QRgb color;
+        bool intermediateLines;
+
+        bool operator==(const TileKey& other) const
+        {
+            return pattern == other.pattern && pixelPeriod == other.pixelPeriod
+                    && color == other.color && intermediateLines == other.intermediateLines;
+        }
+    };
+
+    friend uint qHash(const TileKey& key);
+
+    const QImage& tile(const TileKey& key, qreal period);
+    void fill(QPainter* painter, const QRectF& rect, const TileKey& key, qreal period, const QPointF& origin);
+
+    QHash<TileKey, QImage> mTiles{};
+};
+
+inline uint qHash(const UBBackgroundRenderer::TileKey& key)
+{
+    return (uint(key.pattern) << 28) ^ (uint(key.intermediateLines) << 27) ^ (uint(key.pixelPeriod) << 12) ^ key.color;
+}
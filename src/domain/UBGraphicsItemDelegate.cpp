@@ -724,7 +724,7 @@ void UBGraphicsItemDelegate::gotoContentSource()
     if(item && !item->sourceUrl().isEmpty())
     {
         UBApplication::applicationController->showInternet();
-        UBApplication::webController->loadUrl(item->sourceUrl());
+        UBApplication::webController()->loadUrl(item->sourceUrl());
     }
 }
 
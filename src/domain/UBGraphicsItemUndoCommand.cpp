@@ -34,21 +34,31 @@
 #include "UBGraphicsScene.h"
 
 #include "core/UBApplication.h"
+#include "core/UBSettings.h"
 
 #include "board/UBBoardController.h"
 
 #include "core/memcheck.h"
 #include "domain/UBGraphicsGroupContainerItem.h"
 #include "domain/UBGraphicsPolygonItem.h"
+#include "domain/UBGraphicsStrokesGroup.h"
+#include "domain/UBUndoHistory.h"
 
 UBGraphicsItemUndoCommand::UBGraphicsItemUndoCommand(std::shared_ptr<UBGraphicsScene> pScene, const QSet<QGraphicsItem*>& pRemovedItems, const QSet<QGraphicsItem*>& pAddedItems, const GroupDataTable &groupsMap): UBUndoCommand()
     , mScene(pScene)
     , mRemovedItems(pRemovedItems - pAddedItems)
     , mAddedItems(pAddedItems - pRemovedItems)
     , mExcludedFromGroup(groupsMap)
+    , mTimestamp(QDateTime::currentMSecsSinceEpoch())
+    , mMemoryCost(0)
+    , mAccountedCost(0)
+    , mSpillOffset(0)
+    , mSpillSize(0)
 {
     mFirstRedo = true;
 
+    updateMemoryCost();
+
     QSetIterator<QGraphicsItem*> itAdded(mAddedItems);
     while (itAdded.hasNext())
     {
@@ -64,6 +74,11 @@ UBGraphicsItemUndoCommand::UBGraphicsItemUndoCommand(std::shared_ptr<UBGraphicsS
 
 UBGraphicsItemUndoCommand::UBGraphicsItemUndoCommand(std::shared_ptr<UBGraphicsScene> pScene, QGraphicsItem* pRemovedItem, QGraphicsItem* pAddedItem) : UBUndoCommand()
     , mScene(pScene)
+    , mTimestamp(QDateTime::currentMSecsSinceEpoch())
+    , mMemoryCost(0)
+    , mAccountedCost(0)
+    , mSpillOffset(0)
+    , mSpillSize(0)
 {
 
     if (pRemovedItem)
@@ -78,11 +93,250 @@ UBGraphicsItemUndoCommand::UBGraphicsItemUndoCommand(std::shared_ptr<UBGraphicsS
 
     mFirstRedo = true;
 
+    updateMemoryCost();
 }
 
 UBGraphicsItemUndoCommand::~UBGraphicsItemUndoCommand()
 {
-   //NOOP
+    if (UBUndoHistory::history())
+        UBUndoHistory::history()->addMemoryUsage(-mAccountedCost);
+}
+
+int UBGraphicsItemUndoCommand::id() const
+{
+    return coalescingKind();
+}
+
+/**
+ * \brief Coalesce a stroke or an erasure with the previous one when they closely follow each other
+ */
+bool UBGraphicsItemUndoCommand::mergeWith(const QUndoCommand* other)
+{
+    const UBGraphicsItemUndoCommand* command = dynamic_cast<const UBGraphicsItemUndoCommand*>(other);
+    const qint64 interval = UBSettings::settings()->undoCoalescingInterval->get().toLongLong();
+
+    if (!command || interval <= 0 || command->mScene != mScene || isSpilled() || command->isSpilled())
+        return false;
+
+    if (command->mTimestamp - mTimestamp > interval)
+        return false;
+
+    // fragments left by an erasure and erased by the next one are never seen again
+    QSet<QGraphicsItem*> transientItems = mAddedItems & command->mRemovedItems;
+
+    mRemovedItems += command->mRemovedItems - transientItems;
+    mAddedItems = (mAddedItems - transientItems) + command->mAddedItems;
+    mTimestamp = command->mTimestamp;
+
+    foreach (QGraphicsItem* item, transientItems)
+    {
+        if (!item->scene() && !item->parentItem() && !UBUndoHistory::isInClipboard(item))
+        {
+            if (!mScene->deleteItem(item))
+                delete item;
+        }
+    }
+
+    updateMemoryCost();
+
+    return true;
+}
+
+UBGraphicsItemUndoCommand::CoalescingKind UBGraphicsItemUndoCommand::coalescingKind() const
+{
+    if (!mExcludedFromGroup.isEmpty() || isSpilled())
+        return NotCoalescing;
+
+    if (mRemovedItems.isEmpty() && !mAddedItems.isEmpty())
+    {
+        foreach (QGraphicsItem* item, mAddedItems)
+        {
+            if (UBGraphicsStrokesGroup::Type != item->type())
+                return NotCoalescing;
+        }
+
+        return StrokeCoalescing;
+    }
+
+    if (!mRemovedItems.isEmpty())
+    {
+        foreach (QGraphicsItem* item, mRemovedItems + mAddedItems)
+        {
+            if (UBGraphicsPolygonItem::Type != item->type())
+                return NotCoalescing;
+        }
+
+        return ErasureCoalescing;
+    }
+
+    return NotCoalescing;
+}
+
+qint64 UBGraphicsItemUndoCommand::itemMemoryCost(QGraphicsItem* item)
+{
+    // rough estimate, enough to compare commands with each other
+    qint64 cost = 256;
+
+    UBGraphicsPolygonItem* polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+    QGraphicsPixmapItem* pixmapItem = dynamic_cast<QGraphicsPixmapItem*>(item);
+
+    if (polygonItem)
+    {
+        cost += sizeof(UBGraphicsPolygonItem) + polygonItem->polygon().size() * sizeof(QPointF);
+    }
+    else if (pixmapItem)
+    {
+        const QPixmap& pixmap = pixmapItem->pixmap();
+        cost += qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    }
+
+    foreach (QGraphicsItem* child, item->childItems())
+    {
+        cost += itemMemoryCost(child);
+    }
+
+    return cost;
+}
+
+void UBGraphicsItemUndoCommand::updateMemoryCost()
+{
+    // the removed items are the ones kept alive by the undo history only
+    mMemoryCost = sizeof(UBGraphicsItemUndoCommand);
+
+    foreach (QGraphicsItem* item, mRemovedItems)
+    {
+        mMemoryCost += itemMemoryCost(item);
+    }
+
+    if (UBUndoHistory::history())
+    {
+        UBUndoHistory::history()->addMemoryUsage(mMemoryCost - mAccountedCost);
+        mAccountedCost = mMemoryCost;
+    }
+}
+
+/**
+ * \brief Serialize the given removed polygons to the undo spill file and delete them
+ * @param pItems as the removed items referenced by this command only
+ * @return the estimated number of bytes freed
+ */
+qint64 UBGraphicsItemUndoCommand::spill(const QSet<QGraphicsItem*>& pItems)
+{
+    if (!mScene || isSpilled() || !UBUndoHistory::history())
+        return 0;
+
+    QList<UBGraphicsPolygonItem*> polygonItems;
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    foreach (QGraphicsItem* item, pItems)
+    {
+        UBGraphicsPolygonItem* polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+
+        if (polygonItem && mRemovedItems.contains(item) && polygonItem->strokesGroup())
+        {
+            polygonItem->writeTo(stream);
+            polygonItems << polygonItem;
+        }
+    }
+
+    if (polygonItems.isEmpty())
+        return 0;
+
+    QByteArray compressed = qCompress(data);
+    qint64 offset = UBUndoHistory::history()->writeSpill(compressed);
+
+    if (offset < 0)
+        return 0;
+
+    const qint64 previousCost = mMemoryCost;
+
+    foreach (UBGraphicsPolygonItem* polygonItem, polygonItems)
+    {
+        // the strokes group stays alive, it is referenced by the page or other commands
+        mSpilledGroups << polygonItem->strokesGroup()->uuid();
+        mRemovedItems.remove(polygonItem);
+
+        if (!mScene->deleteItem(polygonItem))
+            delete polygonItem;
+    }
+
+    mSpillOffset = offset;
+    mSpillSize = compressed.size();
+
+    updateMemoryCost();
+
+    return previousCost - mMemoryCost;
+}
+
+void UBGraphicsItemUndoCommand::rehydrate()
+{
+    if (!isSpilled())
+        return;
+
+    QByteArray data = qUncompress(UBUndoHistory::history()->readSpill(mSpillOffset, mSpillSize));
+    QDataStream stream(data);
+    QHash<QUuid, UBGraphicsStrokesGroup*> groups;
+
+    foreach (const QUuid& groupUuid, mSpilledGroups)
+    {
+        if (stream.atEnd())
+        {
+            qWarning() << "undo spill data is truncated, removed strokes cannot be restored";
+            break;
+        }
+
+        // the stroke of the polygon is not restored, the fragment is persisted on its own
+        UBGraphicsPolygonItem* polygonItem = UBGraphicsPolygonItem::readFrom(stream);
+        UBGraphicsStrokesGroup* group = spilledGroup(groupUuid, groups);
+
+        if (!group)
+        {
+            qWarning() << "strokes group" << groupUuid << "no longer exists, removed stroke cannot be restored";
+            delete polygonItem;
+            continue;
+        }
+
+        polygonItem->setStrokesGroup(group);
+        mRemovedItems.insert(polygonItem);
+    }
+
+    mSpilledGroups.clear();
+    mSpillOffset = 0;
+    mSpillSize = 0;
+
+    updateMemoryCost();
+}
+
+/**
+ * \brief Find the strokes group of spilled polygons, among the removed items or on the scene
+ */
+UBGraphicsStrokesGroup* UBGraphicsItemUndoCommand::spilledGroup(const QUuid& uuid, QHash<QUuid, UBGraphicsStrokesGroup*>& groups) const
+{
+    if (!groups.contains(uuid))
+    {
+        UBGraphicsStrokesGroup* group = nullptr;
+
+        foreach (QGraphicsItem* item, mRemovedItems)
+        {
+            UBGraphicsStrokesGroup* removedGroup = qgraphicsitem_cast<UBGraphicsStrokesGroup*>(item);
+
+            if (removedGroup && removedGroup->uuid() == uuid)
+            {
+                group = removedGroup;
+                break;
+            }
+        }
+
+        if (!group)
+        {
+            group = qgraphicsitem_cast<UBGraphicsStrokesGroup*>(mScene->itemForUuid(uuid));
+        }
+
+        groups.insert(uuid, group);
+    }
+
+    return groups.value(uuid);
 }
 
 void UBGraphicsItemUndoCommand::undo()
@@ -91,6 +345,8 @@ void UBGraphicsItemUndoCommand::undo()
         return;
     }
 
+    rehydrate();
+
     QSetIterator<QGraphicsItem*> itAdded(mAddedItems);
     while (itAdded.hasNext())
     {
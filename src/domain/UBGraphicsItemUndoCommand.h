@@ -36,6 +36,7 @@
 
 
 class UBGraphicsScene;
+class UBGraphicsStrokesGroup;
 
 
 class UBGraphicsItemUndoCommand : public UBUndoCommand
@@ -57,11 +58,31 @@ class UBGraphicsItemUndoCommand : public UBUndoCommand
 
         virtual int getType() const { return UBUndoType::undotype_GRAPHICITEM; }
 
+        virtual int id() const;
+        virtual bool mergeWith(const QUndoCommand* other);
+
+        qint64 memoryCost() const { return mMemoryCost; }
+        bool isSpilled() const { return mSpillSize > 0; }
+        qint64 spill(const QSet<QGraphicsItem*>& pItems);
+
     protected:
         virtual void undo();
         virtual void redo();
 
     private:
+        enum CoalescingKind
+        {
+            NotCoalescing = -1,
+            StrokeCoalescing = 1,
+            ErasureCoalescing
+        };
+
+        CoalescingKind coalescingKind() const;
+        void updateMemoryCost();
+        void rehydrate();
+        UBGraphicsStrokesGroup* spilledGroup(const QUuid& uuid, QHash<QUuid, UBGraphicsStrokesGroup*>& groups) const;
+        static qint64 itemMemoryCost(QGraphicsItem* item);
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
         typedef QMultiMapIterator<UBGraphicsGroupContainerItem*, QUuid> GroupDataTableIterator;
 #else
@@ -73,6 +94,15 @@ class UBGraphicsItemUndoCommand : public UBUndoCommand
         GroupDataTable mExcludedFromGroup;
 
         bool mFirstRedo;
+
+        qint64 mTimestamp;
+        qint64 mMemoryCost;
+        qint64 mAccountedCost;
+
+        qint64 mSpillOffset;
+        qint64 mSpillSize;
+        // uuids of the groups of the spilled polygons, the groups may be deleted meanwhile
+        QList<QUuid> mSpilledGroups;
 };
 
 #endif /* UBGRAPHICSITEMUNDOCOMMAND_H_ */
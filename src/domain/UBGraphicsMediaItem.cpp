@@ -35,9 +35,12 @@
 #include "document/UBDocumentProxy.h"
 #include "core/UBApplication.h"
 #include "board/UBBoardController.h"
+#include "frameworks/UBVideoPoster.h"
 #include "core/memcheck.h"
 
+#include <QFutureWatcher>
 #include <QGraphicsVideoItem>
+#include <QtConcurrent>
 
 bool UBGraphicsMediaItem::sIsMutedByDefault = false;
 
@@ -65,6 +68,7 @@ UBGraphicsMediaItem* UBGraphicsMediaItem::createMediaItem(const QUrl &pMediaFile
 
 UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsItem *parent)
         : QGraphicsRectItem(parent)
+        , mMediaObject(nullptr)
         , mMuted(sIsMutedByDefault)
         , mMutedByUserAction(sIsMutedByDefault)
         , mStopped(false)
@@ -72,53 +76,20 @@ UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsIte
         , mMediaFileUrl(pMediaFileUrl)
         , mLinkedImage(NULL)
         , mInitialPos(0)
+        , mResumePosition(-1)
+        , mResumeDuration(0)
 {
 
     mErrorString = "";
 
-    mMediaObject = new QMediaPlayer(this);
-
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    mMediaObject->setSource(pMediaFileUrl);
-    QAudioOutput* output = new QAudioOutput(QAudioDevice(), this);
-    mMediaObject->setAudioOutput(output);
-#else
-    mMediaObject->setMedia(pMediaFileUrl);
-#endif
-
     setDelegate(new UBGraphicsMediaItemDelegate(this));
 
     setData(UBGraphicsItemData::itemLayerType, QVariant(itemLayerType::ObjectItem));
     setFlag(ItemIsMovable, true);
     setFlag(ItemSendsGeometryChanges, true);
 
-    connect(mMediaObject, SIGNAL(mediaStatusChanged(QMediaPlayer::MediaStatus)),
-            Delegate(), SLOT(mediaStatusChanged(QMediaPlayer::MediaStatus)));
-
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    connect(mMediaObject, SIGNAL(playbackStateChanged(QMediaPlayer::PlaybackState)),
-            Delegate(), SLOT(mediaStateChanged(QMediaPlayer::PlaybackState)));
-#else
-    connect(mMediaObject, SIGNAL(stateChanged(QMediaPlayer::State)),
-            Delegate(), SLOT(mediaStateChanged(QMediaPlayer::State)));
-#endif
-
-    connect(mMediaObject, SIGNAL(positionChanged(qint64)),
-            Delegate(), SLOT(updateTicker(qint64)));
-
-    connect(mMediaObject, SIGNAL(durationChanged(qint64)),
-            Delegate(), SLOT(totalTimeChanged(qint64)));
-
     connect(Delegate(), SIGNAL(showOnDisplayChanged(bool)),
             this, SLOT(showOnDisplayChanged(bool)));
-
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    connect(mMediaObject, &QMediaPlayer::errorOccurred,
-            this, &UBGraphicsMediaItem::mediaError);
-#else
-    connect(mMediaObject, qOverload<QMediaPlayer::Error>(&QMediaPlayer::error),
-            this, &UBGraphicsMediaItem::mediaError);
-#endif
 }
 
 UBGraphicsAudioItem::UBGraphicsAudioItem(const QUrl &pMediaFileUrl, QGraphicsItem *parent)
@@ -131,6 +102,11 @@ UBGraphicsAudioItem::UBGraphicsAudioItem(const QUrl &pMediaFileUrl, QGraphicsIte
 
     this->setSize(320, 26);
     this->setMinimumSize(QSize(150, 26));
+}
+
+void UBGraphicsAudioItem::createPlayer()
+{
+    UBGraphicsMediaItem::createPlayer();
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
     mMediaObject->setNotifyInterval(1000);
@@ -139,31 +115,43 @@ UBGraphicsAudioItem::UBGraphicsAudioItem(const QUrl &pMediaFileUrl, QGraphicsIte
 
 UBGraphicsVideoItem::UBGraphicsVideoItem(const QUrl &pMediaFileUrl, QGraphicsItem *parent)
     :UBGraphicsMediaItem(pMediaFileUrl, parent)
+    , mVideoItem(nullptr)
+    , mPlaceholderVisible(false)
+    , mPosterRequested(false)
 {
     haveLinkedImage = true;
     setPlaceholderVisible(true);
     Delegate()->createControls();
 
+    setMinimumSize(QSize(320, 240));
+    setSize(320, 240);
+
+    setAcceptHoverEvents(true);
+
+    update();
+}
+
+void UBGraphicsVideoItem::createPlayer()
+{
+    UBGraphicsMediaItem::createPlayer();
+
     mVideoItem = new QGraphicsVideoItem(this);
 
     mVideoItem->setData(UBGraphicsItemData::ItemLayerType, UBItemLayerType::Object);
     mVideoItem->setFlag(ItemStacksBehindParent, true);
+    mVideoItem->setSize(rect().size());
 
     /* setVideoOutput has to be called only when the video item is visible on the screen,
-     * due to a Qt bug (QTBUG-32522). So instead of calling it here, it is called when the
-     * active scene has changed, or when the item is first created.
+     * due to a Qt bug (QTBUG-32522). This is the case here, as the player is only created
+     * for items visible on the active scene.
      * If and when Qt fix this issue, this should be changed back.
      * */
     mMediaObject->setVideoOutput(mVideoItem);
-    mHasVideoOutput = true;
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
     mMediaObject->setNotifyInterval(50);
 #endif
 
-    setMinimumSize(QSize(320, 240));
-    setSize(320, 240);
-
     connect(mVideoItem, SIGNAL(nativeSizeChanged(QSizeF)),
             this, SLOT(videoSizeChanged(QSizeF)));
 
@@ -186,14 +174,131 @@ UBGraphicsVideoItem::UBGraphicsVideoItem(const QUrl &pMediaFileUrl, QGraphicsIte
     connect(mMediaObject, qOverload<QMediaPlayer::Error>(&QMediaPlayer::error),
             this, &UBGraphicsVideoItem::mediaError);
 #endif
+}
 
-    setAcceptHoverEvents(true);
+void UBGraphicsVideoItem::releasePlayer()
+{
+    UBGraphicsMediaItem::releasePlayer();
 
-    update();
+    delete mVideoItem;
+    mVideoItem = nullptr;
+
+    // show the poster frame in place of the video
+    setPlaceholderVisible(true);
 }
 
 UBGraphicsMediaItem::~UBGraphicsMediaItem()
 {
+    delete mMediaObject;
+}
+
+/**
+ * @brief Create the player if not done yet and load the media, restoring a paused position
+ * kept when the player was released.
+ */
+void UBGraphicsMediaItem::ensurePlayer()
+{
+    if (mMediaObject)
+        return;
+
+    createPlayer();
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    mMediaObject->setSource(absoluteMediaFileUrl());
+#else
+    mMediaObject->setMedia(absoluteMediaFileUrl());
+#endif
+
+    if (mResumePosition >= 0)
+    {
+        mMediaObject->setPosition(mResumePosition);
+        mMediaObject->pause();
+    }
+
+    mResumePosition = -1;
+    mResumeDuration = 0;
+}
+
+void UBGraphicsMediaItem::createPlayer()
+{
+    mMediaObject = new QMediaPlayer(this);
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QAudioOutput* output = new QAudioOutput(QAudioDevice(), mMediaObject);
+    mMediaObject->setAudioOutput(output);
+#endif
+
+    applyMute();
+
+    connect(mMediaObject, SIGNAL(mediaStatusChanged(QMediaPlayer::MediaStatus)),
+            Delegate(), SLOT(mediaStatusChanged(QMediaPlayer::MediaStatus)));
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    connect(mMediaObject, SIGNAL(playbackStateChanged(QMediaPlayer::PlaybackState)),
+            Delegate(), SLOT(mediaStateChanged(QMediaPlayer::PlaybackState)));
+#else
+    connect(mMediaObject, SIGNAL(stateChanged(QMediaPlayer::State)),
+            Delegate(), SLOT(mediaStateChanged(QMediaPlayer::State)));
+#endif
+
+    connect(mMediaObject, SIGNAL(positionChanged(qint64)),
+            Delegate(), SLOT(updateTicker(qint64)));
+
+    connect(mMediaObject, SIGNAL(durationChanged(qint64)),
+            Delegate(), SLOT(totalTimeChanged(qint64)));
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    connect(mMediaObject, &QMediaPlayer::errorOccurred,
+            this, &UBGraphicsMediaItem::mediaError);
+#else
+    connect(mMediaObject, qOverload<QMediaPlayer::Error>(&QMediaPlayer::error),
+            this, &UBGraphicsMediaItem::mediaError);
+#endif
+}
+
+/**
+ * @brief Delete the player and its decoders. A playing or paused position is kept, so
+ * that it is saved with the page and restored when the player is created again.
+ */
+void UBGraphicsMediaItem::releasePlayer()
+{
+    if (!mMediaObject)
+        return;
+
+    const qint64 position = mMediaObject->position();
+    const qint64 duration = mMediaObject->duration();
+
+    if (playerState() != QMediaPlayer::StoppedState && duration - position > 0)
+    {
+        mResumePosition = position;
+        mResumeDuration = duration;
+    }
+    else
+    {
+        mResumePosition = -1;
+        mResumeDuration = 0;
+    }
+
+    delete mMediaObject;
+    mMediaObject = nullptr;
+    mFirstLoad = true;
+}
+
+bool UBGraphicsMediaItem::isOnActiveScene()
+{
+    return scene()
+            && UBApplication::boardController
+            && UBApplication::boardController->activeScene() == scene();
+}
+
+QUrl UBGraphicsMediaItem::absoluteMediaFileUrl()
+{
+    const QString localFile = mMediaFileUrl.toLocalFile();
+
+    if ((localFile.startsWith("audios/") || localFile.startsWith("videos/")) && scene() && scene()->document())
+        return QUrl::fromLocalFile(scene()->document()->persistencePath() + "/" + localFile);
+
+    return mMediaFileUrl;
 }
 
 QVariant UBGraphicsMediaItem::itemChange(GraphicsItemChange change, const QVariant &value)
@@ -207,24 +312,20 @@ QVariant UBGraphicsMediaItem::itemChange(GraphicsItemChange change, const QVaria
     }
     else if (change == QGraphicsItem::ItemSceneHasChanged)
     {
-        if (!scene())
+        if (!scene()) {
             stop();
-        else {
-            QString absoluteMediaFilename;
-
-            if(mMediaFileUrl.toLocalFile().startsWith("audios/") || mMediaFileUrl.toLocalFile().startsWith("videos/"))
-                absoluteMediaFilename = scene()->document()->persistencePath() + "/"  + mMediaFileUrl.toLocalFile();
-            else
-                absoluteMediaFilename = mMediaFileUrl.toLocalFile();
-
-            if (absoluteMediaFilename.length() > 0)
-            {
+            releasePlayer();
+        }
+        else if (mMediaObject) {
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-                mMediaObject->setSource(QUrl::fromLocalFile(absoluteMediaFilename));
+            mMediaObject->setSource(absoluteMediaFileUrl());
 #else
-                mMediaObject->setMedia(QUrl::fromLocalFile(absoluteMediaFilename));
+            mMediaObject->setMedia(absoluteMediaFileUrl());
 #endif
-            }
+        }
+        else if (isVisible() && isOnActiveScene()) {
+            // scenes only loaded for caching, thumbnails or export never get a player
+            ensurePlayer();
         }
     }
 
@@ -248,11 +349,17 @@ void UBGraphicsMediaItem::paint(QPainter *painter, const QStyleOptionGraphicsIte
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 QMediaPlayer::PlaybackState UBGraphicsMediaItem::playerState() const
 {
+    if (!mMediaObject)
+        return mResumePosition >= 0 ? QMediaPlayer::PausedState : QMediaPlayer::StoppedState;
+
     return mMediaObject->playbackState();
 }
 #else
 QMediaPlayer::State UBGraphicsMediaItem::playerState() const
 {
+    if (!mMediaObject)
+        return mResumePosition >= 0 ? QMediaPlayer::PausedState : QMediaPlayer::StoppedState;
+
     return mMediaObject->state();
 }
 #endif
@@ -277,17 +384,20 @@ void UBGraphicsMediaItem::setFirstLoad(bool firstLoad)
 
 qint64 UBGraphicsMediaItem::mediaDuration() const
 {
-    return mMediaObject->duration();
+    return mMediaObject ? mMediaObject->duration() : mResumeDuration;
 }
 
 qint64 UBGraphicsMediaItem::mediaPosition() const
 {
+    if (!mMediaObject)
+        return mResumePosition >= 0 ? mResumePosition : mInitialPos;
+
     return mMediaObject->position();
 }
 
 bool UBGraphicsMediaItem::isMediaSeekable() const
 {
-    return mMediaObject->isSeekable();
+    return mMediaObject && mMediaObject->isSeekable();
 }
 
 /**
@@ -329,7 +439,8 @@ void UBGraphicsMediaItem::setInitialPos(qint64 p)
 
 void UBGraphicsMediaItem::setMediaPos(qint64 p)
 {
-    mMediaObject->setPosition(p);
+    if (mMediaObject)
+        mMediaObject->setPosition(p);
 }
 
 void UBGraphicsMediaItem::setSelected(bool selected)
@@ -358,6 +469,9 @@ void UBGraphicsMediaItem::clearSource()
 
     if (!UBFileSystemUtils::deleteFile(path))
         qDebug() << "cannot delete file: " << path;
+
+    if (getMediaType() == mediaType_Video)
+        QFile::remove(UBVideoPoster::posterFileName(path));
 }
 
 void UBGraphicsMediaItem::toggleMute()
@@ -369,13 +483,21 @@ void UBGraphicsMediaItem::toggleMute()
 void UBGraphicsMediaItem::setMute(bool bMute)
 {
     mMuted = bMute;
+    applyMute();
+    mMutedByUserAction = mMuted;
+    sIsMutedByDefault = mMuted;
+}
+
+void UBGraphicsMediaItem::applyMute()
+{
+    if (!mMediaObject)
+        return;
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     mMediaObject->audioOutput()->setMuted(mMuted);
 #else
     mMediaObject->setMuted(mMuted);
 #endif
-    mMutedByUserAction = mMuted;
-    sIsMutedByDefault = mMuted;
 }
 
 std::shared_ptr<UBGraphicsScene> UBGraphicsMediaItem::scene()
@@ -387,8 +509,10 @@ std::shared_ptr<UBGraphicsScene> UBGraphicsMediaItem::scene()
 
 void UBGraphicsMediaItem::activeSceneChanged()
 {
-    if (UBApplication::boardController->activeScene() != scene())
-        pause();
+    if (!isOnActiveScene())
+        releasePlayer();
+    else if (isVisible())
+        ensurePlayer();
 }
 
 
@@ -396,36 +520,35 @@ void UBGraphicsMediaItem::showOnDisplayChanged(bool shown)
 {
     if (!shown) {
         mMuted = true;
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        mMediaObject->audioOutput()->setMuted(mMuted);
-#else
-        mMediaObject->setMuted(mMuted);
-#endif
+        applyMute();
     }
     else if (!mMutedByUserAction) {
         mMuted = false;
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        mMediaObject->audioOutput()->setMuted(mMuted);
-#else
-        mMediaObject->setMuted(mMuted);
-#endif
+        applyMute();
     }
 }
 void UBGraphicsMediaItem::play()
 {
+    ensurePlayer();
     mMediaObject->play();
     mStopped = false;
 }
 
 void UBGraphicsMediaItem::pause()
 {
-    mMediaObject->pause();
+    if (mMediaObject)
+        mMediaObject->pause();
+
     mStopped = false;
 }
 
 void UBGraphicsMediaItem::stop()
 {
-    mMediaObject->stop();
+    if (mMediaObject)
+        mMediaObject->stop();
+
+    mResumePosition = -1;
+    mResumeDuration = 0;
     mStopped = true;
 }
 
@@ -436,6 +559,8 @@ void UBGraphicsMediaItem::togglePlayPause()
         return;
     }
 
+    ensurePlayer();
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     QMediaPlayer::PlaybackState state = mMediaObject->playbackState();
 #else
@@ -625,7 +750,8 @@ void UBGraphicsVideoItem::setSize(int width, int height)
     else
         sizeY = height;
 
-    mVideoItem->setSize(QSize(sizeX, sizeY));
+    if (mVideoItem)
+        mVideoItem->setSize(QSize(sizeX, sizeY));
 
 
     UBGraphicsMediaItem::setSize(sizeX, sizeY);
@@ -662,6 +788,10 @@ void UBGraphicsVideoItem::paint(QPainter *painter, const QStyleOptionGraphicsIte
     styleOption.state &= ~QStyle::State_Selected;
 
     QGraphicsRectItem::paint(painter, &styleOption, widget);
+
+    if (mPlaceholderVisible)
+        paintPoster(painter);
+
     UBGraphicsMediaItem::paint(painter, option, widget);
 
 }
@@ -669,14 +799,12 @@ void UBGraphicsVideoItem::paint(QPainter *painter, const QStyleOptionGraphicsIte
 QVariant UBGraphicsVideoItem::itemChange(GraphicsItemChange change, const QVariant &value) {
     if (change == QGraphicsItem::ItemVisibleChange
             && value.toBool()
-            && !mHasVideoOutput
-            && UBApplication::app()->boardController
-            && UBApplication::app()->boardController->activeScene() == scene())
+            && !hasPlayer()
+            && isOnActiveScene())
     {
-        //qDebug() << "Item change, setting video output";
+        //qDebug() << "Item change, creating the player";
 
-        mMediaObject->setVideoOutput(mVideoItem);
-        mHasVideoOutput = true;
+        ensurePlayer();
     }
 
     return UBGraphicsMediaItem::itemChange(change, value);
@@ -729,22 +857,11 @@ void UBGraphicsVideoItem::activeSceneChanged()
 {
     //qDebug() << "Active scene changed";
 
-    // Update the visibility of the placeholder, to prevent it being hidden when switching pages
-    setPlaceholderVisible(!mErrorString.isEmpty());
-
-    // Call setVideoOutput, if the video is visible and if it hasn't been called already
-    if (!mHasVideoOutput && UBApplication::boardController->activeScene() == scene()) {
-        //qDebug() << "setting video output";
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        mMediaObject->setSource(mMediaFileUrl);
-#else
-        mMediaObject->setMedia(mMediaFileUrl);
-#endif
-        mMediaObject->setVideoOutput(mVideoItem);
-        mHasVideoOutput = true;
-    }
-
+    // Create or release the player
     UBGraphicsMediaItem::activeSceneChanged();
+
+    // Update the visibility of the placeholder, to prevent it being hidden when switching pages
+    setPlaceholderVisible(!hasPlayer() || !mErrorString.isEmpty());
 }
 
 void UBGraphicsVideoItem::mediaError(QMediaPlayer::Error errorCode)
@@ -762,6 +879,8 @@ void UBGraphicsVideoItem::mediaError(QMediaPlayer::Error errorCode)
  */
 void UBGraphicsVideoItem::setPlaceholderVisible(bool visible)
 {
+    mPlaceholderVisible = visible;
+
     if (visible) {
         setBrush(QColor(Qt::black));
         setPen(QColor(Qt::white));
@@ -772,3 +891,50 @@ void UBGraphicsVideoItem::setPlaceholderVisible(bool visible)
     }
 
 }
+
+/**
+ * @brief Load the poster frame cached next to the video, or extract it in the background
+ */
+void UBGraphicsVideoItem::requestPoster()
+{
+    mPosterRequested = true;
+
+    const QString videoFileName = absoluteMediaFileUrl().toLocalFile();
+
+    if (videoFileName.isEmpty())
+        return;
+
+    mPoster = UBVideoPoster::cachedPoster(videoFileName);
+
+    if (!mPoster.isNull())
+        return;
+
+    QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>(this);
+
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher](){
+        mPoster = watcher->result();
+        watcher->deleteLater();
+        update();
+    });
+
+    watcher->setFuture(QtConcurrent::run([videoFileName](){
+        return UBVideoPoster::createPoster(videoFileName);
+    }));
+}
+
+/**
+ * @brief Draw the poster frame centered in the placeholder, keeping its aspect ratio
+ */
+void UBGraphicsVideoItem::paintPoster(QPainter *painter)
+{
+    if (!mPosterRequested)
+        requestPoster();
+
+    if (mPoster.isNull())
+        return;
+
+    QRectF target(QPointF(), QSizeF(mPoster.size()).scaled(rect().size(), Qt::KeepAspectRatio));
+    target.moveCenter(rect().center());
+
+    painter->drawImage(target, mPoster);
+}
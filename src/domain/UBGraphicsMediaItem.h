@@ -85,13 +85,11 @@ public:
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     QMediaPlayer::PlaybackState playerState() const;
-    bool isPlaying() const { return (mMediaObject->playbackState() == QMediaPlayer::PlayingState); }
-    bool isPaused() const { return (mMediaObject->playbackState() == QMediaPlayer::PausedState); }
 #else
     QMediaPlayer::State playerState() const;
-    bool isPlaying() const { return (mMediaObject->state() == QMediaPlayer::PlayingState); }
-    bool isPaused() const { return (mMediaObject->state() == QMediaPlayer::PausedState); }
 #endif
+    bool isPlaying() const { return (playerState() == QMediaPlayer::PlayingState); }
+    bool isPaused() const { return (playerState() == QMediaPlayer::PausedState); }
 
     bool isStopped() const;
     bool firstLoad() const;
@@ -140,6 +138,15 @@ protected:
 
     virtual void clearSource();
 
+    bool hasPlayer() const { return mMediaObject; }
+    bool isOnActiveScene();
+    QUrl absoluteMediaFileUrl();
+    void ensurePlayer();
+    virtual void createPlayer();
+    virtual void releasePlayer();
+    void applyMute();
+
+    // created only while the item is visible on the active scene
     QMediaPlayer *mMediaObject;
 
     QSize mMinimumSize;
@@ -162,6 +169,10 @@ protected:
 
     qint64 mInitialPos;
 
+    // paused position kept while the player is released, -1 if none
+    qint64 mResumePosition;
+    qint64 mResumeDuration;
+
     QString mErrorString;
 };
 
@@ -180,6 +191,9 @@ public:
     mediaType getMediaType() const { return mediaType_Audio; }
 
     virtual UBItem* deepCopy() const;
+
+protected:
+    virtual void createPlayer();
 };
 
 class UBGraphicsVideoItem: public UBGraphicsMediaItem
@@ -227,9 +241,16 @@ protected:
     virtual void hoverMoveEvent(QGraphicsSceneHoverEvent *event);
     virtual void hoverLeaveEvent(QGraphicsSceneHoverEvent *event);
 
+    virtual void createPlayer();
+    virtual void releasePlayer();
+
     void setPlaceholderVisible(bool visible);
+    void requestPoster();
+    void paintPoster(QPainter *painter);
 
-    bool mHasVideoOutput;
+    bool mPlaceholderVisible;
+    bool mPosterRequested;
+    QImage mPoster;
 };
 
 
@@ -32,6 +32,9 @@
 #include <QtGui>
 #include <QMimeData>
 #include <QDrag>
+#include <QPixmapCache>
+
+#include <cmath>
 
 #include "UBGraphicsScene.h"
 
@@ -46,6 +49,9 @@
 
 #include "core/memcheck.h"
 
+/** Device scale below which the pixmap is painted from a halved resolution level */
+static const qreal sReducedPixmapScale = 0.5;
+
 UBGraphicsPixmapItem::UBGraphicsPixmapItem(QGraphicsItem* parent)
     : QGraphicsPixmapItem(parent)
 {
@@ -124,18 +130,57 @@ void UBGraphicsPixmapItem::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
 void UBGraphicsPixmapItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
+    if (levelOfDetail(painter, this) == LevelOfDetailHidden)
+        return;
+
     painter->setRenderHint(QPainter::Antialiasing, false);
 
-    // Never draw the rubber band, we draw our custom selection with the DelegateFrame
-    QStyleOptionGraphicsItem styleOption = QStyleOptionGraphicsItem(*option);
+    const qreal scale = deviceScale(painter);
+
+    if (scale > 0 && scale <= sReducedPixmapScale && !pixmap().isNull())
+    {
+        // minified at least twice, scaling down a level of half resolutions is much cheaper
+        const int level = qMin(qFloor(std::log2(1 / scale)), 16);
+        const QPixmap reduced = reducedPixmap(level);
+        const QSizeF size = QSizeF(pixmap().size()) / pixmap().devicePixelRatio();
+
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, transformationMode() == Qt::SmoothTransformation);
+        painter->drawPixmap(QRectF(offset(), size), reduced, QRectF(reduced.rect()));
+    }
+    else
+    {
+        // Never draw the rubber band, we draw our custom selection with the DelegateFrame
+        QStyleOptionGraphicsItem styleOption = QStyleOptionGraphicsItem(*option);
+
+        styleOption.state &= ~QStyle::State_Selected;
+        QGraphicsPixmapItem::paint(painter, &styleOption, widget);
+    }
 
-    styleOption.state &= ~QStyle::State_Selected;
-    QGraphicsPixmapItem::paint(painter, &styleOption, widget);
     Delegate()->postpaint(painter, option, widget);
 
     painter->setRenderHint(QPainter::Antialiasing, true);
 }
 
+/**
+ * @brief Pixmap with its resolution halved level times, cached in the pixmap cache
+ */
+QPixmap UBGraphicsPixmapItem::reducedPixmap(int level) const
+{
+    const QPixmap source = pixmap();
+    const QString key = QString("pixmaplod:%1:%2").arg(source.cacheKey()).arg(level);
+    QPixmap reduced;
+
+    if (!QPixmapCache::find(key, &reduced))
+    {
+        const QSize size(qMax(1, source.width() >> level), qMax(1, source.height() >> level));
+
+        reduced = source.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        QPixmapCache::insert(key, reduced);
+    }
+
+    return reduced;
+}
+
 
 UBItem* UBGraphicsPixmapItem::deepCopy() const
 {
@@ -75,6 +75,8 @@ protected:
 
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 
+        QPixmap reducedPixmap(int level) const;
+
         virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 };
 
@@ -36,6 +36,9 @@
 
 #include "core/memcheck.h"
 
+/** Decimation tolerance of reduced polygons, in device pixels */
+static const qreal sDecimationTolerance = 0.5;
+
 UBGraphicsPolygonItem::UBGraphicsPolygonItem (QGraphicsItem * parent)
     : QGraphicsPolygonItem(parent)
     , mHasAlpha(false)
@@ -90,6 +93,7 @@ void UBGraphicsPolygonItem::initialize()
 {
     setData(UBGraphicsItemData::itemLayerType, QVariant(itemLayerType::DrawingItem)); //Necessary to set if we want z value to be assigned correctly
     setUuid(QUuid::createUuid());
+    mDecimatedLevel = std::numeric_limits<int>::min();
 }
 
 void UBGraphicsPolygonItem::setUuid(const QUuid &pUuid)
@@ -182,16 +186,100 @@ void UBGraphicsPolygonItem::copyItemParameters(UBItem *copy) const
     }
 }
 
+void UBGraphicsPolygonItem::writeTo(QDataStream& stream)
+{
+    stream << polygon() << brush() << pen() << static_cast<qint32>(fillRule()) << transform()
+           << mColorOnDarkBackground << mColorOnLightBackground << mHasAlpha
+           << mOriginalLine << mOriginalWidth << mIsNominalLine
+           << zValue() << data(UBGraphicsItemData::ItemOwnZValue) << data(UBGraphicsItemData::ItemLayerType)
+           << data(UBGraphicsItemData::itemLayerType) << uuid() << isVisible();
+}
+
+UBGraphicsPolygonItem* UBGraphicsPolygonItem::readFrom(QDataStream& stream)
+{
+    QPolygonF polygon;
+    QBrush brush;
+    QPen pen;
+    qint32 fillRule;
+    QTransform transform;
+    qreal z;
+    QVariant ownZValue, deprecatedLayerType, layerType;
+    QUuid uuid;
+    bool visible;
+
+    stream >> polygon >> brush >> pen >> fillRule >> transform;
+
+    UBGraphicsPolygonItem* item = new UBGraphicsPolygonItem(polygon);
+
+    stream >> item->mColorOnDarkBackground >> item->mColorOnLightBackground >> item->mHasAlpha
+           >> item->mOriginalLine >> item->mOriginalWidth >> item->mIsNominalLine
+           >> z >> ownZValue >> deprecatedLayerType >> layerType >> uuid >> visible;
+
+    item->setBrush(brush);
+    item->setPen(pen);
+    item->setFillRule(static_cast<Qt::FillRule>(fillRule));
+    item->setTransform(transform);
+    item->setZValue(z);
+    item->setData(UBGraphicsItemData::ItemOwnZValue, ownZValue);
+    item->setData(UBGraphicsItemData::ItemLayerType, deprecatedLayerType);
+    item->setData(UBGraphicsItemData::itemLayerType, layerType);
+    item->setUuid(uuid);
+    item->setVisible(visible);
+
+    return item;
+}
+
 void UBGraphicsPolygonItem::paint ( QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget)
 {
+    const LevelOfDetail lod = levelOfDetail(painter, this);
+
+    if (lod == LevelOfDetailHidden)
+        return;
+
     if(mHasAlpha && scene() && scene()->isLightBackground())
         painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
 
     painter->setRenderHints(QPainter::Antialiasing);
 
+    if (lod == LevelOfDetailReduced && !isSelected())
+    {
+        painter->setPen(pen());
+        painter->setBrush(brush());
+        painter->drawPolygon(decimatedPolygon(deviceScale(painter)), fillRule());
+        return;
+    }
+
     QGraphicsPolygonItem::paint(painter, option, widget);
 }
 
+const QPolygonF& UBGraphicsPolygonItem::decimatedPolygon(qreal deviceScale)
+{
+    const QPolygonF source = polygon();
+
+    if (deviceScale <= 0)
+    {
+        mDecimatedPolygon = source;
+        return mDecimatedPolygon;
+    }
+
+    // the tolerance only changes by octaves of the zoom, so that zooming does not decimate at each frame
+    const int level = qFloor(std::log2(1 / deviceScale));
+
+    // the polygon data is implicitly shared, a new polygon has new data
+    if (level != mDecimatedLevel || source.constData() != mDecimatedSource.constData())
+    {
+        mDecimatedSource = source;
+        mDecimatedLevel = level;
+        mDecimatedPolygon = UBGeometryUtils::simplifyPolygon(source, sDecimationTolerance * std::ldexp(1., level));
+
+        // share the source when nothing was dropped
+        if (mDecimatedPolygon.size() == source.size())
+            mDecimatedPolygon = source;
+    }
+
+    return mDecimatedPolygon;
+}
+
 std::shared_ptr<UBGraphicsScene> UBGraphicsPolygonItem::scene()
 {
     auto scenePtr = dynamic_cast<UBGraphicsScene*>(QGraphicsPolygonItem::scene());
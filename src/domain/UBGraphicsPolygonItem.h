@@ -31,6 +31,7 @@
 #include <QtGui>
 
 #include "core/UB.h"
+#include "frameworks/UBPoolAllocator.h"
 #include "UBItem.h"
 #include "UBGraphicsStrokesGroup.h"
 #include "domain/UBGraphicsGroupContainerItem.h"
@@ -51,6 +52,15 @@ class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
 
         ~UBGraphicsPolygonItem();
 
+        // pages can hold tens of thousands of polygons, they are allocated from a pool
+        static void* operator new(std::size_t size);
+        static void operator delete(void* p, std::size_t size);
+#if defined(WIN32) && defined(_DEBUG)
+        // used by DEBUG_NEW from core/memcheck.h
+        static void* operator new(std::size_t size, int, const char*, int) { return operator new(size); }
+        static void operator delete(void* p, int, const char*, int) { operator delete(p, sizeof(UBGraphicsPolygonItem)); }
+#endif
+
         void initialize();
 
         void setUuid(const QUuid &pUuid);
@@ -134,6 +144,10 @@ class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
         void setStroke(UBGraphicsStroke* stroke);
         UBGraphicsStroke* stroke() const;
 
+        // compact binary form, used to spill removed items of the undo history to disk
+        void writeTo(QDataStream& stream);
+        static UBGraphicsPolygonItem* readFrom(QDataStream& stream);
+
     protected:
         void paint ( QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget);
 
@@ -142,6 +156,9 @@ class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
 
         void clearStroke();
 
+        /** @brief Polygon decimated to half a device pixel, cached until the polygon or the zoom octave changes */
+        const QPolygonF& decimatedPolygon(qreal deviceScale);
+
         bool mHasAlpha;
 
         QLineF mOriginalLine;
@@ -154,6 +171,30 @@ class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
         UBGraphicsStroke* mStroke;
         UBGraphicsStrokesGroup* mpGroup;
 
+        QPolygonF mDecimatedSource;
+        QPolygonF mDecimatedPolygon;
+        int mDecimatedLevel;
+
 };
 
+/** Never deleted, as items may be deleted after static objects */
+inline UBPoolAllocator<sizeof(UBGraphicsPolygonItem)>& polygonItemPool()
+{
+    static auto* pool = new UBPoolAllocator<sizeof(UBGraphicsPolygonItem)>();
+    return *pool;
+}
+
+inline void* UBGraphicsPolygonItem::operator new(std::size_t size)
+{
+    return size == sizeof(UBGraphicsPolygonItem) ? polygonItemPool().allocate() : ::operator new(size);
+}
+
+inline void UBGraphicsPolygonItem::operator delete(void* p, std::size_t size)
+{
+    if (size == sizeof(UBGraphicsPolygonItem))
+        polygonItemPool().deallocate(p);
+    else
+        ::operator delete(p);
+}
+
 #endif // UBGRAPHICSPOLYGONITEM_H
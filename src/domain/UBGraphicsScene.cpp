@@ -35,6 +35,7 @@
 #include <QGraphicsVideoItem>
 
 #include "frameworks/UBGeometryUtils.h"
+#include "frameworks/UBTrace.h"
 
 #include "core/UBApplication.h"
 #include "core/UBSettings.h"
@@ -59,6 +60,7 @@
 #include "board/UBBoardController.h"
 #include "board/UBDrawingController.h"
 #include "board/UBBoardView.h"
+#include "board/UBWetInkOverlay.h"
 
 #include "UBGraphicsItemUndoCommand.h"
 #include "UBGraphicsItemGroupUndoCommand.h"
@@ -389,6 +391,17 @@ UBGraphicsScene::~UBGraphicsScene()
     }
 }
 
+bool UBGraphicsScene::deleteItemsStep(int maxCount)
+{
+    // the cache is deleted by the destructor
+    if (mGraphicsCache)
+    {
+        removeItemFromDeletion(mGraphicsCache);
+    }
+
+    return UBCoreGraphicsScene::deleteItemsStep(maxCount);
+}
+
 void UBGraphicsScene::selectionChangedProcessing()
 {
     if (selectedItems().count()){
@@ -451,6 +464,10 @@ bool UBGraphicsScene::inputDevicePress(const QPointF& scenePos, const qreal& pre
             mAddedItems.clear();
             mRemovedItems.clear();
 
+            mWetInk = (currentTool == UBStylusTool::Pen || currentTool == UBStylusTool::Marker)
+                    && !UBDrawingController::drawingController()->activeRuler()
+                    && UBSettings::settings()->snapshot().wetInk;
+
             if (UBDrawingController::drawingController()->activeRuler())
                 UBDrawingController::drawingController()->activeRuler()->StartLine(scenePos, width);
             else {
@@ -507,6 +524,11 @@ bool UBGraphicsScene::inputDeviceMove(const QPointF& scenePos, const qreal& pres
     QPointF position = QPointF(scenePos);
     mCurrentPoint = position;
 
+#ifdef UB_PROFILING
+    if (mWetInk)
+        UBWetInkOverlay::recordInput();
+#endif
+
     if (currentTool == UBStylusTool::Eraser)
     {
         drawEraser(position, mInputDeviceIsPressed);
@@ -652,17 +674,28 @@ bool UBGraphicsScene::inputDeviceMove(const QPointF& scenePos, const qreal& pres
                     // scenePos, to make the drawing feel more responsive. This line is then deleted if a new segment is
                     // added to the stroke. (Or it is added to the stroke when we stop drawing)
 
-                    if (mTempPolygon) {
-                        removeItem(mTempPolygon);
-                        mTempPolygon = NULL;
-                    }
+                    UBGraphicsPolygonItem* previousTempPolygon = mTempPolygon;
+                    mTempPolygon = NULL;
 
                     if (!mCurrentStroke->points().empty())
                     {
                         QPointF lastDrawnPoint = mCurrentStroke->points().last().first;
 
                         mTempPolygon = lineToPolygonItem(QLineF(lastDrawnPoint, scenePos), mPreviousWidth, width);
-                        addItem(mTempPolygon);
+                    }
+
+                    if (mWetInk) {
+                        foreach (UBWetInkOverlay* overlay, wetInkOverlays())
+                            overlay->setTemporaryPolygon(mTempPolygon);
+
+                        delete previousTempPolygon;
+                    }
+                    else {
+                        if (previousTempPolygon)
+                            removeItem(previousTempPolygon);
+
+                        if (mTempPolygon)
+                            addItem(mTempPolygon);
                     }
                 }
             }
@@ -737,14 +770,23 @@ bool UBGraphicsScene::inputDeviceRelease(int tool, Qt::KeyboardModifiers modifie
         else if (mCurrentStroke){
             if (mTempPolygon) {
                 UBGraphicsPolygonItem * poly = dynamic_cast<UBGraphicsPolygonItem*>(mTempPolygon->deepCopy());
-                removeItem(mTempPolygon);
+
+                if (mWetInk) {
+                    foreach (UBWetInkOverlay* overlay, wetInkOverlays())
+                        overlay->setTemporaryPolygon(NULL);
+
+                    delete mTempPolygon;
+                }
+                else
+                    removeItem(mTempPolygon);
+
                 mTempPolygon = NULL;
                 addPolygonItemToCurrentStroke(poly);
             }
 
             // replace the stroke by a simplified version of it
-            if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardSimplifyPenStrokes->get().toBool())
-                || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardSimplifyMarkerStrokes->get().toBool()))
+            if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->snapshot().simplifyPenStrokes)
+                || (currentTool == UBStylusTool::Marker && UBSettings::settings()->snapshot().simplifyMarkerStrokes))
             {
                 simplifyCurrentStroke();
             }
@@ -755,7 +797,8 @@ bool UBGraphicsScene::inputDeviceRelease(int tool, Qt::KeyboardModifiers modifie
             // Remove the strokes that were just drawn here and replace them by a stroke item
             foreach(UBGraphicsPolygonItem* poly, mCurrentStroke->polygons()){
                 mPreviousPolygonItems.removeAll(poly);
-                removeItem(poly);
+                if (!mWetInk)
+                    removeItem(poly);
                 UBCoreGraphicsScene::removeItemFromDeletion(poly);
                 poly->setStrokesGroup(pStrokes);
                 pStrokes->addToGroup(poly);
@@ -767,6 +810,9 @@ bool UBGraphicsScene::inputDeviceRelease(int tool, Qt::KeyboardModifiers modifie
             mAddedItems << pStrokes;
             addItem(pStrokes);
 
+            if (mWetInk)
+                clearWetInk();
+
             if (mCurrentStroke->polygons().empty()){
                 delete mCurrentStroke;
                 mCurrentStroke = 0;
@@ -791,6 +837,7 @@ bool UBGraphicsScene::inputDeviceRelease(int tool, Qt::KeyboardModifiers modifie
     }
 
     mInputDeviceIsPressed = false;
+    mWetInk = false;
 
     setDocumentUpdated();
 
@@ -1020,8 +1067,20 @@ void UBGraphicsScene::addPolygonItemToCurrentStroke(UBGraphicsPolygonItem* polyg
     mpLastPolygon = polygonItem;
     mAddedItems.insert(polygonItem);
 
-    // Here we add the item to the scene
-    addItem(polygonItem);
+    if (mWetInk)
+    {
+        // The item only enters the scene with its strokes group on pen up. Until then the views
+        // draw it on their wet ink overlay. Its z value is the one the scene would have given it.
+        UBGraphicsItem::assignZValue(polygonItem, mZLayerController->generateZLevel(polygonItem));
+
+        foreach (UBWetInkOverlay* overlay, wetInkOverlays())
+            overlay->addPolygon(polygonItem);
+    }
+    else
+    {
+        // Here we add the item to the scene
+        addItem(polygonItem);
+    }
     if (!mCurrentStroke)
         mCurrentStroke = new UBGraphicsStroke(shared_from_this());
 
@@ -2089,6 +2148,39 @@ QRectF UBGraphicsScene::annotationsBoundingRect() const
     return boundingRect;
 }
 
+UBGraphicsScene::ThumbnailCache& UBGraphicsScene::thumbnailCache()
+{
+    return mThumbnailCache;
+}
+
+/**
+ * @brief Add a repainted area of the control view to the damage of the cached thumbnail
+ *
+ * Changes are only noticed where the view paints, so the cache is dropped as soon as
+ * the view does not show the whole thumbnail area.
+ */
+void UBGraphicsScene::addThumbnailDamage(const QRectF& region, const QRectF& visibleRect)
+{
+    if (mThumbnailCache.image.isNull())
+    {
+        return;
+    }
+
+    if (visibleRect.contains(mThumbnailCache.sceneRect))
+    {
+        mThumbnailCache.damage |= region;
+    }
+    else
+    {
+        dropThumbnailCache();
+    }
+}
+
+void UBGraphicsScene::dropThumbnailCache()
+{
+    mThumbnailCache = ThumbnailCache{};
+}
+
 bool UBGraphicsScene::isEmpty() const
 {
     return mItemCount == 0;
@@ -2916,6 +3008,8 @@ void UBGraphicsScene::drawItems (QPainter * painter, int numItems,
 
 void UBGraphicsScene::drawBackground(QPainter *painter, const QRectF &rect)
 {
+    UBTraceScope trace("UBGraphicsScene::drawBackground");
+
     if (mIsDesktopMode)
     {
         QGraphicsScene::drawBackground (painter, rect);
@@ -2935,123 +3029,159 @@ void UBGraphicsScene::drawBackground(QPainter *painter, const QRectF &rect)
 
     if (mZoomFactor > 0.5)
     {
-        QColor bgCrossColor;
+        const UBSettingsSnapshot& settings = UBSettings::settings()->snapshot();
+        QColor bgCrossColor = darkBackground ? settings.crossColorDarkBackground : settings.crossColorLightBackground;
 
-        if (darkBackground)
-            bgCrossColor = QColor(UBSettings::settings()->boardCrossColorDarkBackground->get().toString());
-        else
-            bgCrossColor = QColor(UBSettings::settings()->boardCrossColorLightBackground->get().toString());
         if (mZoomFactor < 0.7)
         {
             int alpha = 255 * mZoomFactor / 2;
             bgCrossColor.setAlpha (alpha); // fade the crossing on small zooms
         }
 
-        qreal gridSize = backgroundGridSize();
-        painter->setPen (bgCrossColor);
+#ifdef UB_PROFILING
+        QElapsedTimer paintTimer;
+        paintTimer.start();
+#endif
+
+        bool tiled = false;
 
-        if (mPageBackground == UBPageBackground::crossed)
+        if (settings.tiledBackground && mPageBackground != UBPageBackground::plain)
         {
-            qreal firstY = ((int) (rect.y () / gridSize)) * gridSize;
+            UBBackgroundRenderer::Parameters parameters;
+            parameters.background = mPageBackground;
+            parameters.gridSize = backgroundGridSize();
+            parameters.color = bgCrossColor;
+            parameters.intermediateLines = mIntermediateLines;
+            parameters.seyes = settings.seyesRuledBackground;
+            parameters.nominalWidth = mNominalSize.width();
 
-            for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSize)
-            {
-                painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-            }
+            tiled = mBackgroundRenderer.draw(painter, rect, parameters);
+        }
+
+        if (!tiled)
+        {
+            drawBackgroundLines(painter, rect, bgCrossColor);
+        }
+
+#ifdef UB_PROFILING
+        UBBackgroundRenderer::recordPaintTime(tiled, paintTimer.nsecsElapsed());
+#endif
+    }
+}
 
-            qreal firstX = ((int) (rect.x () / gridSize)) * gridSize;
+/**
+ * @brief Draw the lines of the crossed or ruled background one by one
+ *
+ * Used when the background cannot be painted from tiles, e.g. for vector exports.
+ */
+void UBGraphicsScene::drawBackgroundLines(QPainter *painter, const QRectF &rect, const QColor &bgCrossColor)
+{
+    const UBSettingsSnapshot& settings = UBSettings::settings()->snapshot();
+
+    qreal gridSize = backgroundGridSize();
+    painter->setPen (bgCrossColor);
 
-            for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSize)
+    if (mPageBackground == UBPageBackground::crossed)
+    {
+        qreal firstY = ((int) (rect.y () / gridSize)) * gridSize;
+
+        for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSize)
+        {
+            painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+        }
+
+        qreal firstX = ((int) (rect.x () / gridSize)) * gridSize;
+
+        for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSize)
+        {
+            painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
+        }
+
+        if (mIntermediateLines)
+        {
+            QColor intermediateColor = bgCrossColor;
+            intermediateColor.setAlphaF(0.5 * bgCrossColor.alphaF());
+            painter->setPen(intermediateColor);
+
+            for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
             {
-                painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
+                painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
             }
 
-            if (mIntermediateLines)
+            for (qreal xPos = firstX - gridSize/2; xPos < rect.x () + rect.width (); xPos += gridSize)
             {
-                QColor intermediateColor = bgCrossColor;
-                intermediateColor.setAlphaF(0.5 * bgCrossColor.alphaF());
-                painter->setPen(intermediateColor);
-
-                for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
-                {
-                    painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-                }
-
-                for (qreal xPos = firstX - gridSize/2; xPos < rect.x () + rect.width (); xPos += gridSize)
-                {
-                    painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
-                }
+                painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
             }
         }
+    }
 
-        else if (mPageBackground == UBPageBackground::ruled)
+    else if (mPageBackground == UBPageBackground::ruled)
+    {
+        if(settings.seyesRuledBackground)
         {
-            if(UBSettings::settings()->isSeyesRuledBackground())
-            {
-                qreal gridSizeSeyes = gridSize * 2; // The grid size must be bigger
-                int nbMarginCase = 1; // a small left margin of one gridSize
+            qreal gridSizeSeyes = gridSize * 2; // The grid size must be bigger
+            int nbMarginCase = 1; // a small left margin of one gridSize
 
-                QPen seyesSquare ("#8e7cc3");
-                seyesSquare.setWidthF (2.);
+            QPen seyesSquare ("#8e7cc3");
+            seyesSquare.setWidthF (2.);
 
-                QColor interlineColor("#6fa8dc");
-                interlineColor.setAlphaF(0.6);
-                QPen interlinePen(interlineColor);
-                interlinePen.setWidthF(2.);
+            QColor interlineColor("#6fa8dc");
+            interlineColor.setAlphaF(0.6);
+            QPen interlinePen(interlineColor);
+            interlinePen.setWidthF(2.);
 
-                QPen redLineMargin(QColor("red"));
-                redLineMargin.setWidthF(2.);
+            QPen redLineMargin(QColor("red"));
+            redLineMargin.setWidthF(2.);
 
-                // Horizontal lines
+            // Horizontal lines
 
-                qreal firstY = ((int) (rect.y () / gridSizeSeyes)) * gridSizeSeyes;
+            qreal firstY = ((int) (rect.y () / gridSizeSeyes)) * gridSizeSeyes;
 
-                for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSizeSeyes)
-                {
-                    painter->setPen (seyesSquare);
-                    painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-                    painter->setPen (interlinePen);
-                    painter->drawLine (rect.x (), yPos+gridSizeSeyes/4, rect.x () + rect.width (), yPos+gridSizeSeyes/4);
-                    painter->drawLine (rect.x (), yPos+2*gridSizeSeyes/4, rect.x () + rect.width (), yPos+2*gridSizeSeyes/4);
-                    painter->drawLine (rect.x (), yPos+3*gridSizeSeyes/4, rect.x () + rect.width (), yPos+3*gridSizeSeyes/4);
-                }
+            for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSizeSeyes)
+            {
+                painter->setPen (seyesSquare);
+                painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+                painter->setPen (interlinePen);
+                painter->drawLine (rect.x (), yPos+gridSizeSeyes/4, rect.x () + rect.width (), yPos+gridSizeSeyes/4);
+                painter->drawLine (rect.x (), yPos+2*gridSizeSeyes/4, rect.x () + rect.width (), yPos+2*gridSizeSeyes/4);
+                painter->drawLine (rect.x (), yPos+3*gridSizeSeyes/4, rect.x () + rect.width (), yPos+3*gridSizeSeyes/4);
+            }
 
-                // Vertical margin
+            // Vertical margin
 
-                qreal firstX = ((int) nbMarginCase * gridSizeSeyes) - mNominalSize.width() / 2.;
+            qreal firstX = ((int) nbMarginCase * gridSizeSeyes) - mNominalSize.width() / 2.;
 
-                painter->setPen(redLineMargin);
-                painter->drawLine (firstX, rect.y (), firstX, rect.y () + rect.height ());
+            painter->setPen(redLineMargin);
+            painter->drawLine (firstX, rect.y (), firstX, rect.y () + rect.height ());
 
-                // Vertical lines
+            // Vertical lines
 
-                firstX = ((int) (nbMarginCase + 1) * gridSizeSeyes) - mNominalSize.width() / 2.;
+            firstX = ((int) (nbMarginCase + 1) * gridSizeSeyes) - mNominalSize.width() / 2.;
 
-                painter->setPen (seyesSquare);
-                for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSizeSeyes)
-                {
-                    painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
-                }
+            painter->setPen (seyesSquare);
+            for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSizeSeyes)
+            {
+                painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
             }
-            else
+        }
+        else
+        {
+            qreal firstY = ((int) (rect.y () / backgroundGridSize())) * backgroundGridSize();
+
+            for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += backgroundGridSize())
             {
-                qreal firstY = ((int) (rect.y () / backgroundGridSize())) * backgroundGridSize();
+                painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+            }
+
+            if (mIntermediateLines) {
+                QColor intermediateColor = bgCrossColor;
+                intermediateColor.setAlphaF(0.5 * bgCrossColor.alphaF());
+                painter->setPen(intermediateColor);
 
-                for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += backgroundGridSize())
+                for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
                 {
                     painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
                 }
-
-                if (mIntermediateLines) {
-                    QColor intermediateColor = bgCrossColor;
-                    intermediateColor.setAlphaF(0.5 * bgCrossColor.alphaF());
-                    painter->setPen(intermediateColor);
-
-                    for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
-                    {
-                        painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-                    }
-                }
             }
         }
     }
@@ -3071,6 +3201,8 @@ void UBGraphicsScene::keyReleaseEvent(QKeyEvent * keyEvent)
         // Select All scene event
         if(keyEvent->matches(QKeySequence::SelectAll))
         {
+            UBPersistenceManager::persistenceManager()->completeSceneLoading(shared_from_this());
+
             foreach(auto item, items())
             {
                 UBGraphicsItem* ubGraphicsItem = dynamic_cast<UBGraphicsItem*>(item);
@@ -3135,18 +3267,52 @@ void UBGraphicsScene::simplifyCurrentStroke()
     if (!simplerStroke)
         return;
 
-    foreach(UBGraphicsPolygonItem* poly, mCurrentStroke->polygons()){
+    const QList<UBGraphicsPolygonItem*> polygons = mCurrentStroke->polygons();
+
+    foreach(UBGraphicsPolygonItem* poly, polygons){
         mPreviousPolygonItems.removeAll(poly);
-        removeItem(poly);
+        if (!mWetInk)
+            removeItem(poly);
     }
 
     mCurrentStroke = simplerStroke;
 
     foreach(UBGraphicsPolygonItem* poly, mCurrentStroke->polygons()) {
-        addItem(poly);
+        if (!mWetInk)
+            addItem(poly);
         mPreviousPolygonItems.append(poly);
     }
 
+    if (mWetInk)
+    {
+        // the wet polygons never were in the scene, nothing else refers to them
+        clearWetInk();
+        qDeleteAll(polygons);
+    }
+}
+
+/**
+ * @brief Wet ink overlays of the board views showing this scene
+ */
+QList<UBWetInkOverlay*> UBGraphicsScene::wetInkOverlays() const
+{
+    QList<UBWetInkOverlay*> overlays;
+
+    foreach(QGraphicsView* view, views())
+    {
+        UBBoardView* boardView = dynamic_cast<UBBoardView*>(view);
+
+        if (boardView)
+            overlays << boardView->wetInk();
+    }
+
+    return overlays;
+}
+
+void UBGraphicsScene::clearWetInk()
+{
+    foreach(UBWetInkOverlay* overlay, wetInkOverlays())
+        overlay->clear();
 }
 
 void UBGraphicsScene::setDocumentUpdated()
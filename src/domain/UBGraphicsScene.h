@@ -36,6 +36,7 @@
 #include "core/UB.h"
 
 #include "UBItem.h"
+#include "UBBackgroundRenderer.h"
 
 class UBGraphicsPixmapItem;
 class UBGraphicsSvgItem;
@@ -59,6 +60,7 @@ class UBGraphicsCache;
 class UBGraphicsGroupContainerItem;
 class UBSelectionFrame;
 class UBBoardView;
+class UBWetInkOverlay;
 
 const double PI = 4.0 * atan(1.0);
 
@@ -130,6 +132,8 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::en
         UBGraphicsScene(std::shared_ptr<UBDocumentProxy>document, bool enableUndoRedoStack = true);
         virtual ~UBGraphicsScene();
 
+        virtual bool deleteItemsStep(int maxCount);
+
         virtual UBItem* deepCopy() const;
 
         virtual void copyItemParameters(UBItem *copy) const {Q_UNUSED(copy);}
@@ -339,6 +343,24 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::en
 
         QRectF annotationsBoundingRect() const;
 
+        /**
+         * @brief Last persisted thumbnail and the scene area changed since
+         *
+         * Only kept while the scene is shown in the control view, whose paint events
+         * report the changed areas.
+         */
+        struct ThumbnailCache
+        {
+            QImage image{};
+            QRectF sceneRect{};
+            bool darkBackground{false};
+            QRectF damage{};
+        };
+
+        ThumbnailCache& thumbnailCache();
+        void addThumbnailDamage(const QRectF& region, const QRectF& visibleRect);
+        void dropThumbnailCache();
+
 public slots:
         void updateSelectionFrame();
         void updateSelectionFrameWrapper(int);
@@ -422,6 +444,7 @@ signals:
 
 
     private:
+        void drawBackgroundLines(QPainter *painter, const QRectF &rect, const QColor &bgCrossColor);
         void setDocumentUpdated();
         void updateBackground();
         void createEraiser();
@@ -433,6 +456,8 @@ signals:
         void updatePenCircleColor();
         bool hasTextItemWithFocus(UBGraphicsGroupContainerItem* item);
         void simplifyCurrentStroke();
+        QList<UBWetInkOverlay*> wetInkOverlays() const;
+        void clearWetInk();
 
         QGraphicsEllipseItem* mEraser;
         QGraphicsEllipseItem* mPointer; // "laser" pointer
@@ -448,6 +473,7 @@ signals:
         UBPageBackground mPageBackground;
         int mBackgroundGridSize;
         bool mIntermediateLines;
+        UBBackgroundRenderer mBackgroundRenderer;
 
         bool mIsDesktopMode;
         qreal mZoomFactor;
@@ -487,6 +513,9 @@ signals:
         UBZLayerController *mZLayerController;
         UBGraphicsPolygonItem* mpLastPolygon;
         UBGraphicsPolygonItem* mTempPolygon;
+        // the current stroke is drawn by the wet ink overlays of the views until pen up
+        bool mWetInk{false};
+        ThumbnailCache mThumbnailCache{};
 
         bool mDrawWithCompass;
         UBGraphicsPolygonItem *mCurrentPolygon;
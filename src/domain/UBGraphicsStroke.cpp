@@ -37,14 +37,23 @@
 #include "domain/UBGraphicsScene.h"
 
 #include "frameworks/UBGeometryUtils.h"
+#include "frameworks/UBTrace.h"
 
 
 typedef QPair<QPointF, qreal> strokePoint;
 
+/** Largest number of drawn points that can be replaced by a single segment while drawing */
+static const int sMaxPendingPoints = 64;
+
 UBGraphicsStroke::UBGraphicsStroke(std::shared_ptr<UBGraphicsScene> scene)
     :mScene(scene)
+    , mPendingDeviation(0)
+    , mMaxDeviation(0)
 {
     mAntiScaleRatio = 1./(UBApplication::boardController->systemScaleFactor() * UBApplication::boardController->currentZoom());
+
+    // the tolerance is given in pixels on screen
+    mSimplifyTolerance = UBSettings::settings()->snapshot().simplifyStrokesTolerance * mAntiScaleRatio;
 }
 
 
@@ -96,6 +105,7 @@ QList<QPair<QPointF, qreal> > UBGraphicsStroke::addPoint(const QPointF& point, q
     if (n == 0) {
         mReceivedPoints << newPoint;
         mDrawnPoints << newPoint;
+        simplifyIncrementally(newPoint);
         return QList<strokePoint>() << newPoint;
     }
 
@@ -103,6 +113,7 @@ QList<QPair<QPointF, qreal> > UBGraphicsStroke::addPoint(const QPointF& point, q
         strokePoint lastPoint = mReceivedPoints.last();
         mReceivedPoints << newPoint;
         mDrawnPoints << newPoint;
+        simplifyIncrementally(newPoint);
         return QList<strokePoint>() << lastPoint << newPoint;
     }
 
@@ -118,6 +129,7 @@ QList<QPair<QPointF, qreal> > UBGraphicsStroke::addPoint(const QPointF& point, q
             strokePoint p(((lastPoint+point)/2.0), (lastWidth+width)/2.0);
             mReceivedPoints << newPoint;
             mDrawnPoints << p;
+            simplifyIncrementally(p);
 
             return QList<strokePoint>() << mReceivedPoints[0] << p;
         }
@@ -143,8 +155,10 @@ QList<QPair<QPointF, qreal> > UBGraphicsStroke::addPoint(const QPointF& point, q
         if (newPoints.first().first == mDrawnPoints.last().first)
             mDrawnPoints.removeLast();
 
-        foreach(strokePoint p, newPoints)
+        foreach(strokePoint p, newPoints) {
             mDrawnPoints << p;
+            simplifyIncrementally(p);
+        }
 
         mReceivedPoints << strokePoint(point, width);
         return newPoints;
@@ -153,6 +167,49 @@ QList<QPair<QPointF, qreal> > UBGraphicsStroke::addPoint(const QPointF& point, q
     return QList<strokePoint>();
 }
 
+/**
+ * @brief Feed a newly drawn point to the simplified stroke
+ *
+ * The simplified stroke is built while drawing: the drawn points following the last simplified
+ * point are kept pending as long as a single segment, from that point to the newest one, stays
+ * within tolerance of all of them. When it does not, the previous point becomes a simplified point.
+ * Every drawn point is thus checked against a bounded number of pending points.
+ */
+void UBGraphicsStroke::simplifyIncrementally(const strokePoint& point)
+{
+    if (mSimplifiedPoints.isEmpty()) {
+        mSimplifiedPoints << point;
+        return;
+    }
+
+    // interpolated curves may repeat their first point
+    const strokePoint& previous = mPendingPoints.isEmpty() ? mSimplifiedPoints.last() : mPendingPoints.last();
+    if (previous.first == point.first)
+        return;
+
+    const strokePoint& anchor = mSimplifiedPoints.last();
+    qreal deviation = 0;
+    bool withinTolerance = mPendingPoints.size() < sMaxPendingPoints;
+
+    for (int i = 0; i < mPendingPoints.size() && withinTolerance; ++i) {
+        deviation = qMax(deviation, UBGeometryUtils::strokeDeviation(anchor.first, anchor.second, point.first, point.second,
+                mPendingPoints[i].first, mPendingPoints[i].second));
+        withinTolerance = deviation <= mSimplifyTolerance;
+    }
+
+    if (withinTolerance) {
+        mPendingPoints << point;
+        mPendingDeviation = deviation;
+    }
+    else {
+        mSimplifiedPoints << mPendingPoints.last();
+        mMaxDeviation = qMax(mMaxDeviation, mPendingDeviation);
+        mPendingPoints.clear();
+        mPendingPoints << point;
+        mPendingDeviation = 0;
+    }
+}
+
 bool UBGraphicsStroke::hasPressure()
 {
     if (mPolygons.count() > 2)
@@ -207,54 +264,29 @@ UBGraphicsStroke* UBGraphicsStroke::simplify()
         return NULL;
 
     UBGraphicsStroke* newStroke = new UBGraphicsStroke();
-    newStroke->mDrawnPoints = QList<strokePoint>(mDrawnPoints);
 
-    QList<strokePoint>& points = newStroke->mDrawnPoints;
-    //qDebug() << "Simplifying. Before: " << points.size() << " points and " << polygons().size() << " polygons";
-
-    /* Basic simplifying algorithm: consider A, B and C the current point and the two following ones.
-     * If the angle between (AB) and (BC) is lower than a certain threshold,
-     * the three points are considered to be aligned and the middle one (B) is removed.
-     *
-     * We then consider the two following points as the new B and C while keeping the same A, and
-     * test these three points. As long as they are aligned, B is erased and we start over.
-     * If not, the current B becomes the new A, and so on.
-     *
-     * In case the stroke thickness varies a lot between A and B, then B is not removed even if it
-     * should be according to the previous criteria.
-     *
-     * TODO: more advanced algorithm that could also simplify curved sections of the stroke
+    /* The simplified points were computed while drawing: they are the drawn points that cannot be
+     * dropped without moving the outline of the stroke by more than the tolerance. The width is
+     * taken into account, so that pressure variations are kept, and curved sections are simplified
+     * as well as straight ones.
      */
+    qreal maxDeviation = mMaxDeviation;
 
-    // angle difference in degrees between AB and BC below which the segments are considered colinear
-    qreal thresholdAngle = UBSettings::settings()->boardSimplifyPenStrokesThresholdAngle->get().toReal();
-
-    // Relative difference in thickness between two consecutive points (A and B) below which they are considered equal
-    qreal thresholdWidthDifference = UBSettings::settings()->boardSimplifyPenStrokesThresholdWidthDifference->get().toReal();
-
-    QList<strokePoint>::iterator it = points.begin();
-    QList<QList<strokePoint>::iterator> toDelete;
-
-    while (it+2 != points.end()) {
-        // it, b_it and (b_it+1) correspond to A, B and C respectively
-        QList<strokePoint>::iterator b_it(it+1);
-
-        while (b_it+1 != points.end()) {
-            qreal angle = qFabs(180-(UBGeometryUtils::angle(it->first, b_it->first, (b_it+1)->first)));
-            qreal widthRatio = qMax(it->second, b_it->second)/qMin(it->second, b_it->second);
+    if (mSimplifiedPoints.isEmpty()) {
+        // the points were not drawn through addPoint
+        newStroke->mDrawnPoints = UBGeometryUtils::simplifyStroke(mDrawnPoints, mSimplifyTolerance, &maxDeviation);
+    }
+    else {
+        newStroke->mDrawnPoints = mSimplifiedPoints;
 
-            if (angle < thresholdAngle && widthRatio < thresholdWidthDifference)
-                b_it = points.erase(b_it);
-            else
-                break;
-        }
+        if (!mPendingPoints.isEmpty())
+            newStroke->mDrawnPoints << mPendingPoints.last();
 
-        if (b_it+1 == points.end())
-            break;
-        else
-            it = b_it;
+        maxDeviation = qMax(maxDeviation, mPendingDeviation);
     }
 
+    QList<strokePoint>& points = newStroke->mDrawnPoints;
+
     // Next, we iterate over the new points to build the polygons that make up the stroke.
     // A new polygon is created every time drawCurve is true.
 
@@ -321,7 +353,15 @@ UBGraphicsStroke* UBGraphicsStroke::simplify()
         poly->setStroke(newStroke);
     }
 
-    //qDebug() << "After: " << points.size() << " points and " << newStroke->polygons().size() << " polygons";
+#ifdef UB_PROFILING
+    qDebug() << "Stroke simplified from" << mDrawnPoints.size() << "points and" << mPolygons.size() << "polygons to"
+             << points.size() << "points and" << newPolygons.size() << "polygons, largest deviation" << maxDeviation;
+#else
+    Q_UNUSED(maxDeviation)
+#endif
+
+    UBTrace::counter("stroke points dropped", mDrawnPoints.size() - points.size());
+    UBTrace::counter("stroke polygons dropped", mPolygons.size() - newPolygons.size());
 
     return newStroke;
 }
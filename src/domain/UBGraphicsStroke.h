@@ -69,6 +69,7 @@ class UBGraphicsStroke
         void addPolygon(UBGraphicsPolygonItem* pol);
 
     private:
+        void simplifyIncrementally(const QPair<QPointF, qreal>& point);
 
         std::weak_ptr<UBGraphicsScene> mScene;
 
@@ -80,7 +81,16 @@ class UBGraphicsStroke
         /// All the points (including interpolated) that are used to draw the stroke
         QList<QPair<QPointF, qreal> > mDrawnPoints;
 
+        /// Points of the simplified stroke, updated while the stroke is drawn
+        QList<QPair<QPointF, qreal> > mSimplifiedPoints;
+
+        /// Drawn points after the last simplified point, that may still be dropped
+        QList<QPair<QPointF, qreal> > mPendingPoints;
+
         qreal mAntiScaleRatio;
+        qreal mSimplifyTolerance;
+        qreal mPendingDeviation;
+        qreal mMaxDeviation;
 };
 
 #endif /* UBGRAPHICSSTROKE_H_ */
@@ -41,6 +41,9 @@
 #include "core/UBSettings.h"
 
 #include "core/memcheck.h"
+
+#include <cmath>
+
 QColor UBGraphicsTextItem::lastUsedTextColor = QColor(Qt::black);
 
 UBGraphicsTextItem::UBGraphicsTextItem(QGraphicsItem * parent)
@@ -330,7 +333,15 @@ void UBGraphicsTextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem
     styleOption.state &= ~QStyle::State_Selected;
     styleOption.state &= ~QStyle::State_HasFocus;
 
-    QGraphicsTextItem::paint(painter, &styleOption, widget);
+    const LevelOfDetail lod = levelOfDetail(painter, this);
+
+    if (lod == LevelOfDetailHidden)
+        return;
+
+    if (lod == LevelOfDetailReduced && !isSelected() && !hasFocus())
+        paintReduced(painter, &styleOption);
+    else
+        QGraphicsTextItem::paint(painter, &styleOption, widget);
 
     if (widget == UBApplication::boardController->controlView()->viewport() && !isSelected())
     {
@@ -346,6 +357,48 @@ void UBGraphicsTextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem
     Delegate()->postpaint(painter, option, widget);
 }
 
+/**
+ * @brief Paint the text from a bitmap, laid out again only when the text or the zoom octave changes
+ */
+void UBGraphicsTextItem::paintReduced(QPainter *painter, const QStyleOptionGraphicsItem *option)
+{
+    const qreal scale = deviceScale(painter);
+
+    if (scale <= 0)
+        return;
+
+    const QRectF rect = boundingRect();
+    const qreal pixmapScale = std::ldexp(1., qCeil(std::log2(scale)));
+    const QString key = QString("%1:%2:%3:%4x%5")
+            .arg(document()->revision())
+            .arg(defaultTextColor().rgba())
+            .arg(pixmapScale)
+            .arg(rect.width())
+            .arg(rect.height());
+
+    if (key != mReducedPixmapKey)
+    {
+        const QSize size(qMax(1, qCeil(rect.width() * pixmapScale)), qMax(1, qCeil(rect.height() * pixmapScale)));
+
+        mReducedPixmap = QPixmap(size);
+        mReducedPixmap.fill(Qt::transparent);
+
+        QPainter pixmapPainter(&mReducedPixmap);
+        pixmapPainter.setRenderHints(painter->renderHints());
+        pixmapPainter.scale(pixmapScale, pixmapScale);
+        pixmapPainter.translate(-rect.topLeft());
+        QGraphicsTextItem::paint(&pixmapPainter, option, nullptr);
+        pixmapPainter.end();
+
+        mReducedPixmapKey = key;
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawPixmap(QRectF(rect.topLeft(), QSizeF(mReducedPixmap.size()) / pixmapScale), mReducedPixmap, QRectF(mReducedPixmap.rect()));
+    painter->restore();
+}
+
 
 UBItem* UBGraphicsTextItem::deepCopy() const
 {
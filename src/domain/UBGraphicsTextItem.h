@@ -124,11 +124,16 @@ class UBGraphicsTextItem : public QGraphicsTextItem, public UBItem, public UBRes
         virtual void dragMoveEvent(QGraphicsSceneDragDropEvent *event);
 
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+        void paintReduced(QPainter *painter, const QStyleOptionGraphicsItem *option);
 
         virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
         qreal mTextHeight;
 
+        // bitmap of the text painted when the item is small on screen
+        QPixmap mReducedPixmap;
+        QString mReducedPixmapKey;
+
         int mMultiClickState;
         QTime mLastMousePressTime;
 
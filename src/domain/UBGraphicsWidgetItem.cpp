@@ -38,6 +38,7 @@
 #include "UBGraphicsWidgetItemDelegate.h"
 #include "UBGraphicsDelegateFrame.h"
 #include "UBWebEngineView.h"
+#include "UBWidgetViewPool.h"
 
 #include "api/UBWidgetUniboardAPI.h"
 #include "api/UBW3CWidgetAPI.h"
@@ -53,9 +54,6 @@
 #include "frameworks/UBFileSystemUtils.h"
 #include "frameworks/UBPlatformUtils.h"
 
-#include "web/UBWebController.h"
-#include "web/simplebrowser/webpage.h"
-
 bool UBGraphicsWidgetItem::sInlineJavaScriptLoaded = false;
 QStringList UBGraphicsWidgetItem::sInlineJavaScripts;
 
@@ -142,24 +140,18 @@ UBGraphicsWidgetItem::UBGraphicsWidgetItem(const QUrl &pWidgetUrl, QGraphicsItem
     , mLoadIsErronous(false)
     , mCanBeContent(0)
     , mCanBeTool(0)
+    , mWebEngineView(nullptr)
     , mWidgetUrl(pWidgetUrl)
     , mIsFrozen(false)
     , mIsWebActive(true)
     , mShouldMoveWidget(false)
     , mUniboardAPI(nullptr)
 {
-    mWebEngineView = new UBWebEngineView();
-    setWidget(mWebEngineView);
-
+    // the web view is borrowed from UBWidgetViewPool when the widget is shown
     setData(UBGraphicsItemData::ItemLayerType, QVariant(itemLayerType::ObjectItem)); //Necessary to set if we want z value to be assigned correctly
 
-    // create the page using a profile
-    QWebEngineProfile* profile = UBApplication::webController->webProfile();
-    mWebEngineView->setPage(new WebPage(profile, mWebEngineView));
-
     // see https://stackoverflow.com/questions/31928444/qt-qwebenginepagesetwebchannel-transport-object
     mWebChannel = new QWebChannel(this);
-    mWebEngineView->page()->setWebChannel(mWebChannel);
 
     // NOTE to enable fullscreen, we would have to move the page to a fullscreen view.
     // webEngineView->settings()->setAttribute(QWebEngineSettings::FullScreenSupportEnabled, true);
@@ -167,34 +159,17 @@ UBGraphicsWidgetItem::UBGraphicsWidgetItem(const QUrl &pWidgetUrl, QGraphicsItem
     setAcceptDrops(true);
     setAutoFillBackground(false);
 
-    /*
-     * Quick workaround for https://bugreports.qt.io/browse/QTBUG-128241 (bug appearing with Qt 6.7.2, fixed in 6.8.1)
-    */
-#if (QT_VERSION < QT_VERSION_CHECK(6, 7, 2) || QT_VERSION > QT_VERSION_CHECK(6, 8, 0))
-    mWebEngineView->setAttribute(Qt::WA_TranslucentBackground);
-    mWebEngineView->page()->setBackgroundColor(QColor(Qt::transparent));
-#else
-    mWebEngineView->page()->setBackgroundColor(QColor(Qt::white));
-#endif
     setDelegate(new UBGraphicsWidgetItemDelegate(this));
 
     setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
     setAcceptHoverEvents(true);
-
-    // workaround for QTBUG-108284 - to be removed when bug is fixed
-    QWindow* window = mWebEngineView->windowHandle();
-
-    if (window)
-    {
-        window->installEventFilter(this);
-    }
 }
 
 UBGraphicsWidgetItem::~UBGraphicsWidgetItem()
 {
-    // get ownership back and delete widget
+    // give the web view back without taking a snapshot
     setWidget(nullptr);
-    delete mWebEngineView;
+    UBWidgetViewPool::widgetViewPool()->release(this);
 }
 
 void UBGraphicsWidgetItem::initialize()
@@ -205,13 +180,13 @@ void UBGraphicsWidgetItem::initialize()
     if (Delegate() && Delegate()->frame() && resizable())
         Delegate()->frame()->setOperationMode(UBGraphicsDelegateFrame::Resizing);
 
-    // inject the QWebChannel interface and initialization script
-    // see https://doc.qt.io/qt-5.12/qtwebengine-overview.html#script-injection to do that with WebEngine
-    // https://doc.qt.io/qt-5.12/qwebengineprofile.html#scripts
-    UBWebController::injectScripts(mWebEngineView);
+    // the web view is attached later and takes this size
+    mSize = nominalSize();
+    setMaximumSize(mSize);
+    QGraphicsWidget::resize(mSize);
 
-    connect(mWebEngineView->page(), SIGNAL(geometryChangeRequested(QRect)), this, SLOT(geometryChangeRequested(QRect)));
-    connect(mWebEngineView, SIGNAL(loadFinished(bool)), this, SLOT(mainFrameLoadFinished(bool)));
+    if (Delegate())
+        Delegate()->positionHandles();
 }
 
 QUrl UBGraphicsWidgetItem::mainHtml() const
@@ -223,12 +198,17 @@ void UBGraphicsWidgetItem::loadMainHtml()
 {
     qDebug() << "load main HTML";
     mInitialLoadDone = false;
-    mWebEngineView->load(mMainHtmlUrl);
+
+    if (mWebEngineView)
+        mWebEngineView->load(mMainHtmlUrl);
+    else if (isWebActive() && !isFrozen())
+        attachWebView(true);
 }
 
 void UBGraphicsWidgetItem::load(QUrl url)
 {
-    mWebEngineView->load(url);
+    if (mWebEngineView)
+        mWebEngineView->load(url);
 }
 
 QUrl UBGraphicsWidgetItem::widgetUrl() const
@@ -351,7 +331,7 @@ void UBGraphicsWidgetItem::removeAllDatastoreEntries()
 
 void UBGraphicsWidgetItem::runScript(const QString &script)
 {
-    if (mWebEngineView->page())
+    if (mWebEngineView && mWebEngineView->page())
         mWebEngineView->page()->runJavaScript(script);
 }
 
@@ -436,6 +416,11 @@ bool UBGraphicsWidgetItem::isWebActive() const
     return mIsWebActive;
 }
 
+bool UBGraphicsWidgetItem::isWebViewShown() const
+{
+    return mWebEngineView && widget() == mWebEngineView;
+}
+
 const QPixmap &UBGraphicsWidgetItem::snapshot() const
 {
     return mSnapshot;
@@ -443,6 +428,10 @@ const QPixmap &UBGraphicsWidgetItem::snapshot() const
 
 const QPixmap &UBGraphicsWidgetItem::takeSnapshot()
 {
+    // keep the last snapshot while there is nothing to render
+    if (!isWebViewShown() || !mInitialLoadDone)
+        return mSnapshot;
+
     QPixmap pixmap(size().toSize());
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
@@ -466,6 +455,9 @@ void UBGraphicsWidgetItem::updatePosition()
 {
     // partial workaround for QTBUG-109068 to forward the position of the item
     // on the scene to the QWebEngineView
+    if (!mWebEngineView)
+        return;
+
     QSize actualSize = size().toSize();
     mWebEngineView->resize(actualSize - QSize(1,1));
     mWebEngineView->resize(actualSize);
@@ -593,42 +585,161 @@ void UBGraphicsWidgetItem::freeze()
 {
     takeSnapshot();
     mIsFrozen = true;
+    detachWebView();
 }
 
 void UBGraphicsWidgetItem::unFreeze()
 {
     mIsFrozen = false;
+    update();
 }
 
 void UBGraphicsWidgetItem::setWebActive(bool active)
 {
     if (active != mIsWebActive)
     {
+        mIsWebActive = active;
+
         if (active)
         {
-            // activate the web engine view
-            setWidget(mWebEngineView);
+            // the web view is attached when the widget is painted
             setVisible(true);
+            update();
         }
         else
         {
-            // deactivate the web engine view
-            setWidget(nullptr);
-            mWebEngineView->setVisible(false);
+            detachWebView();
         }
-
-        mIsWebActive = active;
     }
 }
 
 void UBGraphicsWidgetItem::inspectPage()
 {
-    mWebEngineView->inspectPage();
+    if (mWebEngineView)
+        mWebEngineView->inspectPage();
 }
 
 void UBGraphicsWidgetItem::closeInspector()
 {
-    mWebEngineView->closeInspector();
+    if (mWebEngineView)
+        mWebEngineView->closeInspector();
+}
+
+/**
+ * @brief Show a web view from the pool in place of the snapshot
+ *
+ * A view which was taken back by the pool is reset, so the page is loaded again. The widget
+ * APIs read the preferences and datastore from this item, which restores the widget state.
+ */
+void UBGraphicsWidgetItem::attachWebView(bool evictShown)
+{
+    if (isWebViewShown())
+    {
+        UBWidgetViewPool::widgetViewPool()->touch(this);
+        return;
+    }
+
+    const bool reload = !mWebEngineView;
+    mWebEngineView = UBWidgetViewPool::widgetViewPool()->acquire(this, evictShown);
+
+    if (!mWebEngineView)
+    {
+        return;
+    }
+
+    if (reload)
+    {
+        mInitialLoadDone = false;
+        mWebEngineView->page()->setWebChannel(mWebChannel);
+
+        connect(mWebEngineView->page(), SIGNAL(geometryChangeRequested(QRect)), this, SLOT(geometryChangeRequested(QRect)));
+        connect(mWebEngineView, SIGNAL(loadFinished(bool)), this, SLOT(mainFrameLoadFinished(bool)));
+    }
+
+    mWebEngineView->setMinimumSize(minimumSize().toSize());
+    mWebEngineView->setMaximumSize(mSize.toSize());
+    mWebEngineView->resize(mSize.toSize());
+    setWidget(mWebEngineView);
+
+    // workaround for QTBUG-108284 - to be removed when bug is fixed
+    QWindow* window = mWebEngineView->windowHandle();
+
+    if (window)
+    {
+        window->installEventFilter(this);
+    }
+
+    if (reload)
+    {
+        mWebEngineView->load(mMainHtmlUrl);
+        injectInlineJavaScript();
+    }
+}
+
+/**
+ * @brief Show the snapshot instead of the web view
+ *
+ * The page keeps running, so that the widget resumes where it was if it is attached
+ * again before the pool needs its view for another widget.
+ */
+void UBGraphicsWidgetItem::detachWebView()
+{
+    if (!isWebViewShown())
+        return;
+
+    if (!mIsFrozen)
+        takeSnapshot();
+
+    mSize = mWebEngineView->size();
+
+    QWindow* window = mWebEngineView->windowHandle();
+
+    if (window)
+    {
+        window->removeEventFilter(this);
+    }
+
+    setWidget(nullptr);
+    mWebEngineView->setVisible(false);
+
+    // keep the geometry of the detached widget
+    setMaximumSize(mSize);
+    QGraphicsWidget::resize(mSize);
+    update();
+}
+
+/**
+ * @brief Called by the pool when it takes the web view back
+ */
+void UBGraphicsWidgetItem::releaseWebView()
+{
+    if (!mWebEngineView)
+        return;
+
+    detachWebView();
+
+    mWebEngineView->page()->disconnect(this);
+    mWebEngineView->disconnect(this);
+    mWebEngineView = nullptr;
+    mInitialLoadDone = false;
+}
+
+/**
+ * @brief Attach a web view once the current paint is done
+ */
+void UBGraphicsWidgetItem::requestWebView()
+{
+    if (mWebViewRequested)
+        return;
+
+    mWebViewRequested = true;
+
+    QTimer::singleShot(0, this, [this](){
+        mWebViewRequested = false;
+
+        if (isWebActive() && !isFrozen() && isVisible() && QGraphicsItem::scene())
+            attachWebView(false);
+    });
 }
 
 bool UBGraphicsWidgetItem::event(QEvent *event)
@@ -768,6 +879,10 @@ void UBGraphicsWidgetItem::keyPressEvent(QKeyEvent *event)
 
 void UBGraphicsWidgetItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
+    // a widget which is used gets a web view, even if another one has to give it back
+    if (isWebActive() && !isFrozen())
+        attachWebView(true);
+
     if (!Delegate()->mousePressEvent(event))
         setSelected(true); /* forcing selection */
 
@@ -815,20 +930,44 @@ void UBGraphicsWidgetItem::injectInlineJavaScript()
         sInlineJavaScriptLoaded = true;
     }
 
+    if (!mWebEngineView)
+        return;
+
     foreach(QString script, sInlineJavaScripts)
         mWebEngineView->page()->runJavaScript(script);
 }
 
 void UBGraphicsWidgetItem::paint( QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    if (isFrozen() || !isWebActive())
+    const LevelOfDetail lod = levelOfDetail(painter, this);
+
+    if (lod == LevelOfDetailHidden)
+        return;
+
+    const bool live = !isFrozen() && isWebActive();
+
+    // a widget too small on screen to be used shows its snapshot
+    const bool reduced = lod == LevelOfDetailReduced && !snapshot().isNull();
+
+    // only widgets painted in a view get a web view, not those rendered to thumbnails
+    if (live && widget && !reduced && !isWebViewShown())
+    {
+        requestWebView();
+    }
+
+    if (!live || reduced)
     {
         painter->drawPixmap(0, 0, snapshot());
     }
-    else if (mInitialLoadDone)
+    else if (isWebViewShown() && mInitialLoadDone)
     {
         QGraphicsProxyWidget::paint(painter, option, widget);
     }
+    else if (!snapshot().isNull())
+    {
+        // until the page is loaded
+        painter->drawPixmap(0, 0, snapshot());
+    }
     else
     {
         QString message;
@@ -871,6 +1010,11 @@ bool UBGraphicsWidgetItem::eventFilter(QObject *obj, QEvent *ev)
     return QGraphicsProxyWidget::eventFilter(obj, ev);
 }
 
+QWebChannel* UBGraphicsWidgetItem::webChannel() const
+{
+    return mWebChannel;
+}
+
 void UBGraphicsWidgetItem::geometryChangeRequested(const QRect& geom)
 {
     resize(geom.width(), geom.height());
@@ -883,7 +1027,7 @@ void UBGraphicsWidgetItem::registerAPI()
     if (!mUniboardAPI)
     {
         mUniboardAPI = new UBWidgetUniboardAPI(scene(), this);
-        mWebEngineView->page()->webChannel()->registerObject("sankore", mUniboardAPI);
+        mWebChannel->registerObject("sankore", mUniboardAPI);
     }
     else
     {
@@ -924,6 +1068,9 @@ QVariant UBGraphicsWidgetItem::itemChange(GraphicsItemChange change, const QVari
             scene()->setActiveWindow(nullptr);
     } else if (change == QGraphicsItem::ItemTransformHasChanged) {
         updatePosition();
+    } else if (change == QGraphicsItem::ItemSceneHasChanged && !value.value<QGraphicsScene*>()) {
+        // let the pool reuse the view of a widget removed from its scene
+        detachWebView();
     }
 
     QVariant newValue = Delegate()->itemChange(change, value);
@@ -939,8 +1086,19 @@ void UBGraphicsWidgetItem::resize(qreal w, qreal h)
 void UBGraphicsWidgetItem::resize(const QSizeF & pSize)
 {
     if (pSize != size()) {
-        mWebEngineView->setMaximumSize(pSize.width(), pSize.height());
-        mWebEngineView->resize(pSize.width(), pSize.height());
+        mSize = pSize;
+
+        if (isWebViewShown())
+        {
+            mWebEngineView->setMaximumSize(pSize.width(), pSize.height());
+            mWebEngineView->resize(pSize.width(), pSize.height());
+        }
+        else
+        {
+            setMaximumSize(pSize);
+            QGraphicsWidget::resize(pSize);
+        }
+
         if (Delegate())
             Delegate()->positionHandles();
         if (scene())
@@ -950,7 +1108,7 @@ void UBGraphicsWidgetItem::resize(const QSizeF & pSize)
 
 QSizeF UBGraphicsWidgetItem::size() const
 {
-    return mWebEngineView->size();
+    return isWebViewShown() ? QSizeF(mWebEngineView->size()) : mSize;
 }
 
 
@@ -982,8 +1140,6 @@ UBGraphicsAppleWidgetItem::UBGraphicsAppleWidgetItem(const QUrl& pWidgetUrl, QGr
     mMainHtmlUrl = pWidgetUrl;
     mMainHtmlUrl.setPath(pWidgetUrl.path() + "/" + mMainHtmlFileName);
 
-    mWebEngineView->load(mMainHtmlUrl);
-
     QPixmap defaultPixmap(pWidgetUrl.toLocalFile() + "/Default.png");
 
     setMaximumSize(defaultPixmap.size());
@@ -1007,7 +1163,7 @@ void UBGraphicsAppleWidgetItem::setUuid(const QUuid &pUuid)
 
 UBItem* UBGraphicsAppleWidgetItem::deepCopy() const
 {
-    UBGraphicsAppleWidgetItem *appleWidget = new UBGraphicsAppleWidgetItem(mWebEngineView->url(), parentItem());
+    UBGraphicsAppleWidgetItem *appleWidget = new UBGraphicsAppleWidgetItem(mMainHtmlUrl, parentItem());
 
     copyItemParameters(appleWidget);
 
@@ -1175,8 +1331,6 @@ UBGraphicsW3CWidgetItem::UBGraphicsW3CWidgetItem(const QUrl& pWidgetUrl, QGraphi
     if (!f.exists())
         mMainHtmlUrl = QUrl(mMainHtmlFileName);
 
-    mWebEngineView->load(mMainHtmlUrl);
-
     mNominalSize = QSize(width, height);
     setMaximumSize(mNominalSize);
 
@@ -1427,7 +1581,7 @@ void UBGraphicsW3CWidgetItem::registerAPI()
     if (!mW3CWidgetAPI)
     {
         mW3CWidgetAPI = new UBW3CWidgetAPI(this);
-        mWebEngineView->page()->webChannel()->registerObject("widget", mW3CWidgetAPI);
+        webChannel()->registerObject("widget", mW3CWidgetAPI);
     }
 }
 
@@ -61,6 +61,8 @@ class UBGraphicsWidgetItem : public QGraphicsProxyWidget, public UBItem, public
 {
     Q_OBJECT
 
+    friend class UBWidgetViewPool;
+
     public:
         UBGraphicsWidgetItem(const QUrl &pWidgetUrl = QUrl(), QGraphicsItem *parent = 0);
         ~UBGraphicsWidgetItem();
@@ -122,6 +124,7 @@ class UBGraphicsWidgetItem : public QGraphicsProxyWidget, public UBItem, public
         bool isFrozen() const;
         void setFreezable(bool freezable);
         bool isWebActive() const;
+        bool isWebViewShown() const;
 
         const QPixmap& snapshot() const;
         void setSnapshot(const QPixmap& pix, bool frozen);
@@ -197,15 +200,24 @@ class UBGraphicsWidgetItem : public QGraphicsProxyWidget, public UBItem, public
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0) override;
         virtual bool eventFilter(QObject *obj, QEvent *ev) override;
 
+        QWebChannel* webChannel() const;
+
     protected slots:
         void geometryChangeRequested(const QRect& geom);
         virtual void registerAPI();
         void mainFrameLoadFinished(bool ok);
 
     private:
+        void attachWebView(bool evictShown);
+        void detachWebView();
+        void releaseWebView();
+        void requestWebView();
+
         bool mIsFrozen;
         bool mIsWebActive;
         bool mShouldMoveWidget;
+        bool mWebViewRequested{false};
+        QSizeF mSize;
         QWebChannel* mWebChannel;
         UBWidgetUniboardAPI* mUniboardAPI;
         QPixmap mSnapshot;
@@ -41,6 +41,10 @@
 #include "domain/UBGraphicsScene.h"
 #include "tools/UBGraphicsCurtainItem.h"
 #include "domain/UBGraphicsItemDelegate.h"
+#include "core/UBSettings.h"
+
+/** On-screen size in pixels below which an item is not painted at all */
+static const qreal sSubPixelSize = 0.5;
 
 UBItem::UBItem()
     : mUuid(QUuid::createUuid())
@@ -54,6 +58,64 @@ UBItem::~UBItem()
     // NOOP
 }
 
+UBItem::LevelOfDetail UBItem::levelOfDetail(const QPainter* painter, const QRectF& deviceRect)
+{
+    const QPaintDevice* device = painter->device();
+
+    if (!device)
+        return LevelOfDetailFull;
+
+    switch (device->devType())
+    {
+    case QInternal::Widget:
+    case QInternal::Pixmap:
+    case QInternal::Image:
+    case QInternal::OpenGL:
+    case QInternal::FramebufferObject:
+        break;
+
+    default:
+        // printing and vector exports keep the full detail
+        return LevelOfDetailFull;
+    }
+
+    const qreal size = qMax(deviceRect.width(), deviceRect.height());
+
+    if (size < sSubPixelSize)
+        return LevelOfDetailHidden;
+
+    if (size < UBSettings::settings()->snapshot().levelOfDetailSize)
+        return LevelOfDetailReduced;
+
+    return LevelOfDetailFull;
+}
+
+UBItem::LevelOfDetail UBItem::levelOfDetail(const QPainter* painter, const QGraphicsItem* item)
+{
+    const QGraphicsItem* lodItem = levelOfDetailItem(item);
+    const QRectF bounds = lodItem == item ? item->boundingRect() : item->mapRectFromItem(lodItem, lodItem->boundingRect());
+
+    return levelOfDetail(painter, painter->worldTransform().mapRect(bounds));
+}
+
+const QGraphicsItem* UBItem::levelOfDetailItem(const QGraphicsItem* item)
+{
+    const QGraphicsItem* parent = item->parentItem();
+
+    if (parent && parent->type() == UBGraphicsStrokesGroup::Type)
+        return parent;
+
+    return item;
+}
+
+qreal UBItem::deviceScale(const QPainter* painter)
+{
+    const QTransform& transform = painter->worldTransform();
+
+    // geometric mean of both axes, so that rotations and flips do not matter
+    return qSqrt(qAbs(transform.determinant()));
+}
+
 UBGraphicsItem::~UBGraphicsItem()
 {
     if (mDelegate!=NULL)
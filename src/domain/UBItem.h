@@ -58,6 +58,33 @@ class UBItem
             nbrCacheBehavior
         };
 
+        enum LevelOfDetail
+        {
+            LevelOfDetailHidden = 0, LevelOfDetailReduced, LevelOfDetailFull
+        };
+
+        /**
+         * @brief Level of detail to paint a rectangle with, given its size in device pixels
+         *
+         * Sub-pixel rectangles are hidden, those smaller than the LevelOfDetailSize setting
+         * get a reduced level. Printers and vector devices always get the full level.
+         */
+        static LevelOfDetail levelOfDetail(const QPainter* painter, const QRectF& deviceRect);
+
+        /**
+         * @brief Level of detail of an item painted with the current transform of the painter
+         *
+         * The polygons of a strokes group get the level of the whole group, so that a stroke
+         * is not partly hidden or reduced.
+         */
+        static LevelOfDetail levelOfDetail(const QPainter* painter, const QGraphicsItem* item);
+
+        /** @brief Item whose bounds decide the level of detail of *item*, its strokes group if any */
+        static const QGraphicsItem* levelOfDetailItem(const QGraphicsItem* item);
+
+        /** @brief Device pixels per item unit for the current transform of the painter */
+        static qreal deviceScale(const QPainter* painter);
+
         virtual QUuid uuid() const
         {
                 return mUuid;
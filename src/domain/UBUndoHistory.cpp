@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBUndoHistory.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QGraphicsItem>
+#include <QTemporaryFile>
+
+#include "core/UBMimeData.h"
+#include "core/UBSettings.h"
+#include "domain/UBGraphicsItemUndoCommand.h"
+#include "domain/UBItem.h"
+#include "frameworks/UBFileSystemUtils.h"
+
+#include "core/memcheck.h"
+
+UBUndoHistory* UBUndoHistory::sHistory = nullptr;
+
+/** Number of most recent commands never spilled, as they are the most likely to be undone */
+static const int sHotCommandCount = 16;
+
+UBUndoHistory::UBUndoHistory(QUndoStack* stack, QObject* parent)
+    : QObject{parent}
+    , mStack{stack}
+{
+    sHistory = this;
+
+    connect(stack, &QUndoStack::indexChanged, this, &UBUndoHistory::enforceBudget);
+}
+
+UBUndoHistory::~UBUndoHistory()
+{
+    if (sHistory == this)
+    {
+        sHistory = nullptr;
+    }
+
+    delete mSpillFile;
+}
+
+UBUndoHistory* UBUndoHistory::history()
+{
+    return sHistory;
+}
+
+qint64 UBUndoHistory::memoryBudget() const
+{
+    return UBSettings::settings()->undoMemoryBudget->get().toLongLong() * 1024 * 1024;
+}
+
+qint64 UBUndoHistory::memoryUsage() const
+{
+    return mMemoryUsage;
+}
+
+/**
+ * @brief Account for a change of the cost of an undo command, from its creation to its deletion
+ */
+void UBUndoHistory::addMemoryUsage(qint64 delta)
+{
+    mMemoryUsage += delta;
+}
+
+qint64 UBUndoHistory::writeSpill(const QByteArray& data)
+{
+    if (!mSpillFile)
+    {
+        QDir().mkpath(UBFileSystemUtils::defaultTempDirPath());
+        mSpillFile = new QTemporaryFile(UBFileSystemUtils::defaultTempDirPath() + "/undo-XXXXXX.spill");
+
+        if (!mSpillFile->open())
+        {
+            qWarning() << "cannot create undo spill file" << mSpillFile->fileName();
+            delete mSpillFile;
+            mSpillFile = nullptr;
+            return -1;
+        }
+    }
+
+    const qint64 offset = mSpillFile->size();
+
+    if (!mSpillFile->seek(offset) || mSpillFile->write(data) != data.size())
+    {
+        qWarning() << "cannot write undo spill file" << mSpillFile->errorString();
+        return -1;
+    }
+
+    return offset;
+}
+
+QByteArray UBUndoHistory::readSpill(qint64 offset, qint64 size)
+{
+    if (!mSpillFile || !mSpillFile->seek(offset))
+    {
+        return {};
+    }
+
+    return mSpillFile->read(size);
+}
+
+bool UBUndoHistory::isInClipboard(QGraphicsItem* item)
+{
+    // copied items are referenced by the clipboard, not duplicated
+    const auto mimeData = qobject_cast<const UBMimeDataGraphicsItem*>(QApplication::clipboard()->mimeData());
+    const auto ubItem = dynamic_cast<UBItem*>(item);
+
+    return mimeData && ubItem && mimeData->items().contains(ubItem);
+}
+
+void UBUndoHistory::enforceBudget()
+{
+    if (!mStack)
+    {
+        return;
+    }
+
+    if (mStack->count() == 0)
+    {
+        // stack was cleared, spilled data is obsolete
+        delete mSpillFile;
+        mSpillFile = nullptr;
+        return;
+    }
+
+    const qint64 budget = memoryBudget();
+
+    if (budget <= 0)
+    {
+        return;
+    }
+
+    // the commands are walked only when over budget, and not again while nothing more can be spilled
+    if (mMemoryUsage <= budget || mMemoryUsage == mUnspillableUsage)
+    {
+        return;
+    }
+
+    const auto commands = itemCommands(mStack->count());
+
+    // items shared by several commands cannot be deleted
+    QHash<QGraphicsItem*, int> references;
+
+    for (const auto command : commands)
+    {
+        for (const auto item : command->GetAddedList())
+        {
+            references[item]++;
+        }
+
+        for (const auto item : command->GetRemovedList())
+        {
+            references[item]++;
+        }
+    }
+
+    // only the removed items of done commands are off the scene, spill the oldest first
+    for (const auto command : itemCommands(qMax(0, mStack->index() - sHotCommandCount)))
+    {
+        if (mMemoryUsage <= budget)
+        {
+            break;
+        }
+
+        if (command->isSpilled())
+        {
+            continue;
+        }
+
+        QSet<QGraphicsItem*> items;
+
+        for (const auto item : command->GetRemovedList())
+        {
+            if (references.value(item) == 1 && !item->scene() && !item->parentItem() && !isInClipboard(item))
+            {
+                items << item;
+            }
+        }
+
+        // the command reports the freed memory
+        command->spill(items);
+    }
+
+    mUnspillableUsage = mMemoryUsage > budget ? mMemoryUsage : -1;
+}
+
+QList<UBGraphicsItemUndoCommand*> UBUndoHistory::itemCommands(int count) const
+{
+    QList<UBGraphicsItemUndoCommand*> commands;
+
+    for (int i = 0; i < count && i < mStack->count(); ++i)
+    {
+        collectItemCommands(mStack->command(i), commands);
+    }
+
+    return commands;
+}
+
+void UBUndoHistory::collectItemCommands(const QUndoCommand* command, QList<UBGraphicsItemUndoCommand*>& commands) const
+{
+    // commands are owned by the stack, casting away the constness to spill them is safe
+    const auto itemCommand = dynamic_cast<const UBGraphicsItemUndoCommand*>(command);
+
+    if (itemCommand)
+    {
+        commands << const_cast<UBGraphicsItemUndoCommand*>(itemCommand);
+    }
+
+    // macros hold their commands as children
+    for (int i = 0; i < command->childCount(); ++i)
+    {
+        collectItemCommands(command->child(i), commands);
+    }
+}
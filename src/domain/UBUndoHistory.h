@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QUndoStack>
+
+class QGraphicsItem;
+class QTemporaryFile;
+class UBGraphicsItemUndoCommand;
+
+/**
+ * Keeps the memory held by the undo stack within a budget.
+ *
+ * Undo commands report the cost of the items they keep alive as it changes, so that
+ * the history keeps a running total. Above UBSettings::undoMemoryBudget, the removed
+ * items of the oldest commands are serialized to a spill file and deleted. A command
+ * rehydrates its items when the user undoes that far.
+ */
+class UBUndoHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UBUndoHistory(QUndoStack* stack, QObject* parent = nullptr);
+    virtual ~UBUndoHistory();
+
+    static UBUndoHistory* history();
+
+    qint64 memoryBudget() const;
+    qint64 memoryUsage() const;
+    void addMemoryUsage(qint64 delta);
+
+    qint64 writeSpill(const QByteArray& data);
+    QByteArray readSpill(qint64 offset, qint64 size);
+
+    static bool isInClipboard(QGraphicsItem* item);
+
+public slots:
+    void enforceBudget();
+
+private:
+    QList<UBGraphicsItemUndoCommand*> itemCommands(int count) const;
+    void collectItemCommands(const QUndoCommand* command, QList<UBGraphicsItemUndoCommand*>& commands) const;
+
+    QPointer<QUndoStack> mStack{};
+    QTemporaryFile* mSpillFile{nullptr};
+    qint64 mMemoryUsage{0};
+    qint64 mUnspillableUsage{-1};
+
+    static UBUndoHistory* sHistory;
+};
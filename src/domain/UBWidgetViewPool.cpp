@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBWidgetViewPool.h"
+
+#include <QWebChannel>
+
+#include "core/UBApplication.h"
+#include "core/UBSettings.h"
+#include "domain/UBGraphicsWidgetItem.h"
+#include "domain/UBWebEngineView.h"
+#include "web/UBWebController.h"
+#include "web/simplebrowser/webpage.h"
+
+#include "core/memcheck.h"
+
+UBWidgetViewPool* UBWidgetViewPool::sWidgetViewPool = nullptr;
+
+/** Number of unused views kept to be reused */
+static const int sMaxIdleViews = 2;
+
+UBWidgetViewPool* UBWidgetViewPool::widgetViewPool()
+{
+    if (!sWidgetViewPool)
+    {
+        sWidgetViewPool = new UBWidgetViewPool();
+    }
+
+    return sWidgetViewPool;
+}
+
+void UBWidgetViewPool::destroy()
+{
+    delete sWidgetViewPool;
+    sWidgetViewPool = nullptr;
+}
+
+UBWidgetViewPool::UBWidgetViewPool()
+    : QObject{nullptr}
+{
+}
+
+UBWidgetViewPool::~UBWidgetViewPool()
+{
+    while (!mOwners.isEmpty())
+    {
+        release(mOwners.first());
+    }
+
+    qDeleteAll(mIdleViews);
+}
+
+/**
+ * @brief Get the view of *owner*, assigning one if it has none
+ *
+ * When all views are used, the least recently used one which is not shown is taken
+ * from its owner. Shown views are only taken if *evictShown* is set, so that widgets
+ * painted at the same time do not take the views from each other.
+ *
+ * @return the view, or nullptr if none is available
+ */
+UBWebEngineView* UBWidgetViewPool::acquire(UBGraphicsWidgetItem* owner, bool evictShown)
+{
+    UBWebEngineView* view = mViews.value(owner);
+
+    if (view)
+    {
+        touch(owner);
+        return view;
+    }
+
+    const int maxViews = qMax(1, UBSettings::settings()->boardMaxLiveWidgets->get().toInt());
+
+    if (!mIdleViews.isEmpty())
+    {
+        view = mIdleViews.takeLast();
+    }
+    else if (mViews.size() < maxViews)
+    {
+        view = createView();
+    }
+    else
+    {
+        UBGraphicsWidgetItem* victim = nullptr;
+
+        for (UBGraphicsWidgetItem* candidate : std::as_const(mOwners))
+        {
+            if (!candidate->isWebViewShown())
+            {
+                victim = candidate;
+                break;
+            }
+        }
+
+        if (!victim && evictShown && !mOwners.isEmpty())
+        {
+            victim = mOwners.first();
+        }
+
+        if (!victim)
+        {
+            return nullptr;
+        }
+
+        view = mViews.take(victim);
+        mOwners.removeOne(victim);
+        victim->releaseWebView();
+        recycle(view);
+    }
+
+    mViews.insert(owner, view);
+    mOwners.append(owner);
+
+    return view;
+}
+
+/**
+ * @brief Take back the view of *owner*
+ */
+void UBWidgetViewPool::release(UBGraphicsWidgetItem* owner)
+{
+    UBWebEngineView* view = mViews.take(owner);
+
+    if (!view)
+    {
+        return;
+    }
+
+    mOwners.removeOne(owner);
+    owner->releaseWebView();
+
+    if (mIdleViews.size() < sMaxIdleViews)
+    {
+        recycle(view);
+        mIdleViews.append(view);
+    }
+    else
+    {
+        delete view;
+    }
+}
+
+/**
+ * @brief Mark the view of *owner* as recently used
+ */
+void UBWidgetViewPool::touch(UBGraphicsWidgetItem* owner)
+{
+    if (mOwners.removeOne(owner))
+    {
+        mOwners.append(owner);
+    }
+}
+
+UBWebEngineView* UBWidgetViewPool::createView() const
+{
+    UBWebEngineView* view = new UBWebEngineView();
+
+    // create the page using a profile
+    QWebEngineProfile* profile = UBApplication::webController()->webProfile();
+    view->setPage(new WebPage(profile, view));
+
+    /*
+     * Quick workaround for https://bugreports.qt.io/browse/QTBUG-128241 (bug appearing with Qt 6.7.2, fixed in 6.8.1)
+    */
+#if (QT_VERSION < QT_VERSION_CHECK(6, 7, 2) || QT_VERSION > QT_VERSION_CHECK(6, 8, 0))
+    view->setAttribute(Qt::WA_TranslucentBackground);
+    view->page()->setBackgroundColor(QColor(Qt::transparent));
+#else
+    view->page()->setBackgroundColor(QColor(Qt::white));
+#endif
+
+    // inject the QWebChannel interface and initialization script
+    UBWebController::injectScripts(view);
+
+    return view;
+}
+
+/**
+ * @brief Reset a view so that nothing of its previous owner remains
+ */
+void UBWidgetViewPool::recycle(UBWebEngineView* view)
+{
+    view->page()->setWebChannel(nullptr);
+    view->setMinimumSize(0, 0);
+    view->setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
+    view->setUrl(QUrl("about:blank"));
+}
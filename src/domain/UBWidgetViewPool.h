@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+
+class UBGraphicsWidgetItem;
+class UBWebEngineView;
+
+/**
+ * Bounded pool of the web views used by the widgets on the board.
+ *
+ * Each web view runs its own renderer, so widgets do not own one. A widget borrows a
+ * view when it is shown or used and keeps it until the pool reclaims it for another
+ * widget. Reclaimed widgets are painted from their snapshot and reload their page,
+ * with their preferences and datastore, when they get a view again.
+ *
+ * The number of views is limited by the Board/MaxLiveWidgets setting. Views that are no
+ * longer used are reset and a few of them are kept to be reused on the next page.
+ */
+class UBWidgetViewPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    static UBWidgetViewPool* widgetViewPool();
+    static void destroy();
+
+    UBWebEngineView* acquire(UBGraphicsWidgetItem* owner, bool evictShown);
+    void release(UBGraphicsWidgetItem* owner);
+    void touch(UBGraphicsWidgetItem* owner);
+
+private:
+    UBWidgetViewPool();
+    virtual ~UBWidgetViewPool();
+
+    UBWebEngineView* createView() const;
+    void recycle(UBWebEngineView* view);
+
+    static UBWidgetViewPool* sWidgetViewPool;
+
+    /** Owners of a view, least recently used first */
+    QList<UBGraphicsWidgetItem*> mOwners{};
+    QHash<UBGraphicsWidgetItem*, UBWebEngineView*> mViews{};
+    QList<UBWebEngineView*> mIdleViews{};
+};
@@ -25,6 +25,9 @@ HEADERS += src/domain/UBGraphicsScene.h \
     src/domain/UBGraphicsMediaItemDelegate.h \
     src/domain/UBSelectionFrame.h \
     src/domain/UBUndoCommand.h \
+    src/domain/UBUndoHistory.h \
+    src/domain/UBBackgroundRenderer.h \
+    src/domain/UBWidgetViewPool.h \
     src/domain/UBGraphicsItemZLevelUndoCommand.h
 
 SOURCES += src/domain/UBGraphicsScene.cpp \
@@ -54,4 +57,7 @@ SOURCES += src/domain/UBGraphicsScene.cpp \
     src/domain/UBGraphicsWidgetItemDelegate.cpp \
     src/domain/UBSelectionFrame.cpp \
     src/domain/UBUndoCommand.cpp \
+    src/domain/UBUndoHistory.cpp \
+    src/domain/UBBackgroundRenderer.cpp \
+    src/domain/UBWidgetViewPool.cpp \
     src/domain/UBGraphicsItemZLevelUndoCommand.cpp
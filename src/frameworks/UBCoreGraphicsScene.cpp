@@ -38,6 +38,7 @@
 UBCoreGraphicsScene::UBCoreGraphicsScene(QObject * parent)
     : QGraphicsScene ( parent  )
     , mIsModified(false)
+    , mIsTearingDown(false)
 {
     //NOOP
 }
@@ -114,3 +115,51 @@ void UBCoreGraphicsScene::addItemToDeletion(QGraphicsItem *item)
         mItemsToDelete.insert(item);
     }
 }
+
+/**
+ * Delete up to maxCount of the items owned by the scene, so that a scene which is no
+ * longer used can be torn down in small steps instead of at once in the destructor.
+ * The scene must not be used afterwards, except for further steps and its deletion.
+ *
+ * Returns true when all owned items are deleted.
+ */
+bool UBCoreGraphicsScene::deleteItemsStep(int maxCount)
+{
+    if (!mIsTearingDown)
+    {
+        mIsTearingDown = true;
+
+        // nobody listens anymore, and removing items from a linear index is cheaper
+        blockSignals(true);
+        clearSelection();
+        setItemIndexMethod(NoIndex);
+    }
+
+    int deleted = 0;
+
+    while (deleted < maxCount && !mItemsToDelete.isEmpty())
+    {
+        auto it = mItemsToDelete.begin();
+        QGraphicsItem* item = *it;
+        mItemsToDelete.erase(it);
+
+        if (item && (item->scene() == NULL || item->scene() == this))
+        {
+            // children are deleted with their parent
+            forgetChildItems(item);
+            delete item;
+            ++deleted;
+        }
+    }
+
+    return mItemsToDelete.isEmpty();
+}
+
+void UBCoreGraphicsScene::forgetChildItems(QGraphicsItem *item)
+{
+    foreach (QGraphicsItem* child, item->childItems())
+    {
+        mItemsToDelete.remove(child);
+        forgetChildItems(child);
+    }
+}
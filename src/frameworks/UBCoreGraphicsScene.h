@@ -49,6 +49,8 @@ class UBCoreGraphicsScene : public QGraphicsScene
         void removeItemFromDeletion(QGraphicsItem* item);
         void addItemToDeletion(QGraphicsItem *item);
 
+        virtual bool deleteItemsStep(int maxCount);
+
         bool isModified() const
         {
             return mIsModified;
@@ -61,9 +63,12 @@ class UBCoreGraphicsScene : public QGraphicsScene
 
 
     private:
+        void forgetChildItems(QGraphicsItem* item);
+
         QSet<QGraphicsItem*> mItemsToDelete;
 
         bool mIsModified;
+        bool mIsTearingDown;
 };
 
 #endif /* UBCOREGRAPHICSSCENE_H_ */
@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBFileOperation.h"
+
+#include <QDeadlineTimer>
+#include <QDirIterator>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <mutex>
+
+#include "frameworks/UBFileSystemUtils.h"
+#include "frameworks/UBTrace.h"
+
+#include "core/memcheck.h"
+
+/** Threads of the I/O pool shared by all operations */
+static const int sIOThreadCount = 4;
+
+/** Maximal number of files processed by one task of the I/O pool */
+static const int sMaxFilesPerBatch = 16;
+
+UBFileOperation* UBFileOperation::copyDir(const QString& sourceDir, const QString& targetDir, bool overwrite, QObject* parent)
+{
+    UBFileOperation* operation = new UBFileOperation(Copy, overwrite, parent);
+    operation->mSource = QDir::cleanPath(sourceDir);
+    operation->mTarget = QDir::cleanPath(targetDir);
+    operation->start();
+    return operation;
+}
+
+/**
+ * @brief Copy a list of files given as pairs of source and target, creating the target directories
+ */
+UBFileOperation* UBFileOperation::copyFiles(const QList<QPair<QString, QString>>& files, bool overwrite, QObject* parent)
+{
+    UBFileOperation* operation = new UBFileOperation(Copy, overwrite, parent);
+    operation->mFiles = files;
+    operation->start();
+    return operation;
+}
+
+UBFileOperation* UBFileOperation::deleteDir(const QString& dir, QObject* parent)
+{
+    UBFileOperation* operation = new UBFileOperation(Delete, false, parent);
+    operation->mSource = QDir::cleanPath(dir);
+    operation->start();
+    return operation;
+}
+
+UBFileOperation::UBFileOperation(Kind kind, bool overwrite, QObject* parent)
+    : QObject{parent}
+    , mKind{kind}
+    , mOverwrite{overwrite}
+{
+}
+
+UBFileOperation::~UBFileOperation()
+{
+    cancel();
+    mFuture.waitForFinished();
+}
+
+void UBFileOperation::cancel()
+{
+    mCanceled = true;
+}
+
+bool UBFileOperation::isCanceled() const
+{
+    return mCanceled;
+}
+
+/**
+ * @brief Wait until the operation is finished, returns false on timeout
+ *
+ * A negative timeout waits forever.
+ */
+bool UBFileOperation::wait(int msecs)
+{
+    QDeadlineTimer deadline(msecs < 0 ? QDeadlineTimer::Forever : QDeadlineTimer(msecs));
+    QMutexLocker locker(&mMutex);
+
+    while (!mFinished)
+    {
+        if (!mFinishedCondition.wait(&mMutex, deadline))
+        {
+            break;
+        }
+    }
+
+    return mFinished;
+}
+
+/**
+ * @brief Whether the operation has finished without error and without being canceled
+ */
+bool UBFileOperation::isSuccessful() const
+{
+    QMutexLocker locker(&mMutex);
+    return mFinished && !mFailed && !mCanceled;
+}
+
+void UBFileOperation::start()
+{
+    mFuture = QtConcurrent::run([this](){ run(); });
+}
+
+void UBFileOperation::run()
+{
+    UBTraceScope trace(mKind == Copy ? "UBFileOperation::copy" : "UBFileOperation::delete");
+
+    if (!collect())
+    {
+        mFailed = true;
+    }
+
+    const int total = mFiles.size();
+    emit progress(0, total);
+
+    // several batches per thread, so that large files are spread over the threads
+    const int batchSize = qBound(1, total / (sIOThreadCount * 4), sMaxFilesPerBatch);
+    QList<QFuture<bool>> batches;
+
+    for (int begin = 0; !mFailed && begin < total; begin += batchSize)
+    {
+        const int end = qMin(begin + batchSize, total);
+        batches << QtConcurrent::run(ioPool(), [this, begin, end](){ return processBatch(begin, end); });
+    }
+
+    for (auto& batch : batches)
+    {
+        batch.waitForFinished();
+        emit progress(mDone, total);
+    }
+
+    if (mKind == Delete && !mFailed && !mCanceled && !removeDirectories())
+    {
+        mFailed = true;
+    }
+
+    bool success;
+
+    {
+        QMutexLocker locker(&mMutex);
+        mFinished = true;
+        success = !mFailed && !mCanceled;
+        mFinishedCondition.wakeAll();
+    }
+
+    emit finished(success);
+}
+
+/**
+ * @brief List the files of the source directory, creating the target directories of a copy
+ */
+bool UBFileOperation::collect()
+{
+    if (mSource.isNull())
+    {
+        // list of files given
+        return true;
+    }
+
+    if (mSource.isEmpty() || mSource == "." || mSource == "..")
+    {
+        return false;
+    }
+
+    if (mKind == Copy)
+    {
+        if (!QDir().mkpath(mTarget))
+        {
+            return false;
+        }
+
+        // symbolic links to directories are not followed, a link to a parent would never end
+        QDirIterator it(mSource, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden,
+                        QDirIterator::Subdirectories);
+
+        while (it.hasNext() && !mCanceled)
+        {
+            const QString path = it.next();
+            const QString target = mTarget + path.mid(mSource.size());
+
+            if (it.fileInfo().isDir() && it.fileInfo().isSymLink())
+            {
+                if (!QFile::link(it.fileInfo().symLinkTarget(), target))
+                {
+                    return false;
+                }
+            }
+            else if (it.fileInfo().isDir())
+            {
+                if (!QDir().mkpath(target))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                mFiles << qMakePair(path, target);
+            }
+        }
+    }
+    else
+    {
+        if (!QFileInfo(mSource).isDir())
+        {
+            return false;
+        }
+
+        // symbolic links are deleted, not followed
+        QDirIterator it(mSource, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                        QDirIterator::Subdirectories);
+
+        while (it.hasNext() && !mCanceled)
+        {
+            const QString path = it.next();
+
+            if (it.fileInfo().isDir() && !it.fileInfo().isSymLink())
+            {
+                mDirectories << path;
+            }
+            else
+            {
+                mFiles << qMakePair(path, QString());
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Copy or delete the files in the range, stops at the first error
+ *
+ * Runs on the I/O pool.
+ */
+bool UBFileOperation::processBatch(int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        if (mCanceled || mFailed)
+        {
+            return false;
+        }
+
+        const QPair<QString, QString>& file = mFiles.at(i);
+        bool ok;
+
+        if (mKind == Copy)
+        {
+            ok = UBFileSystemUtils::copyFile(file.first, file.second, mOverwrite);
+        }
+        else
+        {
+            ok = UBFileSystemUtils::deleteFile(file.first);
+        }
+
+        if (!ok)
+        {
+            qWarning() << "file operation failed on" << file.first;
+            mFailed = true;
+            return false;
+        }
+
+        ++mDone;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove the emptied directories, deepest first
+ */
+bool UBFileOperation::removeDirectories()
+{
+    // a subdirectory has a longer path than its parent
+    std::sort(mDirectories.begin(), mDirectories.end(), [](const QString& a, const QString& b){
+        return a.size() > b.size();
+    });
+
+    mDirectories << mSource;
+
+    for (const QString& directory : std::as_const(mDirectories))
+    {
+        if (!QDir().rmdir(directory))
+        {
+            qWarning() << "could not remove directory" << directory;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QThreadPool* UBFileOperation::ioPool()
+{
+    static QThreadPool pool;
+    static std::once_flag configured;
+
+    std::call_once(configured, [](){
+        pool.setMaxThreadCount(sIOThreadCount);
+    });
+
+    return &pool;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QFuture>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QStringList>
+#include <QWaitCondition>
+
+#include <atomic>
+
+class QThreadPool;
+
+/**
+ * Copies or deletes files and directory trees in the background.
+ *
+ * The files are processed in batches on a small pool of I/O threads shared by all
+ * operations. An operation starts when it is created, reports its progress with the
+ * progress signal and can be canceled at any time. Cancellation takes effect between
+ * two files, so a canceled copy may leave a part of the files at the target.
+ *
+ * Deleting an operation cancels it and waits for the files being processed.
+ */
+class UBFileOperation : public QObject
+{
+    Q_OBJECT
+
+public:
+    static UBFileOperation* copyDir(const QString& sourceDir, const QString& targetDir, bool overwrite = false, QObject* parent = nullptr);
+    static UBFileOperation* copyFiles(const QList<QPair<QString, QString>>& files, bool overwrite = false, QObject* parent = nullptr);
+    static UBFileOperation* deleteDir(const QString& dir, QObject* parent = nullptr);
+
+    virtual ~UBFileOperation();
+
+    void cancel();
+    bool isCanceled() const;
+    bool wait(int msecs = -1);
+    bool isSuccessful() const;
+
+signals:
+    void progress(int done, int total);
+    void finished(bool success);
+
+private:
+    enum Kind
+    {
+        Copy,
+        Delete
+    };
+
+    UBFileOperation(Kind kind, bool overwrite, QObject* parent);
+
+    void start();
+    void run();
+    bool collect();
+    bool processBatch(int begin, int end);
+    bool removeDirectories();
+
+    static QThreadPool* ioPool();
+
+    const Kind mKind;
+    const bool mOverwrite;
+    QString mSource{};
+    QString mTarget{};
+
+    // files to copy as source and target, or files to delete as source only
+    QList<QPair<QString, QString>> mFiles{};
+    QStringList mDirectories{};
+
+    std::atomic<bool> mCanceled{false};
+    std::atomic<bool> mFailed{false};
+    std::atomic<int> mDone{0};
+
+    QFuture<void> mFuture{};
+    mutable QMutex mMutex{};
+    QWaitCondition mFinishedCondition{};
+    bool mFinished{false};
+};
@@ -43,6 +43,14 @@ THIRD_PARTY_WARNINGS_DISABLE
 #endif
 THIRD_PARTY_WARNINGS_ENABLE
 
+#ifdef Q_OS_LINUX
+    #include <fcntl.h>
+    #include <linux/fs.h>
+    #include <sys/ioctl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #include "core/memcheck.h"
 
 QStringList UBFileSystemUtils::sTempDirToCleanUp;
@@ -119,7 +127,77 @@ bool UBFileSystemUtils::copyFile(const QString &source, const QString &destinati
             }
         }
     }
-    return QFile::copy(source, normalizedDestination);
+    return copyFileContent(source, normalizedDestination);
+}
+
+/**
+ * @brief Copy a file to a destination that does not exist
+ *
+ * On Linux, the file is cloned when the file system supports it (btrfs, XFS), otherwise
+ * the data is copied in the kernel without passing through user space.
+ */
+bool UBFileSystemUtils::copyFileContent(const QString& source, const QString& destination)
+{
+#ifdef Q_OS_LINUX
+    int sourceFd = ::open(QFile::encodeName(source).constData(), O_RDONLY | O_CLOEXEC);
+
+    if (sourceFd >= 0)
+    {
+        struct stat sourceStat;
+        int targetFd = -1;
+
+        if (::fstat(sourceFd, &sourceStat) == 0 && S_ISREG(sourceStat.st_mode))
+        {
+            targetFd = ::open(QFile::encodeName(destination).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                              sourceStat.st_mode & 07777);
+        }
+
+        if (targetFd >= 0)
+        {
+            bool copied = false;
+
+#ifdef FICLONE
+            copied = ::ioctl(targetFd, FICLONE, sourceFd) == 0;
+#endif
+
+            if (!copied)
+            {
+                off_t remaining = sourceStat.st_size;
+
+                while (remaining > 0)
+                {
+                    ssize_t written = ::copy_file_range(sourceFd, nullptr, targetFd, nullptr, remaining, 0);
+
+                    if (written <= 0)
+                    {
+                        break;
+                    }
+
+                    remaining -= written;
+                }
+
+                copied = remaining == 0;
+            }
+
+            ::close(targetFd);
+            ::close(sourceFd);
+
+            if (copied)
+            {
+                return true;
+            }
+
+            // e.g. copy_file_range not supported by the kernel, use the portable copy
+            QFile::remove(destination);
+        }
+        else
+        {
+            ::close(sourceFd);
+        }
+    }
+#endif
+
+    return QFile::copy(source, destination);
 }
 
 bool UBFileSystemUtils::copy(const QString &source, const QString &destination, bool overwrite)
@@ -323,6 +401,12 @@ bool UBFileSystemUtils::copyDir(const QString& pSourceDirPath, const QString& pT
 
 bool UBFileSystemUtils::moveDir(const QString& pSourceDirPath, const QString& pTargetDirPath)
 {
+    // renaming is enough on the same file system
+    if (!QFileInfo::exists(pTargetDirPath) && QDir().rename(pSourceDirPath, pTargetDirPath))
+    {
+        return true;
+    }
+
     bool copySuccess = copyDir(pSourceDirPath, pTargetDirPath);
 
     if (copySuccess)
@@ -113,6 +113,8 @@ class UBFileSystemUtils : public QObject
         static QString readTextFile(QString path);
 
     private:
+        static bool copyFileContent(const QString& source, const QString& destination);
+
         static QStringList sTempDirToCleanUp;
 
 };
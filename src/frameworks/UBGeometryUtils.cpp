@@ -29,153 +29,169 @@
 
 #include "UBGeometryUtils.h"
 
+#include <vector>
+
 #include "core/memcheck.h"
 
 const double PI = 4.0 * atan(1.0);
-const int UBGeometryUtils::centimeterGraduationHeight = 15;
-const int UBGeometryUtils::halfCentimeterGraduationHeight = 10;
-const int UBGeometryUtils::millimeterGraduationHeight = 5;
-const int UBGeometryUtils::millimetersPerCentimeter = 10;
-const int UBGeometryUtils::millimetersPerHalfCentimeter = 5;
-const float UBGeometryUtils::inchSize = 25.4f;
 
-UBGeometryUtils::UBGeometryUtils()
-{
-    // NOOP
-}
+/** Largest distance between a round stroke cap and the polygon approximating it */
+static const qreal sCapTolerance = 0.25;
 
-UBGeometryUtils::~UBGeometryUtils()
-{
-    // NOOP
-}
+/** Number of samples per output point used to measure a Bézier curve's length */
+static const int sBezierSamplesPerPoint = 16;
 
-QPolygonF UBGeometryUtils::lineToPolygon(const QLineF& pLine, const qreal& pWidth)
+/**
+ * @brief Compute the unit normal (u) and unit direction (f) of a segment
+ *
+ * Like QLineF::angle(), a null segment is considered to point along the x axis.
+ */
+static void segmentFrame(qreal x1, qreal y1, qreal x2, qreal y2, qreal& ux, qreal& uy, qreal& fx, qreal& fy)
 {
-    qreal x1 = pLine.x1();
-    qreal y1 = pLine.y1();
+    const qreal dx = x2 - x1;
+    const qreal dy = y2 - y1;
+    const qreal length = std::sqrt(dx * dx + dy * dy);
 
-    qreal x2 = pLine.x2();
-    qreal y2 = pLine.y2();
+    fx = length > 0 ? dx / length : 1;
+    fy = length > 0 ? dy / length : 0;
 
-    qreal alpha = (90.0 - pLine.angle()) * PI / 180.0;
-    qreal hypothenuse = pWidth / 2;
-
-    // TODO UB 4.x PERF cache sin/cos table
-    qreal opposite = sin(alpha) * hypothenuse;
-    qreal adjacent = cos(alpha) * hypothenuse;
-
-    QPointF p1a(x1 - adjacent, y1 - opposite);
-    QPointF p1b(x1 + adjacent, y1 + opposite);
-
-    QPointF p2a(x2 - adjacent, y2 - opposite);
-    QPointF p2b(x2 + adjacent, y2 + opposite);
-
-    QPainterPath painterPath;
+    // same orientation as QLineF::normalVector()
+    ux = fy;
+    uy = -fx;
+}
 
-    painterPath.moveTo(p1a);
-    painterPath.lineTo(p2a);
+/**
+ * @brief Number of segments needed to approximate a semi-circle of the given radius
+ */
+static int capSegments(qreal radius)
+{
+    if (radius <= sCapTolerance)
+        return 2;
 
-    painterPath.arcTo(x2 - hypothenuse, y2 - hypothenuse, pWidth, pWidth, (90.0 + pLine.angle()), -180.0);
+    const qreal step = 2 * std::acos(1 - sCapTolerance / radius);
 
-    //painterPath.lineTo(p2b);
-    painterPath.lineTo(p1b);
+    return qBound(2, int(std::ceil(PI / step)), 64);
+}
 
-    painterPath.arcTo(x1 - hypothenuse, y1 - hypothenuse, pWidth, pWidth, -1 * (90.0 - pLine.angle()), -180.0);
+/**
+ * @brief Write the inner vertices of a semi-circle around (cx, cy) to out, and return the next position
+ *
+ * The semi-circle goes from the side u to the side -u passing by the direction f; its two ends
+ * are not written, as they are the stroke vertices on each side.
+ */
+static QPointF* appendCap(QPointF* out, qreal cx, qreal cy, qreal radius,
+        qreal ux, qreal uy, qreal fx, qreal fy, int segments)
+{
+    for (int k = 1; k < segments; ++k) {
+        const qreal phi = PI * k / segments;
+        const qreal c = std::cos(phi) * radius;
+        const qreal s = std::sin(phi) * radius;
 
-    painterPath.closeSubpath();
+        *out++ = QPointF(cx + ux * c + fx * s, cy + uy * c + fy * s);
+    }
 
-    return painterPath.toFillPolygon();
+    return out;
 }
 
-
-
-QPolygonF UBGeometryUtils::lineToPolygon(const QLineF& pLine, const qreal& pStartWidth, const qreal& pEndWidth)
+/**
+ * @brief Ramer-Douglas-Peucker simplification of count points with optional widths
+ *
+ * Marks in keep the points to retain so that no dropped point deviates from the simplified line
+ * by more than tolerance, and returns the largest deviation of a dropped point.
+ */
+static qreal markKeptPoints(const QPointF* points, const qreal* widths, int count, qreal tolerance, std::vector<bool>& keep)
 {
-    qreal x1 = pLine.x1();
-    qreal y1 = pLine.y1();
+    keep.assign(count, false);
 
-    qreal x2 = pLine.x2();
-    qreal y2 = pLine.y2();
+    if (count == 0)
+        return 0;
 
-    qreal alpha = (90.0 - pLine.angle()) * PI / 180.0;
-    qreal startHypothenuse = pStartWidth / 2;
-    qreal endHypothenuse = pEndWidth / 2;
+    keep[0] = true;
+    keep[count - 1] = true;
 
-    // TODO UB 4.x PERF cache sin/cos table
-    qreal startOpposite = sin(alpha) * startHypothenuse;
-    qreal startAdjacent = cos(alpha) * startHypothenuse;
+    qreal maxDeviation = 0;
 
-    qreal endOpposite = sin(alpha) * endHypothenuse;
-    qreal endAdjacent = cos(alpha) * endHypothenuse;
+    // explicit stack of ranges, so that long strokes do not recurse deeply
+    std::vector<std::pair<int, int> > ranges;
+    ranges.emplace_back(0, count - 1);
 
-    QPointF p1a(x1 - startAdjacent, y1 - startOpposite);
-    QPointF p1b(x1 + startAdjacent, y1 + startOpposite);
+    while (!ranges.empty()) {
+        const int first = ranges.back().first;
+        const int last = ranges.back().second;
+        ranges.pop_back();
 
-    QPointF p2a(x2 - endAdjacent, y2 - endOpposite);
-    QPointF p2b(x2 + endAdjacent, y2 + endOpposite);
+        const qreal firstWidth = widths ? widths[first] : 0;
+        const qreal lastWidth = widths ? widths[last] : 0;
 
-    QPainterPath painterPath;
-    painterPath.moveTo(p1a);
-    painterPath.lineTo(p2a);
+        qreal farthest = 0;
+        int farthestIndex = -1;
 
-    painterPath.arcTo(x2 - endHypothenuse, y2 - endHypothenuse, pEndWidth, pEndWidth, (90.0 + pLine.angle()), -180.0);
+        for (int i = first + 1; i < last; ++i) {
+            const qreal deviation = UBGeometryUtils::strokeDeviation(points[first], firstWidth, points[last], lastWidth,
+                    points[i], widths ? widths[i] : 0);
 
-    //painterPath.lineTo(p2b);
-    painterPath.lineTo(p1b);
-
-    painterPath.arcTo(x1 - startHypothenuse, y1 - startHypothenuse, pStartWidth, pStartWidth, -1 * (90.0 - pLine.angle()), -180.0);
+            if (deviation > farthest) {
+                farthest = deviation;
+                farthestIndex = i;
+            }
+        }
 
-    painterPath.closeSubpath();
+        if (farthestIndex >= 0 && farthest > tolerance) {
+            keep[farthestIndex] = true;
+            ranges.emplace_back(first, farthestIndex);
+            ranges.emplace_back(farthestIndex, last);
+        }
+        else
+            maxDeviation = qMax(maxDeviation, farthest);
+    }
 
-    return painterPath.toFillPolygon();
+    return maxDeviation;
 }
 
-QPolygonF UBGeometryUtils::lineToPolygon(const QPointF& pStart, const QPointF& pEnd,
-        const qreal& pStartWidth, const qreal& pEndWidth)
+static QPointF quadraticBezierPoint(const QPointF& p0, const QPointF& p1, const QPointF& p2, qreal t)
 {
+    const qreal mt = 1 - t;
 
-    qreal x1 = pStart.x();
-    qreal y1 = pStart.y();
-
-    qreal x2 = pEnd.x();
-    qreal y2 = pEnd.y();
-
-    QLineF line(pStart, pEnd);
-
-    qreal alpha = (90.0 - line.angle()) * PI / 180.0;
-    qreal hypothenuseStart = pStartWidth / 2;
-
-    qreal hypothenuseEnd = pEndWidth / 2;
-
-    qreal sinAlpha = sin(alpha);
-    qreal cosAlpha = cos(alpha);
-
-    // TODO UB 4.x PERF cache sin/cos table
-    qreal oppositeStart = sinAlpha * hypothenuseStart;
-    qreal adjacentStart = cosAlpha * hypothenuseStart;
-
-    QPointF p1a(x1 - adjacentStart, y1 - oppositeStart);
-    QPointF p1b(x1 + adjacentStart, y1 + oppositeStart);
+    return mt * mt * p0 + 2 * mt * t * p1 + t * t * p2;
+}
 
-    qreal oppositeEnd = sinAlpha * hypothenuseEnd;
-    qreal adjacentEnd = cosAlpha * hypothenuseEnd;
+const int UBGeometryUtils::centimeterGraduationHeight = 15;
+const int UBGeometryUtils::halfCentimeterGraduationHeight = 10;
+const int UBGeometryUtils::millimeterGraduationHeight = 5;
+const int UBGeometryUtils::millimetersPerCentimeter = 10;
+const int UBGeometryUtils::millimetersPerHalfCentimeter = 5;
+const float UBGeometryUtils::inchSize = 25.4f;
 
-    QPointF p2a(x2 - adjacentEnd, y2 - oppositeEnd);
+UBGeometryUtils::UBGeometryUtils()
+{
+    // NOOP
+}
 
-    QPainterPath painterPath;
+UBGeometryUtils::~UBGeometryUtils()
+{
+    // NOOP
+}
 
-    painterPath.moveTo(p1a);
-    painterPath.lineTo(p2a);
+QPolygonF UBGeometryUtils::lineToPolygon(const QLineF& pLine, const qreal& pWidth)
+{
+    return lineToPolygon(pLine.p1(), pLine.p2(), pWidth, pWidth);
+}
 
-    painterPath.arcTo(x2 - hypothenuseEnd, y2 - hypothenuseEnd, pEndWidth, pEndWidth, (90.0 + line.angle()), -180.0);
 
-    painterPath.lineTo(p1b);
 
-    painterPath.arcTo(x1 - hypothenuseStart, y1 - hypothenuseStart, pStartWidth, pStartWidth, -1 * (90.0 - line.angle()), -180.0);
+QPolygonF UBGeometryUtils::lineToPolygon(const QLineF& pLine, const qreal& pStartWidth, const qreal& pEndWidth)
+{
+    return lineToPolygon(pLine.p1(), pLine.p2(), pStartWidth, pEndWidth);
+}
 
-    painterPath.closeSubpath();
+QPolygonF UBGeometryUtils::lineToPolygon(const QPointF& pStart, const QPointF& pEnd,
+        const qreal& pStartWidth, const qreal& pEndWidth)
+{
+    const qreal x[2] = { pStart.x(), pEnd.x() };
+    const qreal y[2] = { pStart.y(), pEnd.y() };
+    const qreal widths[2] = { pStartWidth, pEndWidth };
 
-    return painterPath.toFillPolygon();
+    return strokeToPolygon(x, y, widths, 2, true, true);
 }
 
 QPolygonF UBGeometryUtils::arcToPolygon(const QLineF& startRadius, qreal spanAngleInDegrees, qreal width)
@@ -251,17 +267,15 @@ QPolygonF UBGeometryUtils::curveToPolygon(const QList<QPointF>& points, qreal st
     if (n_points < 2)
         return QPolygonF();
 
-    if (n_points == 2)
-        return lineToPolygon(points[0], points[1], startWidth, endWidth);
+    std::vector<qreal> x(n_points), y(n_points), widths(n_points);
 
-    QList<QPair<QPointF, qreal> > pointsAndWidths;
     for (int i(0); i < n_points; ++i) {
-        qreal width = startWidth + (qreal(i)/qreal(n_points-1)) * (endWidth - startWidth);
-
-        pointsAndWidths << QPair<QPointF, qreal>(points[i], width);
+        x[i] = points[i].x();
+        y[i] = points[i].y();
+        widths[i] = startWidth + (qreal(i)/qreal(n_points-1)) * (endWidth - startWidth);
     }
 
-    return curveToPolygon(pointsAndWidths, true, true);
+    return strokeToPolygon(x.data(), y.data(), widths.data(), n_points, true, true);
 }
 
 /**
@@ -281,11 +295,22 @@ QPolygonF UBGeometryUtils::curveToPolygon(const QList<QPair<QPointF, qreal> >& p
     if (n_points == 1)
         return lineToPolygon(points.first().first, points.first().first, points.first().second, points.first().second);
 
-    qreal startWidth = points.first().second;
-    qreal endWidth = points.last().second;
+    std::vector<qreal> x(n_points), y(n_points), widths(n_points);
 
-    /* The vertices (x's) are calculated based on the stroke's width and angle, and the position of the
-       supplied points (o's):
+    for (int i(0); i < n_points; ++i) {
+        x[i] = points[i].first.x();
+        y[i] = points[i].first.y();
+        widths[i] = points[i].second;
+    }
+
+    return strokeToPolygon(x.data(), y.data(), widths.data(), n_points, roundStart, roundEnd);
+}
+
+/**
+ * @brief Build the outline of a stroke given as separate x, y and width arrays of `count` points (at least 2)
+ *
+ * The vertices (x's) are calculated based on the stroke's width and angle, and the position of the
+ * supplied points (o's):
 
           x----------x--------x
 
@@ -293,85 +318,69 @@ QPolygonF UBGeometryUtils::curveToPolygon(const QList<QPair<QPointF, qreal> >& p
 
           x----------x -------x
 
-       The vertices above and below each 'o' point are temporarily stored together, 
-       as a pair of points.
-     */
-
-    typedef QPair<QPointF, QPointF> pointPair;
-    QList<pointPair> newPoints;
-
-
-    QLineF firstSegment = QLineF(points[0].first, points[1].first);
-    QLineF normal = firstSegment.normalVector();
-    normal.setLength(startWidth/2.0);
-    newPoints << pointPair(normal.p2(), points[0].first - QPointF(normal.dx(), normal.dy()));
-
-    /*
-    Calculating the vertices (d1 and d2, below) is a little less trivial for the
-    next points: their positions depend on the angle between one segment and the next.
-
-                      d1
-         ------------x
-                      \
-         .a      b .   \
-                        \
-         --------x       \
-               d2 \       \
-                   \   .c  \
-
-    Here, points a, b and c are supplied in the `points` list.
+ * The vertices of the inner points are offset along the normal of the chord joining their two
+ * neighbours, by half the width at that point. This gives a kind of rounded-off joint rather than a
+ * miter joint. The ends are offset along the normal of the first and last segments, and can be
+ * terminated by semi-circles.
+ *
+ * The points are processed as plain arrays, one pass per quantity, so that the compiler can
+ * vectorize the loops; this runs on every pen move and for every stroke of a loaded page.
+ */
+QPolygonF UBGeometryUtils::strokeToPolygon(const qreal* x, const qreal* y, const qreal* widths, int count,
+        bool roundStart, bool roundEnd)
+{
+    if (count < 2)
+        return QPolygonF();
 
-    N.B: The drawing isn't quite accurate; we don't do a miter joint but a kind
-    of rounded-off joint (the distance between b and d1 is half the width of the stroke)
-    */
+    const int last = count - 1;
 
-    for (int i(1); i < n_points-1; ++i) {
-        //qreal width = startWidth + (qreal(i)/qreal(n_points-1)) * (endWidth - startWidth);
+    // normal offsets of every point, i.e. half a width along the normal of its chord
+    std::vector<qreal> nx(count), ny(count);
 
-        QLineF normal = (QLineF(points[i-1].first, points[i+1].first)).normalVector();
-        normal.setLength(points[i].second/2.0);
-        QPointF d1 = points[i].first + QPointF(normal.dx(), normal.dy());
-        QPointF d2 = points[i].first - QPointF(normal.dx(), normal.dy());
+    for (int i = 1; i < last; ++i) {
+        const qreal dx = x[i+1] - x[i-1];
+        const qreal dy = y[i+1] - y[i-1];
+        const qreal length = std::sqrt(dx * dx + dy * dy);
+        const qreal scale = length > 0 ? (widths[i] / 2.0) / length : 0;
 
-        newPoints << pointPair(d1, d2);
+        nx[i] = dy * scale;
+        ny[i] = -dx * scale;
     }
 
-    // The last point is similar to the first
-    QLineF lastSegment = QLineF(points[n_points-2].first, points[n_points-1].first);
-    normal = lastSegment.normalVector();
-    normal.setLength(endWidth/2.0);
+    qreal startUx, startUy, startFx, startFy;
+    qreal endUx, endUy, endFx, endFy;
+    segmentFrame(x[0], y[0], x[1], y[1], startUx, startUy, startFx, startFy);
+    segmentFrame(x[last-1], y[last-1], x[last], y[last], endUx, endUy, endFx, endFy);
 
-    QPointF d1 = points.last().first + QPointF(normal.dx(), normal.dy());
-    QPointF d2 = points.last().first - QPointF(normal.dx(), normal.dy());
+    const qreal startRadius = widths[0] / 2.0;
+    const qreal endRadius = widths[last] / 2.0;
 
-    newPoints << pointPair(d1, d2);
+    nx[0] = startUx * startRadius;
+    ny[0] = startUy * startRadius;
+    nx[last] = endUx * endRadius;
+    ny[last] = endUy * endRadius;
 
-    QPainterPath path;
-    path.setFillRule(Qt::WindingFill);
-    path.moveTo(newPoints[0].first);
+    const int startCap = roundStart ? capSegments(startRadius) : 0;
+    const int endCap = roundEnd ? capSegments(endRadius) : 0;
 
-    for (int i(1); i < n_points; ++i) {
-        path.lineTo(newPoints[i].first);
-    }
+    // upper side, end cap, lower side backwards, start cap and the closing point
+    QPolygonF polygon(2 * count + qMax(endCap - 1, 0) + qMax(startCap - 1, 0) + 1);
+    QPointF* out = polygon.data();
 
-    if (roundEnd)
-        path.arcTo(points.last().first.x() - endWidth/2.0, points.last().first.y() - endWidth/2.0, endWidth, endWidth, (90.0 + lastSegment.angle()), -180.0);
-    else
-        path.lineTo(newPoints.last().second);
+    for (int i = 0; i < count; ++i)
+        out[i] = QPointF(x[i] + nx[i], y[i] + ny[i]);
+    out += count;
 
-    for (int i(n_points-1); i >= 0; --i) {
-        path.lineTo(newPoints[i].second);
-    }
+    out = appendCap(out, x[last], y[last], endRadius, endUx, endUy, endFx, endFy, endCap);
 
-    if (roundStart)
-        path.arcTo(points[0].first.x() - startWidth/2.0, points[0].first.y() - startWidth/2.0, startWidth, startWidth, (firstSegment.angle() - 90.0), -180.0);
-    else
-        path.lineTo(newPoints[0].first);
+    for (int i = last; i >= 0; --i)
+        *out++ = QPointF(x[i] - nx[i], y[i] - ny[i]);
 
+    out = appendCap(out, x[0], y[0], startRadius, -startUx, -startUy, -startFx, -startFy, startCap);
 
-    //path.closeSubpath();
+    *out = polygon.first();
 
-    return path.toFillPolygon();
+    return polygon;
 }
 
 QPointF UBGeometryUtils::pointConstrainedInRect(QPointF point, QRectF rect)
@@ -452,18 +461,121 @@ qreal UBGeometryUtils::angle(const QPointF& p1, const QPointF& p2, const QPointF
  */
 QList<QPointF> UBGeometryUtils::quadraticBezier(const QPointF& p0, const QPointF& p1, const QPointF& p2, unsigned int nPoints)
 {
-    QPainterPath path(p0);
-    path.quadTo(p1, p2);
-
     QList<QPointF> points;
 
     if (nPoints <= 1)
         return points;
 
+    // The points are spread evenly along the length of the curve, like QPainterPath::pointAtPercent
+    // would, but the length is tabulated once instead of being searched again for each point.
+    const int samples = sBezierSamplesPerPoint * nPoints;
+    std::vector<qreal> lengths(samples + 1);
+
+    QPointF previous = p0;
+    lengths[0] = 0;
+
+    for (int i = 1; i <= samples; ++i) {
+        QPointF current = quadraticBezierPoint(p0, p1, p2, qreal(i) / samples);
+        lengths[i] = lengths[i-1] + QLineF(previous, current).length();
+        previous = current;
+    }
+
+    const qreal totalLength = lengths[samples];
+    int sample = 0;
+
     for (unsigned int i(0); i <= nPoints; ++i) {
         qreal percent = qreal(i)/qreal(nPoints);
-        points << path.pointAtPercent(percent);
+
+        if (totalLength <= 0) {
+            points << quadraticBezierPoint(p0, p1, p2, percent);
+            continue;
+        }
+
+        const qreal targetLength = percent * totalLength;
+
+        while (sample < samples - 1 && lengths[sample + 1] < targetLength)
+            ++sample;
+
+        const qreal segmentLength = lengths[sample + 1] - lengths[sample];
+        const qreal fraction = segmentLength > 0 ? (targetLength - lengths[sample]) / segmentLength : 0;
+
+        points << quadraticBezierPoint(p0, p1, p2, (sample + qBound(qreal(0), fraction, qreal(1))) / samples);
     }
 
     return points;
 }
+
+
+/**
+ * @brief Return how far a stroke point p lies from the stroke segment ab
+ *
+ * The width is treated as an extra dimension: as the outline is offset by half the width on each
+ * side of the stroke, the result bounds the displacement of the outline if p were dropped.
+ */
+qreal UBGeometryUtils::strokeDeviation(const QPointF& a, qreal aWidth, const QPointF& b, qreal bWidth,
+        const QPointF& p, qreal pWidth)
+{
+    const QPointF ab = b - a;
+    const qreal squaredLength = QPointF::dotProduct(ab, ab);
+
+    qreal t = 0;
+
+    if (squaredLength > 0)
+        t = qBound(qreal(0), QPointF::dotProduct(p - a, ab) / squaredLength, qreal(1));
+
+    const QPointF projection = a + t * ab;
+    const qreal width = aWidth + t * (bWidth - aWidth);
+
+    return QLineF(projection, p).length() + qAbs(pWidth - width) / 2.0;
+}
+
+/**
+ * @brief Simplify a stroke given as points and widths, keeping its outline within tolerance
+ * @param maxDeviation If not null, receives the largest deviation of a dropped point
+ */
+QList<QPair<QPointF, qreal> > UBGeometryUtils::simplifyStroke(const QList<QPair<QPointF, qreal> >& points,
+        qreal tolerance, qreal* maxDeviation)
+{
+    const int count = points.size();
+
+    std::vector<QPointF> positions(count);
+    std::vector<qreal> widths(count);
+
+    for (int i = 0; i < count; ++i) {
+        positions[i] = points[i].first;
+        widths[i] = points[i].second;
+    }
+
+    std::vector<bool> keep;
+    qreal deviation = markKeptPoints(positions.data(), widths.data(), count, tolerance, keep);
+
+    if (maxDeviation)
+        *maxDeviation = deviation;
+
+    QList<QPair<QPointF, qreal> > simplified;
+
+    for (int i = 0; i < count; ++i) {
+        if (keep[i])
+            simplified << points[i];
+    }
+
+    return simplified;
+}
+
+/**
+ * @brief Drop the vertices of a polygon that lie within tolerance of the remaining edges
+ */
+QPolygonF UBGeometryUtils::simplifyPolygon(const QPolygonF& polygon, qreal tolerance)
+{
+    std::vector<bool> keep;
+    markKeptPoints(polygon.constData(), nullptr, polygon.size(), tolerance, keep);
+
+    QPolygonF simplified;
+
+    for (int i = 0; i < polygon.size(); ++i) {
+        if (keep[i])
+            simplified << polygon.at(i);
+    }
+
+    return simplified;
+}
@@ -49,6 +49,8 @@ class UBGeometryUtils
                 const qreal& pStartWidth, const qreal& pEndWidth);
         static QPolygonF curveToPolygon(const QList<QPointF>& points, qreal startWidth, qreal endWidth);
         static QPolygonF curveToPolygon(const QList<QPair<QPointF, qreal> >& points, bool roundStart, bool roundEnd);
+        static QPolygonF strokeToPolygon(const qreal* x, const qreal* y, const qreal* widths, int count,
+                bool roundStart, bool roundEnd);
 
         static QPointF pointConstrainedInRect(QPointF point, QRectF rect);
         static QPoint pointConstrainedInRect(QPoint point, QRect rect);
@@ -59,6 +61,12 @@ class UBGeometryUtils
 
         static QList<QPointF> quadraticBezier(const QPointF& p0, const QPointF& p1, const QPointF& p2, unsigned int nPoints);
 
+        static qreal strokeDeviation(const QPointF& a, qreal aWidth, const QPointF& b, qreal bWidth,
+                const QPointF& p, qreal pWidth);
+        static QList<QPair<QPointF, qreal> > simplifyStroke(const QList<QPair<QPointF, qreal> >& points,
+                qreal tolerance, qreal* maxDeviation = nullptr);
+        static QPolygonF simplifyPolygon(const QPolygonF& polygon, qreal tolerance);
+
         const static int centimeterGraduationHeight;
         const static int halfCentimeterGraduationHeight;
         const static int millimeterGraduationHeight;
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QMutex>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * Allocator for many small objects of the same size.
+ *
+ * Memory is taken from the heap in chunks of several slots and freed slots are kept in a
+ * free list, so allocating and deleting an object costs a few pointer operations instead
+ * of a call to the heap. Chunks are never returned to the heap, the pool keeps the peak
+ * number of objects.
+ */
+template<std::size_t Size, std::size_t SlotsPerChunk = 256>
+class UBPoolAllocator
+{
+public:
+    void* allocate()
+    {
+        QMutexLocker lock(&mMutex);
+
+        if (!mFreeSlots)
+        {
+            std::unique_ptr<Slot[]> chunk(new Slot[SlotsPerChunk]);
+
+            for (std::size_t i = 0; i < SlotsPerChunk; ++i)
+            {
+                chunk[i].next = mFreeSlots;
+                mFreeSlots = &chunk[i];
+            }
+
+            mChunks.push_back(std::move(chunk));
+        }
+
+        Slot* slot = mFreeSlots;
+        mFreeSlots = slot->next;
+        return slot;
+    }
+
+    void deallocate(void* p)
+    {
+        if (!p)
+        {
+            return;
+        }
+
+        QMutexLocker lock(&mMutex);
+        Slot* slot = static_cast<Slot*>(p);
+        slot->next = mFreeSlots;
+        mFreeSlots = slot;
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        alignas(std::max_align_t) unsigned char storage[Size];
+    };
+
+    QMutex mMutex;
+    Slot* mFreeSlots{nullptr};
+    std::vector<std::unique_ptr<Slot[]>> mChunks{};
+};
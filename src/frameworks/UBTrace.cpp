@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBTrace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+
+#include <vector>
+
+#include "core/memcheck.h"
+
+/** Number of events kept in the ring buffer, must be a power of two */
+static const int sMaxEventCount = 1 << 16;
+
+namespace
+{
+    struct Event
+    {
+        const char* name;
+        qint64 timestamp;   // ns
+        qint64 value;       // duration in ns or counter value
+        quintptr thread;
+        char phase;
+    };
+
+    struct Buffer
+    {
+        Buffer()
+        {
+            clock.start();
+        }
+
+        QMutex mutex;
+        QElapsedTimer clock;
+        std::vector<Event> events;
+        quint64 count{0};
+    };
+
+    Buffer& buffer()
+    {
+        static Buffer buffer;
+        return buffer;
+    }
+
+    struct StartupPhase
+    {
+        const char* name;
+        qint64 start;       // ns
+        qint64 end;         // ns
+    };
+
+    struct Startup
+    {
+        std::vector<StartupPhase> phases;
+        bool done{false};
+    };
+
+    Startup& startup()
+    {
+        static Startup startup;
+        return startup;
+    }
+}
+
+std::atomic<bool> UBTrace::sEnabled{false};
+
+/**
+ * @brief Start or stop recording
+ *
+ * Starting discards the events of a former recording.
+ */
+void UBTrace::setEnabled(bool enabled)
+{
+    Buffer& b = buffer();
+
+    {
+        QMutexLocker lock(&b.mutex);
+
+        if (enabled && !isEnabled())
+        {
+            b.events.assign(sMaxEventCount, Event{});
+            b.count = 0;
+        }
+    }
+
+    sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Monotonic time in nanoseconds, the time base of all events
+ */
+qint64 UBTrace::timestamp()
+{
+    return buffer().clock.nsecsElapsed();
+}
+
+/**
+ * @brief Record an event lasting from *start* to *end*, as given by timestamp()
+ */
+void UBTrace::complete(const char* name, qint64 start, qint64 end)
+{
+    if (isEnabled())
+    {
+        record('X', name, start, end - start);
+    }
+}
+
+/**
+ * @brief Record a point in time, e.g. an input event or a cache miss
+ */
+void UBTrace::instant(const char* name)
+{
+    if (isEnabled())
+    {
+        record('i', name, timestamp(), 0);
+    }
+}
+
+/**
+ * @brief Record the value of a counter, e.g. the number of items painted
+ */
+void UBTrace::counter(const char* name, qint64 value)
+{
+    if (isEnabled())
+    {
+        record('C', name, timestamp(), value);
+    }
+}
+
+void UBTrace::record(char phase, const char* name, qint64 timestamp, qint64 value)
+{
+    Buffer& b = buffer();
+    QMutexLocker lock(&b.mutex);
+
+    if (b.events.empty())
+    {
+        return;
+    }
+
+    Event& event = b.events[b.count++ & (sMaxEventCount - 1)];
+    event.name = name;
+    event.timestamp = timestamp;
+    event.value = value;
+    event.thread = reinterpret_cast<quintptr>(QThread::currentThread());
+    event.phase = phase;
+}
+
+/**
+ * @brief Write the recorded events to *filename* as Chrome trace JSON
+ *
+ * Timestamps and durations are written in microseconds, as expected by the format.
+ */
+bool UBTrace::save(const QString& filename)
+{
+    Buffer& b = buffer();
+    std::vector<Event> events;
+
+    {
+        QMutexLocker lock(&b.mutex);
+
+        const quint64 count = qMin<quint64>(b.count, b.events.size());
+
+        events.reserve(count);
+
+        for (quint64 i = b.count - count; i < b.count; ++i)
+        {
+            events.push_back(b.events[i & (sMaxEventCount - 1)]);
+        }
+    }
+
+    const quintptr mainThread = qApp ? reinterpret_cast<quintptr>(qApp->thread()) : 0;
+    QHash<quintptr, int> threadIds;
+    QJsonArray traceEvents;
+
+    for (const Event& event : events)
+    {
+        if (!threadIds.contains(event.thread))
+        {
+            const int tid = threadIds.size() + 1;
+            threadIds.insert(event.thread, tid);
+
+            QJsonObject metadata;
+            metadata["name"] = "thread_name";
+            metadata["ph"] = "M";
+            metadata["pid"] = 1;
+            metadata["tid"] = tid;
+            metadata["args"] = QJsonObject{{"name", event.thread == mainThread ? QString("main") : QString("thread %1").arg(tid)}};
+            traceEvents.append(metadata);
+        }
+
+        QJsonObject object;
+        object["name"] = QString::fromLatin1(event.name);
+        object["ph"] = QString(QChar(event.phase));
+        object["ts"] = event.timestamp / 1000.;
+        object["pid"] = 1;
+        object["tid"] = threadIds.value(event.thread);
+
+        switch (event.phase)
+        {
+        case 'X':
+            object["dur"] = event.value / 1000.;
+            break;
+
+        case 'i':
+            object["s"] = "t";
+            break;
+
+        case 'C':
+            object["args"] = QJsonObject{{"value", event.value}};
+            break;
+        }
+
+        traceEvents.append(object);
+    }
+
+    QFile file(filename);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    QJsonObject trace;
+    trace["traceEvents"] = traceEvents;
+    trace["displayTimeUnit"] = "ms";
+
+    return file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+/**
+ * @brief Start the startup phase *name*, ending the current one
+ */
+void UBStartupTrace::phase(const char* name)
+{
+    Startup& s = startup();
+
+    if (s.done)
+    {
+        return;
+    }
+
+    const qint64 now = UBTrace::timestamp();
+
+    if (!s.phases.empty())
+    {
+        s.phases.back().end = now;
+    }
+
+    s.phases.push_back({name, now, now});
+}
+
+/**
+ * @brief End the startup with the first frame shown, and report the phases
+ *
+ * Only the first call has an effect, so that it may be called on each paint.
+ */
+void UBStartupTrace::firstFrame()
+{
+    Startup& s = startup();
+
+    if (s.done || s.phases.empty())
+    {
+        return;
+    }
+
+    s.done = true;
+
+    const qint64 now = UBTrace::timestamp();
+    s.phases.back().end = now;
+
+    for (const StartupPhase& phase : s.phases)
+    {
+        UBTrace::complete(phase.name, phase.start, phase.end);
+        qDebug().nospace() << "Startup phase " << phase.name << ": " << (phase.end - phase.start) / 1000000 << " ms";
+    }
+
+    qDebug().nospace() << "Startup to first frame: " << (now - s.phases.front().start) / 1000000 << " ms";
+
+    s.phases.clear();
+    s.phases.shrink_to_fit();
+}
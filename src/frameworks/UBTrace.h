@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+
+/**
+ * Low overhead recording of timing events, exported in the Chrome trace format.
+ *
+ * Events are written into a fixed size ring buffer, so that only the last events are
+ * kept when tracing for a long time. When tracing is disabled, recording an event costs
+ * a single relaxed atomic load. Event names must be string literals, only the pointer
+ * is stored.
+ *
+ * The saved file can be opened in chrome://tracing or https://ui.perfetto.dev.
+ */
+class UBTrace
+{
+public:
+    static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    static qint64 timestamp();
+
+    static void complete(const char* name, qint64 start, qint64 end);
+    static void instant(const char* name);
+    static void counter(const char* name, qint64 value);
+
+    static bool save(const QString& filename);
+
+private:
+    static void record(char phase, const char* name, qint64 timestamp, qint64 value);
+
+    static std::atomic<bool> sEnabled;
+};
+
+/**
+ * Records the time spent in a scope as a complete event.
+ */
+class UBTraceScope
+{
+public:
+    explicit UBTraceScope(const char* name)
+        : mName(UBTrace::isEnabled() ? name : nullptr)
+        , mStart(mName ? UBTrace::timestamp() : 0)
+    {
+    }
+
+    ~UBTraceScope()
+    {
+        if (mName)
+        {
+            UBTrace::complete(mName, mStart, UBTrace::timestamp());
+        }
+    }
+
+    UBTraceScope(const UBTraceScope&) = delete;
+    UBTraceScope& operator=(const UBTraceScope&) = delete;
+
+private:
+    const char* mName{nullptr};
+    qint64 mStart{0};
+};
+
+/**
+ * Times the phases of the application startup, up to the first frame shown.
+ *
+ * Phases are consecutive, starting a phase ends the current one. The duration of each
+ * phase is logged when the first frame is shown, and recorded as a complete event
+ * when tracing is enabled. To be used from the main thread only.
+ */
+class UBStartupTrace
+{
+public:
+    static void phase(const char* name);
+    static void firstFrame();
+};
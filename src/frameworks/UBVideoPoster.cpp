@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBVideoPoster.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#ifndef Q_OS_WIN
+extern "C" {
+    #include <libavcodec/avcodec.h>
+    #include <libavformat/avformat.h>
+    #include <libswscale/swscale.h>
+}
+#endif
+
+#include "core/memcheck.h"
+
+/** Largest width or height of a poster frame */
+static const int sMaxPosterSize = 640;
+
+/** Packets read at most while looking for the first decodable frame */
+static const int sMaxPackets = 500;
+
+QString UBVideoPoster::posterFileName(const QString& videoFileName)
+{
+    return videoFileName + ".poster.jpg";
+}
+
+QImage UBVideoPoster::cachedPoster(const QString& videoFileName)
+{
+    const QFileInfo posterInfo(posterFileName(videoFileName));
+
+    if (!posterInfo.exists() || posterInfo.lastModified() < QFileInfo(videoFileName).lastModified())
+        return QImage();
+
+    return QImage(posterInfo.filePath());
+}
+
+QImage UBVideoPoster::createPoster(const QString& videoFileName)
+{
+    const QImage poster = extractFrame(videoFileName);
+
+    if (!poster.isNull())
+    {
+        QSaveFile file(posterFileName(videoFileName));
+
+        if (!file.open(QIODevice::WriteOnly) || !poster.save(&file, "JPG", 85) || !file.commit())
+            qWarning() << "cannot cache poster frame of" << videoFileName;
+    }
+
+    return poster;
+}
+
+QImage UBVideoPoster::extractFrame(const QString& videoFileName)
+{
+    QImage image;
+
+#ifndef Q_OS_WIN
+    AVFormatContext* formatContext = nullptr;
+
+    if (avformat_open_input(&formatContext, QFile::encodeName(videoFileName).constData(), nullptr, nullptr) < 0)
+        return image;
+
+    AVCodecContext* codecContext = nullptr;
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+
+    const int streamIndex = avformat_find_stream_info(formatContext, nullptr) < 0
+            ? -1
+            : av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+
+    if (streamIndex >= 0)
+    {
+        const AVCodecParameters* parameters = formatContext->streams[streamIndex]->codecpar;
+        const AVCodec* codec = avcodec_find_decoder(parameters->codec_id);
+
+        if (codec)
+            codecContext = avcodec_alloc_context3(codec);
+
+        if (codecContext
+                && avcodec_parameters_to_context(codecContext, parameters) >= 0
+                && avcodec_open2(codecContext, codec, nullptr) >= 0)
+        {
+            bool decoded = false;
+
+            for (int i = 0; !decoded && i < sMaxPackets && av_read_frame(formatContext, packet) >= 0; ++i)
+            {
+                if (packet->stream_index == streamIndex && avcodec_send_packet(codecContext, packet) >= 0)
+                    decoded = avcodec_receive_frame(codecContext, frame) >= 0;
+
+                av_packet_unref(packet);
+            }
+
+            if (!decoded && avcodec_send_packet(codecContext, nullptr) >= 0)
+            {
+                // flush frames still held by the decoder
+                decoded = avcodec_receive_frame(codecContext, frame) >= 0;
+            }
+
+            if (decoded && frame->width > 0 && frame->height > 0)
+            {
+                QSizeF displaySize(frame->width, frame->height);
+
+                if (frame->sample_aspect_ratio.num > 0 && frame->sample_aspect_ratio.den > 0)
+                    displaySize.rwidth() *= av_q2d(frame->sample_aspect_ratio);
+
+                if (displaySize.width() > sMaxPosterSize || displaySize.height() > sMaxPosterSize)
+                    displaySize.scale(sMaxPosterSize, sMaxPosterSize, Qt::KeepAspectRatio);
+
+                const QSize size = displaySize.toSize();
+
+                SwsContext* swsContext = size.isEmpty() ? nullptr : sws_getContext(frame->width, frame->height, AVPixelFormat(frame->format),
+                                                                                   size.width(), size.height(), AV_PIX_FMT_RGB32,
+                                                                                   SWS_BILINEAR, nullptr, nullptr, nullptr);
+
+                if (swsContext)
+                {
+                    image = QImage(size, QImage::Format_RGB32);
+
+                    uint8_t* destination[1] = { image.bits() };
+                    int destinationStride[1] = { int(image.bytesPerLine()) };
+
+                    sws_scale(swsContext, frame->data, frame->linesize, 0, frame->height, destination, destinationStride);
+                    sws_freeContext(swsContext);
+                }
+            }
+        }
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&codecContext);
+    avformat_close_input(&formatContext);
+#else
+    Q_UNUSED(videoFileName);
+#endif
+
+    return image;
+}
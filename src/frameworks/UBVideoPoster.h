@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+/**
+ * @brief Poster frames of videos, shown by video items having no player.
+ *
+ * The first frame is extracted once with FFmpeg and cached in a file next to the video.
+ */
+class UBVideoPoster
+{
+public:
+    static QString posterFileName(const QString& videoFileName);
+
+    /** @brief The cached poster frame, null if missing or older than the video */
+    static QImage cachedPoster(const QString& videoFileName);
+
+    /** @brief Extract the poster frame and cache it, may be called from any thread */
+    static QImage createPoster(const QString& videoFileName);
+
+private:
+    static QImage extractFrame(const QString& videoFileName);
+};
@@ -2,22 +2,29 @@
 HEADERS      += src/frameworks/UBGeometryUtils.h \
                 src/frameworks/UBPlatformUtils.h \
                 src/frameworks/UBFileSystemUtils.h \
+                src/frameworks/UBFileOperation.h \
                 src/frameworks/UBStringUtils.h \
                 src/frameworks/UBVersion.h \
                 src/frameworks/UBCoreGraphicsScene.h \
                 src/frameworks/UBCryptoUtils.h \
                 src/frameworks/UBBackgroundLoader.h \
-                src/frameworks/UBBase32.h
+                src/frameworks/UBPoolAllocator.h \
+                src/frameworks/UBBase32.h \
+                src/frameworks/UBTrace.h \
+                src/frameworks/UBVideoPoster.h
 
 SOURCES      += src/frameworks/UBGeometryUtils.cpp \
                 src/frameworks/UBPlatformUtils.cpp \
                 src/frameworks/UBFileSystemUtils.cpp \
+                src/frameworks/UBFileOperation.cpp \
                 src/frameworks/UBStringUtils.cpp \
                 src/frameworks/UBVersion.cpp \
                 src/frameworks/UBCoreGraphicsScene.cpp \
                 src/frameworks/UBCryptoUtils.cpp \
                 src/frameworks/UBBackgroundLoader.cpp \
-                src/frameworks/UBBase32.cpp
+                src/frameworks/UBBase32.cpp \
+                src/frameworks/UBTrace.cpp \
+                src/frameworks/UBVideoPoster.cpp
 
 
 win32 {
@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBCaptureService.h"
+
+#include <QChildEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QtConcurrent>
+
+#include "core/UBApplication.h"
+#include "core/UBDisplayManager.h"
+
+#include "core/memcheck.h"
+
+UBCaptureService* UBCaptureService::sCaptureService = nullptr;
+
+/** Margin grabbed around damaged rects, so that smooth scaling does not bleed at their border */
+static const int sPatchMargin = 2;
+
+/** Above this number of damaged rects, their bounding rect is grabbed at once */
+static const int sMaxPatchCount = 8;
+
+UBCaptureService* UBCaptureService::captureService()
+{
+    if (!sCaptureService)
+    {
+        sCaptureService = new UBCaptureService();
+    }
+
+    return sCaptureService;
+}
+
+void UBCaptureService::destroy()
+{
+    delete sCaptureService;
+    sCaptureService = nullptr;
+}
+
+UBCaptureService::UBCaptureService(QObject* parent)
+    : QObject{parent}
+{
+    connect(&mComposeWatcher, &QFutureWatcher<QImage>::finished, this, &UBCaptureService::onMirrorComposed);
+}
+
+UBCaptureService::~UBCaptureService()
+{
+    mComposeWatcher.waitForFinished();
+}
+
+/**
+ * @brief Start reporting the damaged rects of *widget*
+ *
+ * The paint events of its child widgets, such as the viewport of a scroll area or the render
+ * widget of a web view, are reported as damage of *widget*.
+ *
+ * Calls are counted, the widget is watched until as many calls to unwatch() are made.
+ */
+void UBCaptureService::watch(QWidget* widget)
+{
+    if (!widget)
+    {
+        return;
+    }
+
+    if (mWatchCount[widget]++ == 0)
+    {
+        widget->installEventFilter(this);
+
+        for (QWidget* child : widget->findChildren<QWidget*>())
+        {
+            child->installEventFilter(this);
+        }
+
+        connect(widget, &QObject::destroyed, this, [this, widget]() {
+            mWatchCount.remove(widget);
+        });
+    }
+}
+
+void UBCaptureService::unwatch(QWidget* widget)
+{
+    if (!widget || !mWatchCount.contains(widget))
+    {
+        return;
+    }
+
+    if (--mWatchCount[widget] == 0)
+    {
+        mWatchCount.remove(widget);
+        widget->removeEventFilter(this);
+
+        for (QWidget* child : widget->findChildren<QWidget*>())
+        {
+            if (!watchedAncestor(child))
+            {
+                child->removeEventFilter(this);
+            }
+        }
+
+        disconnect(widget, nullptr, this, nullptr);
+    }
+}
+
+/**
+ * @brief Set the widget shown on the mirror, or nullptr to mirror the control screen
+ */
+void UBCaptureService::setMirrorSource(QWidget* source)
+{
+    if (mTrackMirrorSource)
+    {
+        unwatch(mMirrorSource);
+    }
+
+    mMirrorSource = source;
+
+    // the screen in desktop mode is grabbed entirely
+    mTrackMirrorSource = source != nullptr;
+
+    if (mTrackMirrorSource)
+    {
+        watch(source);
+    }
+
+    mMirrorDamage = QRegion();
+    mMirrorFullRefresh = true;
+
+    if (mTimerId)
+    {
+        captureMirror();
+    }
+}
+
+QWidget* UBCaptureService::mirrorSource() const
+{
+    return mMirrorSource;
+}
+
+/**
+ * @brief Set the size of the mirror buffer in device pixels
+ *
+ * The source is scaled to fit in this size, keeping its aspect ratio.
+ */
+void UBCaptureService::setMirrorSize(const QSize& size)
+{
+    if (size != mMirrorSize)
+    {
+        mMirrorSize = size;
+        mMirrorFullRefresh = true;
+    }
+}
+
+QImage UBCaptureService::mirrorImage() const
+{
+    return mMirrorImage;
+}
+
+void UBCaptureService::startMirroring(int intervalMs)
+{
+    if (mTimerId == 0)
+    {
+        mTimerId = startTimer(intervalMs);
+    }
+
+    mMirrorFullRefresh = true;
+    captureMirror();
+}
+
+void UBCaptureService::stopMirroring()
+{
+    if (mTimerId != 0)
+    {
+        killTimer(mTimerId);
+        mTimerId = 0;
+    }
+}
+
+bool UBCaptureService::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::ChildAdded)
+    {
+        QChildEvent* childEvent = static_cast<QChildEvent*>(event);
+
+        if (childEvent->child()->isWidgetType())
+        {
+            QWidget* child = static_cast<QWidget*>(childEvent->child());
+            child->installEventFilter(this);
+
+            for (QWidget* grandChild : child->findChildren<QWidget*>())
+            {
+                grandChild->installEventFilter(this);
+            }
+        }
+    }
+    else if ((event->type() == QEvent::Paint && !mGrabbing) || event->type() == QEvent::Resize)
+    {
+        // the paint events sent by grab() are not a damage
+        QWidget* widget = qobject_cast<QWidget*>(watched);
+        QWidget* watchedWidget = widget ? watchedAncestor(widget) : nullptr;
+
+        if (!watchedWidget)
+        {
+            return QObject::eventFilter(watched, event);
+        }
+
+        QRect rect = event->type() == QEvent::Paint ? static_cast<QPaintEvent*>(event)->rect() : widget->rect();
+
+        if (widget != watchedWidget)
+        {
+            rect.translate(widget->mapTo(watchedWidget, QPoint(0, 0)));
+            rect &= watchedWidget->rect();
+        }
+
+        if (watchedWidget == mMirrorSource)
+        {
+            mMirrorDamage += rect;
+        }
+
+        emit damaged(watchedWidget, rect);
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+/**
+ * @brief Return *widget* or its closest ancestor being watched, or nullptr if there is none
+ */
+QWidget* UBCaptureService::watchedAncestor(QWidget* widget) const
+{
+    for (QWidget* ancestor = widget; ancestor; ancestor = ancestor->parentWidget())
+    {
+        if (mWatchCount.contains(ancestor))
+        {
+            return ancestor;
+        }
+
+        if (ancestor->isWindow())
+        {
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+void UBCaptureService::timerEvent(QTimerEvent* event)
+{
+    Q_UNUSED(event);
+
+    captureMirror();
+}
+
+/**
+ * @brief Grab what changed on the mirror source and compose it into the mirror buffer
+ *
+ * Nothing is done while the previous frame is being composed, the damage accumulates
+ * until the next tick.
+ */
+void UBCaptureService::captureMirror()
+{
+    if (mComposeWatcher.isRunning() || mMirrorSize.isEmpty())
+    {
+        return;
+    }
+
+    QList<Patch> patches;
+    QSize sourceSize;
+
+    if (mMirrorSource)
+    {
+        sourceSize = mMirrorSource->size();
+
+        const bool fullRefresh = mMirrorFullRefresh || !mTrackMirrorSource || sourceSize != mMirrorSourceSize;
+
+        if (!fullRefresh && mMirrorDamage.isEmpty())
+        {
+            return;
+        }
+
+        QRegion region = fullRefresh ? QRegion(mMirrorSource->rect()) : mMirrorDamage & mMirrorSource->rect();
+
+        if (region.rectCount() > sMaxPatchCount)
+        {
+            region = region.boundingRect();
+        }
+
+        mGrabbing = true;
+
+        for (const QRect& rect : region)
+        {
+            const QRect grabRect = rect.adjusted(-sPatchMargin, -sPatchMargin, sPatchMargin, sPatchMargin) & mMirrorSource->rect();
+            patches << Patch{rect, grabRect, mMirrorSource->grab(grabRect).toImage()};
+        }
+
+        mGrabbing = false;
+    }
+    else
+    {
+        const QPixmap screen = UBApplication::displayManager->grab(ScreenRole::Control);
+
+        if (screen.isNull())
+        {
+            return;
+        }
+
+        sourceSize = (QSizeF(screen.size()) / screen.devicePixelRatioF()).toSize();
+        patches << Patch{QRect(QPoint(), sourceSize), QRect(QPoint(), sourceSize), screen.toImage()};
+    }
+
+    const QSize bufferSize = sourceSize.scaled(mMirrorSize, Qt::KeepAspectRatio);
+
+    if (bufferSize.isEmpty())
+    {
+        return;
+    }
+
+    // reuse the current buffer only if the patches can be composed on it
+    const QImage buffer = !mMirrorFullRefresh && sourceSize == mMirrorSourceSize ? mMirrorImage : QImage();
+
+    mMirrorSourceSize = sourceSize;
+    mMirrorDamage = QRegion();
+    mMirrorFullRefresh = false;
+
+    mComposeWatcher.setFuture(QtConcurrent::run(&UBCaptureService::compose, buffer, sourceSize, bufferSize, patches));
+}
+
+void UBCaptureService::onMirrorComposed()
+{
+    mMirrorImage = mComposeWatcher.result();
+
+    emit mirrorUpdated();
+}
+
+/**
+ * @brief Scale the patches grabbed from the source and paint them on the buffer
+ *
+ * Runs on a worker thread.
+ */
+QImage UBCaptureService::compose(QImage buffer, const QSize& sourceSize, const QSize& bufferSize, const QList<Patch>& patches)
+{
+    if (buffer.size() != bufferSize)
+    {
+        buffer = QImage(bufferSize, QImage::Format_ARGB32_Premultiplied);
+        buffer.fill(Qt::black);
+    }
+
+    const qreal sx = qreal(bufferSize.width()) / sourceSize.width();
+    const qreal sy = qreal(bufferSize.height()) / sourceSize.height();
+
+    QPainter painter(&buffer);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    for (const Patch& patch : patches)
+    {
+        const QRectF target(patch.grabRect.x() * sx, patch.grabRect.y() * sy, patch.grabRect.width() * sx, patch.grabRect.height() * sy);
+        const QSize scaledSize = target.size().toSize().expandedTo(QSize(1, 1));
+
+        QImage scaled = patch.image.scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        scaled.setDevicePixelRatio(1.);
+
+        painter.setClipRect(QRectF(patch.rect.x() * sx, patch.rect.y() * sy, patch.rect.width() * sx, patch.rect.height() * sy).toAlignedRect());
+        painter.drawImage(target, scaled);
+    }
+
+    painter.end();
+
+    return buffer;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPointer>
+#include <QRegion>
+#include <QWidget>
+
+/**
+ * Shared capture of the board for the screen mirror and the magnifier.
+ *
+ * The service watches the paint events of the widgets it is asked to track and of their
+ * children, and reports their damaged rects, so that consumers only refresh when something
+ * changed.
+ *
+ * For the mirror, it keeps a downscaled copy of the source widget. At each tick only the
+ * rects damaged since the previous tick are grabbed, and they are scaled and composed into
+ * the mirror buffer on a worker thread. Sources whose damage cannot be tracked, such as the
+ * screen in desktop mode, are grabbed entirely but still scaled off the GUI thread.
+ */
+class UBCaptureService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static UBCaptureService* captureService();
+    static void destroy();
+
+    void watch(QWidget* widget);
+    void unwatch(QWidget* widget);
+
+    void setMirrorSource(QWidget* source);
+    QWidget* mirrorSource() const;
+    void setMirrorSize(const QSize& size);
+    QImage mirrorImage() const;
+
+    void startMirroring(int intervalMs);
+    void stopMirroring();
+
+signals:
+    void damaged(QWidget* widget, const QRect& rect);
+    void mirrorUpdated();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+    void timerEvent(QTimerEvent* event) override;
+
+private:
+    struct Patch
+    {
+        QRect rect;
+        QRect grabRect;
+        QImage image;
+    };
+
+    explicit UBCaptureService(QObject* parent = nullptr);
+    virtual ~UBCaptureService();
+
+    QWidget* watchedAncestor(QWidget* widget) const;
+    void captureMirror();
+    void onMirrorComposed();
+
+    static QImage compose(QImage buffer, const QSize& sourceSize, const QSize& bufferSize, const QList<Patch>& patches);
+
+    QHash<QObject*, int> mWatchCount{};
+
+    QPointer<QWidget> mMirrorSource{};
+    bool mTrackMirrorSource{false};
+    bool mGrabbing{false};
+    QSize mMirrorSize{};
+    QSize mMirrorSourceSize{};
+    QRegion mMirrorDamage{};
+    bool mMirrorFullRefresh{true};
+    QImage mMirrorImage{};
+    QFutureWatcher<QImage> mComposeWatcher{};
+    int mTimerId{0};
+
+    static UBCaptureService* sCaptureService;
+};
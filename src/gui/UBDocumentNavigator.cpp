@@ -139,16 +139,16 @@ void UBDocumentNavigator::generateThumbnails(UBDocumentContainer* source)
         UBApplication::showMessage(tr("Generating thumbnails for board (%1/%2)").arg(i+1).arg(source->selectedDocument()->pageCount()));
 
         bool found = false;
-        if (UBApplication::documentController)
+        if (UBApplication::hasDocumentController())
         {
-            if (UBApplication::documentController->selectedDocument() == source->selectedDocument())
+            if (UBApplication::documentController()->selectedDocument() == source->selectedDocument())
             {
 
-                if (UBApplication::documentController->pageAt(i))
+                if (UBApplication::documentController()->pageAt(i))
                 {
                     found = true;
                     //thumbnail has already been loaded on the documentController so we don't need to do it again
-                    source->insertExistingThumbPage(i, UBApplication::documentController->pageAt(i));
+                    source->insertExistingThumbPage(i, UBApplication::documentController()->pageAt(i));
                 }
             }
         }
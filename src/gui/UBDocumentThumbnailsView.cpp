@@ -190,7 +190,7 @@ void UBDocumentThumbnailsView::mousePressEvent(QMouseEvent *event)
         mSelectionSpan = 0;
     }
 
-    UBApplication::documentController->pageSelectionChanged();
+    UBApplication::documentController()->pageSelectionChanged();
 }
 
 
@@ -38,6 +38,7 @@
 #include "document/UBDocumentController.h"
 
 #include "adaptors/UBThumbnailAdaptor.h"
+#include "adaptors/UBThumbnailWriter.h"
 #include "adaptors/UBSvgSubsetAdaptor.h"
 #include "frameworks/UBFileSystemUtils.h"
 
@@ -301,6 +302,7 @@ void UBDocumentTreeWidget::dropEvent(QDropEvent *event)
                             //it's not universal and good way but it's faster
                             QString from = sourceItem.documentProxy()->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", sourceItem.sceneIndex());
                             QString to  = targetDocProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", targetDocProxy->pageCount());
+                            UBThumbnailWriter::writer()->flush();
                             QFile::remove(to);
                             QFile::copy(from, to);
                           }
@@ -323,7 +325,7 @@ void UBDocumentTreeWidget::dropEvent(QDropEvent *event)
 
 void UBDocumentTreeWidget::documentUpdated(UBDocumentProxy *pDocument)
 {
-    UBDocumentProxyTreeItem *treeItem = UBApplication::documentController->findDocument(pDocument);
+    UBDocumentProxyTreeItem *treeItem = UBApplication::documentController()->findDocument(pDocument);
     if (treeItem)
     {
         QTreeWidgetItem * parent = treeItem->parent();
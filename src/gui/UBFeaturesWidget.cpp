@@ -96,8 +96,8 @@ UBFeaturesWidget::UBFeaturesWidget(QWidget *parent, const char *name)
     connect(mActionBar, SIGNAL(rescanModel()), this, SLOT(rescanModel()));
     connect(pathListView, SIGNAL(pressed(const QModelIndex &)), this, SLOT(currentSelected(const QModelIndex &)));
     connect(UBApplication::boardController, SIGNAL(displayMetadata(QMap<QString,QString>)), this, SLOT(onDisplayMetadata( QMap<QString,QString>)));
-    connect(UBDownloadManager::downloadManager(), SIGNAL( addDownloadedFileToLibrary( bool, QUrl, QString, QByteArray, QString))
-             , this, SLOT(onAddDownloadedFileToLibrary(bool, QUrl, QString,QByteArray, QString)));
+    connect(UBDownloadManager::downloadManager(), SIGNAL( addDownloadedFileToLibrary( bool, QUrl, QString, QString, QString))
+             , this, SLOT(onAddDownloadedFileToLibrary(bool, QUrl, QString, QString, QString)));
     connect(centralWidget, SIGNAL(lockMainWidget(bool)), this, SLOT(lockIt(bool)));
     connect(centralWidget, SIGNAL(createNewFolderSignal(QString)), controller, SLOT(addNewFolder(QString)));
     connect(controller, SIGNAL(scanStarted()), centralWidget, SLOT(scanStarted()));
@@ -116,6 +116,14 @@ UBFeaturesWidget::~UBFeaturesWidget()
         delete imageGatherer;
 }
 
+void UBFeaturesWidget::showEvent(QShowEvent *event)
+{
+    UBDockPaletteWidget::showEvent(event);
+
+    // scan the library once the palette is painted
+    QTimer::singleShot(0, controller, &UBFeaturesController::startScan);
+}
+
 void UBFeaturesWidget::searchStarted(const QString &pattern)
 {
     controller->searchStarted(pattern, centralWidget->listView());
@@ -305,9 +313,10 @@ void UBFeaturesWidget::onDisplayMetadata( QMap<QString,QString> metadata )
         if (!imageGatherer)
             imageGatherer = new UBDownloadHttpFile(0, this);
 
-        connect(imageGatherer, SIGNAL(downloadFinished(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)), this, SLOT(onPreviewLoaded(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)));
+        connect(imageGatherer, SIGNAL(downloadFinished(int, bool, QUrl, QUrl, QString, QString, QPointF, QSize, bool)), this, SLOT(onPreviewLoaded(int, bool, QUrl, QUrl, QString, QString, QPointF, QSize, bool)), Qt::UniqueConnection);
 
         // We send here the request and store its reply in order to be able to cancel it if needed
+        imageGatherer->setDestinationFile(UBDownloadHttpFile::temporaryFilePath(QUrl(widgetsThumbsUrl)));
         imageGatherer->get(QUrl(widgetsThumbsUrl), QPoint(0,0), QSize(), false);
     }
 
@@ -319,7 +328,7 @@ void UBFeaturesWidget::onDisplayMetadata( QMap<QString,QString> metadata )
 }
 
 
-void UBFeaturesWidget::onPreviewLoaded(int id, bool pSuccess, QUrl sourceUrl, QUrl originalUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground)
+void UBFeaturesWidget::onPreviewLoaded(int id, bool pSuccess, QUrl sourceUrl, QUrl originalUrl, QString pContentTypeHeader, QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground)
 {
     Q_UNUSED(id);
     Q_UNUSED(pSuccess);
@@ -331,17 +340,17 @@ void UBFeaturesWidget::onPreviewLoaded(int id, bool pSuccess, QUrl sourceUrl, QU
     Q_UNUSED(pContentTypeHeader)
 
     QImage img;
-    img.loadFromData(pData);
+    img.load(pLocalFile);
+    QFile::remove(pLocalFile);
     QPixmap pix = QPixmap::fromImage(img);
     centralWidget->setPropertiesPixmap(pix);
     centralWidget->setPropertiesThumbnail(pix);
 }
 
-void UBFeaturesWidget::onAddDownloadedFileToLibrary(bool pSuccess, QUrl sourceUrl, QString pContentHeader, QByteArray pData, QString pTitle)
+void UBFeaturesWidget::onAddDownloadedFileToLibrary(bool pSuccess, QUrl sourceUrl, QString pContentHeader, QString pLocalFile, QString pTitle)
 {
     if (pSuccess) {
-        qDebug() << pData.length();
-        controller->addDownloadedFile(sourceUrl, pData, pContentHeader, pTitle);
+        controller->addDownloadedFile(sourceUrl, pLocalFile, pContentHeader, pTitle);
         controller->refreshModels();
     }
 }
@@ -109,8 +109,11 @@ public:
 signals:
     void sendFileNameList(const QStringList lst);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
 private slots:
-    void onPreviewLoaded(int id, bool pSuccess, QUrl sourceUrl, QUrl originalUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground);
+    void onPreviewLoaded(int id, bool pSuccess, QUrl sourceUrl, QUrl originalUrl, QString pContentTypeHeader, QString pLocalFile, QPointF pPos, QSize pSize, bool isBackground);
     void currentSelected( const QModelIndex & );
     void searchStarted( const QString & );
     void createNewFolder();
@@ -118,7 +121,7 @@ private slots:
     void addToFavorite( const UBFeaturesMimeData  *);
     void removeFromFavorite( const UBFeaturesMimeData * );
     void onDisplayMetadata( QMap<QString,QString> );
-    void onAddDownloadedFileToLibrary(bool, QUrl, QString, QByteArray, QString pTitle);
+    void onAddDownloadedFileToLibrary(bool, QUrl, QString, QString pLocalFile, QString pTitle);
     void addElementsToFavorite();
     void removeElementsFromFavorite();
     void deleteSelectedElements();
@@ -33,6 +33,7 @@
 #include "board/UBBoardController.h"
 #include "domain/UBGraphicsScene.h"
 #include "board/UBBoardView.h"
+#include "gui/UBCaptureService.h"
 
 #include "core/memcheck.h"
 
@@ -59,6 +60,8 @@ UBMagnifier::UBMagnifier(QWidget *parent, bool isInteractive)
 
     params.sizePercentFromScene = 20;
     m_isInteractive = isInteractive;
+    mGrabNeeded = true;
+    mSelfUpdatePending = false;
     sClosePixmap = new QPixmap(":/images/close.svg");
     sIncreasePixmap = new QPixmap(":/images/increase.svg");
     sDecreasePixmap = new QPixmap(":/images/decrease.svg");
@@ -99,6 +102,8 @@ UBMagnifier::UBMagnifier(QWidget *parent, bool isInteractive)
 
 UBMagnifier::~UBMagnifier()
 {
+    UBCaptureService::captureService()->unwatch(gView);
+
     if(sClosePixmap)
     {
         delete sClosePixmap;
@@ -178,11 +183,14 @@ void UBMagnifier::createMask()
     pMap = QPixmap(width(), height());
     pMap.fill(Qt::transparent);
     pMap.setMask(bmpMask);
+
+    mGrabNeeded = true;
 }
 
 void UBMagnifier::setZoom(qreal zoom)
 {
     params.zoom = zoom;
+    mGrabNeeded = true;
 }
 
 
@@ -207,6 +215,8 @@ void UBMagnifier::calculateButtonsPositions()
 void UBMagnifier::paintEvent(QPaintEvent * event)
 {
     Q_UNUSED(event);
+    mSelfUpdatePending = false;
+
     QPainter painter(this);
 
     painter.setRenderHint(QPainter::Antialiasing);
@@ -365,7 +375,8 @@ void UBMagnifier::mouseReleaseEvent(QMouseEvent * event)
 
 void UBMagnifier::slot_refresh()
 {
-    if(!(updPointGrab.isNull()))
+    // only render the scene again if the grabbed area was damaged
+    if(!(updPointGrab.isNull()) && mGrabNeeded)
         grabPoint(updPointGrab);
 
     if(isCusrsorAlreadyStored)
@@ -414,6 +425,8 @@ void UBMagnifier::grabPoint()
     pMap = newPixMap.scaled(QSize(width(), height()));
     pMap.setMask(bmpMask);
 
+    mGrabNeeded = false;
+    mSelfUpdatePending = true;
     update();
 }
 
@@ -448,6 +461,8 @@ void UBMagnifier::grabPoint(const QPoint &pGrab)
     pMap = newPixMap;
     pMap.setMask(bmpMask);
 
+    mGrabNeeded = false;
+    mSelfUpdatePending = true;
     update();
 }
 
@@ -473,11 +488,37 @@ void UBMagnifier::grabNMove(const QPoint &pGrab, const QPoint &pMove, bool needG
 
 void UBMagnifier::setGrabView(QWidget *view)
 {
+    UBCaptureService::captureService()->unwatch(gView);
+
     gView = view;
+    mGrabNeeded = true;
+
+    UBCaptureService::captureService()->watch(gView);
+    connect(UBCaptureService::captureService(), SIGNAL(damaged(QWidget*, const QRect&)), this, SLOT(onGrabViewDamaged(QWidget*, const QRect&)), Qt::UniqueConnection);
+
     mRefreshTimer.setInterval(40);
     mRefreshTimer.start();
 }
 
+void UBMagnifier::onGrabViewDamaged(QWidget *widget, const QRect &rect)
+{
+    if (widget != gView || mGrabNeeded)
+        return;
+
+    // repainting the magnifier repaints the view below it, which must not trigger a new grab
+    QRect ownRect(gView->mapFromGlobal(mapToGlobal(QPoint(0, 0))), size());
+
+    if (mSelfUpdatePending && ownRect.contains(rect))
+        return;
+
+    QPoint grabCenter = gView->mapFromGlobal(updPointGrab);
+    QSize grabSize = QSizeF(width() / params.zoom, height() / params.zoom).toSize();
+    QRect grabRect(grabCenter - QPoint(grabSize.width() / 2, grabSize.height() / 2), grabSize);
+
+    if (grabRect.intersects(rect))
+        mGrabNeeded = true;
+}
+
 void UBMagnifier::setDrawingMode(int mode)
 {
     mDrawingMode = static_cast<DrawingMode>(mode);
@@ -82,6 +82,7 @@ signals:
     
 public slots:
     void slot_refresh();
+    void onGrabViewDamaged(QWidget *widget, const QRect &rect);
 
 private:
     void calculateButtonsPositions();
@@ -118,6 +119,8 @@ private:
 
     QTimer mRefreshTimer;
     bool m_isInteractive;
+    bool mGrabNeeded;
+    bool mSelfUpdatePending;
 
     QPoint updPointGrab;
     QPoint updPointMove;
@@ -33,6 +33,7 @@
 #include "core/UBApplication.h"
 #include "core/UBDisplayManager.h"
 #include "board/UBBoardController.h"
+#include "gui/UBCaptureService.h"
 
 #if defined(Q_OS_OSX)
 #include <ApplicationServices/ApplicationServices.h>
@@ -43,16 +44,20 @@
 
 UBScreenMirror::UBScreenMirror(QWidget* parent)
     : QWidget(parent)
-    , mSourceWidget(0)
-    , mTimerID(0)
+    , mRunning(false)
 {
-    // NOOP
+    UBCaptureService::captureService()->setMirrorSource(nullptr);
+
+    connect(UBCaptureService::captureService(), SIGNAL(mirrorUpdated()), this, SLOT(update()));
 }
 
 
 UBScreenMirror::~UBScreenMirror()
 {
-    // NOOP
+    if (mRunning)
+    {
+        UBCaptureService::captureService()->stopMirroring();
+    }
 }
 
 
@@ -64,48 +69,34 @@ void UBScreenMirror::paintEvent(QPaintEvent *event)
 
     painter.fillRect(0, 0, width(), height(), QBrush(Qt::black));
 
-    if (!mLastPixmap.isNull())
+    // the mirror image is captured and scaled by the capture service
+    QImage image = UBCaptureService::captureService()->mirrorImage();
+
+    if (!image.isNull())
     {
+        image.setDevicePixelRatio(devicePixelRatioF());
+
         // compute size and offset in device independent coordinates
-        QSizeF pixmapSize = mLastPixmap.size() / mLastPixmap.devicePixelRatioF();
-        int x = (width() - pixmapSize.width()) / 2;
-        int y = (height() - pixmapSize.height()) / 2;
+        QSizeF imageSize = image.size() / image.devicePixelRatioF();
+        int x = (width() - imageSize.width()) / 2;
+        int y = (height() - imageSize.height()) / 2;
 
-        painter.drawPixmap(x, y, mLastPixmap);
+        painter.drawImage(x, y, image);
     }
 }
 
 
-void UBScreenMirror::timerEvent(QTimerEvent *event)
+void UBScreenMirror::resizeEvent(QResizeEvent *event)
 {
     Q_UNUSED(event);
 
-    grabPixmap();
-
-    update();
-}
-
-void UBScreenMirror::grabPixmap()
-{
-    if (mSourceWidget)
-    {
-        mLastPixmap = mSourceWidget->grab();
-    }
-    else
-    {
-        mLastPixmap = UBApplication::displayManager->grab(ScreenRole::Control);
-    }
-
-    if (!mLastPixmap.isNull())
-        mLastPixmap = mLastPixmap.scaled(size() * mLastPixmap.devicePixelRatioF(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    UBCaptureService::captureService()->setMirrorSize(size() * devicePixelRatioF());
 }
 
 
 void UBScreenMirror::setSourceWidget(QWidget *sourceWidget)
 {
-    mSourceWidget = sourceWidget;
-
-    grabPixmap();
+    UBCaptureService::captureService()->setMirrorSource(sourceWidget);
 
     update();
 }
@@ -115,7 +106,7 @@ void UBScreenMirror::start()
 {
     qDebug() << "mirroring START";
     UBApplication::boardController->freezeW3CWidgets(true);
-    if (mTimerID == 0)
+    if (!mRunning)
     {
         int ms = 125;
 
@@ -127,7 +118,9 @@ void UBScreenMirror::start()
             ms = 1000 / fps;
         }
 
-        mTimerID = startTimer(ms);
+        UBCaptureService::captureService()->setMirrorSize(size() * devicePixelRatioF());
+        UBCaptureService::captureService()->startMirroring(ms);
+        mRunning = true;
     }
     else
     {
@@ -140,9 +133,9 @@ void UBScreenMirror::stop()
 {
     qDebug() << "mirroring STOP";
     UBApplication::boardController->freezeW3CWidgets(false);
-    if (mTimerID != 0)
+    if (mRunning)
     {
-        killTimer(mTimerID);
-        mTimerID = 0;
+        UBCaptureService::captureService()->stopMirroring();
+        mRunning = false;
     }
 }
@@ -42,7 +42,7 @@ class UBScreenMirror : public QWidget
         virtual ~UBScreenMirror();
 
         virtual void paintEvent (QPaintEvent * event);
-        virtual void timerEvent(QTimerEvent *event);
+        virtual void resizeEvent(QResizeEvent *event);
 
     public slots:
 
@@ -54,13 +54,7 @@ class UBScreenMirror : public QWidget
 
     private:
 
-        void grabPixmap();
-
-        QWidget* mSourceWidget;
-
-        QPixmap mLastPixmap;
-
-        long mTimerID;
+        bool mRunning;
 
 };
 
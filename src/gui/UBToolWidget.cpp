@@ -89,7 +89,7 @@ void UBToolWidget::initialize()
     mWebView = new UBWebEngineView();
 
     // create the page using a profile
-    QWebEngineProfile* profile = UBApplication::webController->webProfile();
+    QWebEngineProfile* profile = UBApplication::webController()->webProfile();
     mWebView->setPage(new WebPage(profile, mWebView));
 
     mWebView->setAttribute(Qt::WA_TranslucentBackground);
@@ -14,6 +14,7 @@ HEADERS +=  \
     src/gui/UBColorPicker.h \
     src/gui/UBWidgetMirror.h \
     src/gui/UBScreenMirror.h \
+    src/gui/UBCaptureService.h \
     src/gui/UBResources.h \
     src/gui/UBMessageWindow.h \
     src/gui/UBDocumentThumbnailWidget.h \
@@ -63,6 +64,7 @@ SOURCES +=  \
     src/gui/UBColorPicker.cpp \
     src/gui/UBWidgetMirror.cpp \
     src/gui/UBScreenMirror.cpp \
+    src/gui/UBCaptureService.cpp \
     src/gui/UBResources.cpp \
     src/gui/UBMessageWindow.cpp \
     src/gui/UBDocumentThumbnailWidget.cpp \
@@ -38,8 +38,17 @@
 
 sDownloadFileDesc desc;
 
+/** Maximum amount of data buffered by a reply before it is flushed to the destination file */
+static const qint64 sReadBufferSize = 1024 * 1024;
+
+/** Maximum number of ranged requests issued to resume an interrupted download */
+static const int sMaxResumeCount = 5;
+
 UBHttpGet::UBHttpGet(QObject* parent)
     : QObject(parent)
+    , mResumeOffset(0)
+    , mResumeCount(0)
+    , mReplyChecked(false)
     , mReply(0)
     , mIsBackground(false)
     , mRedirectionCount(0)
@@ -57,6 +66,67 @@ UBHttpGet::~UBHttpGet()
         mReply->abort();
                 delete mReply;
     }
+
+    closeDestinationFile();
+}
+
+void UBHttpGet::setDestinationFile(const QString& pFilePath)
+{
+    closeDestinationFile();
+
+    mDestinationPath = pFilePath;
+    mResumeOffset = 0;
+    mResumeCount = 0;
+}
+
+bool UBHttpGet::openDestinationFile()
+{
+    if (mDestinationFile.isOpen())
+        return true;
+
+    QFileInfo fi(mDestinationPath);
+    QDir().mkpath(fi.absolutePath());
+
+    mDestinationFile.setFileName(mDestinationPath);
+
+    if (!mDestinationFile.open(QIODevice::ReadWrite))
+    {
+        qWarning() << "cannot open download destination" << mDestinationPath;
+        return false;
+    }
+
+    // keep what we already have, a ranged request will fetch the rest
+    mResumeOffset = mDestinationFile.size();
+    mDestinationFile.seek(mResumeOffset);
+
+    return true;
+}
+
+void UBHttpGet::closeDestinationFile()
+{
+    if (mDestinationFile.isOpen())
+    {
+        mDestinationFile.flush();
+        mDestinationFile.close();
+    }
+}
+
+bool UBHttpGet::canResume(QNetworkReply::NetworkError error) const
+{
+    if (!isStreamingToFile() || mResumeCount >= sMaxResumeCount || mDestinationFile.size() == 0)
+        return false;
+
+    switch (error)
+    {
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
 }
 
 QNetworkReply* UBHttpGet::get(QUrl pUrl, QPointF pPos, QSize pSize, bool isBackground)
@@ -66,13 +136,37 @@ QNetworkReply* UBHttpGet::get(QUrl pUrl, QPointF pPos, QSize pSize, bool isBackg
     mIsBackground = isBackground;
 
     if (mReply)
+    {
         delete mReply;
+        mReply = 0;
+    }
+
+    QNetworkRequest request(pUrl);
+
+    if (isStreamingToFile())
+    {
+        if (!openDestinationFile())
+        {
+            emit downloadFinished(false, pUrl, tr("Cannot write downloaded file"), QByteArray(), mPos, mSize, mIsBackground);
+            return nullptr;
+        }
+
+        if (mResumeOffset > 0)
+            request.setRawHeader("Range", "bytes=" + QByteArray::number(mResumeOffset) + "-");
+    }
 
     UBNetworkAccessManager * nam = UBNetworkAccessManager::defaultAccessManager();
-    mReply = nam->get(QNetworkRequest(pUrl)); //mReply deleted by this destructor
+    mReply = nam->get(request); //mReply deleted by this destructor
+    mReplyChecked = false;
 
     mDownloadedBytes.clear();
 
+    if (isStreamingToFile())
+    {
+        // bound the memory used by the reply, data is flushed to disk on each readyRead
+        mReply->setReadBufferSize(sReadBufferSize);
+    }
+
     connect(mReply, SIGNAL(finished()), this, SLOT(requestFinished()));
     connect(mReply, SIGNAL(readyRead()), this, SLOT(readyRead()));
     connect(mReply, SIGNAL(downloadProgress(qint64, qint64)), this, SLOT(downloadProgressed(qint64, qint64)));
@@ -82,8 +176,46 @@ QNetworkReply* UBHttpGet::get(QUrl pUrl, QPointF pPos, QSize pSize, bool isBackg
 
 void UBHttpGet::readyRead()
 {
-        if (mReply)
-                mDownloadedBytes += mReply->readAll();
+    if (!mReply)
+        return;
+
+    if (!isStreamingToFile())
+    {
+        mDownloadedBytes += mReply->readAll();
+        return;
+    }
+
+    const int status = mReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (status >= 300 && status < 400)
+    {
+        // body of a redirection, the content comes with the next request
+        mReply->readAll();
+        return;
+    }
+
+    if (!mReplyChecked)
+    {
+        mReplyChecked = true;
+
+        if (mResumeOffset > 0 && status != 206)
+        {
+            // server ignored the range, start over
+            mResumeOffset = 0;
+            mDestinationFile.resize(0);
+            mDestinationFile.seek(0);
+        }
+    }
+
+    while (mReply->bytesAvailable() > 0)
+    {
+        if (mDestinationFile.write(mReply->read(sReadBufferSize)) < 0)
+        {
+            qWarning() << "error writing download destination" << mDestinationPath << mDestinationFile.errorString();
+            mReply->abort();
+            return;
+        }
+    }
 }
 
 
@@ -98,10 +230,28 @@ void UBHttpGet::requestFinished()
     {
         qWarning() << mReply->url().toString().left(255) << "get finished with error : " << mReply->error();
 
+        if (canResume(mReply->error()))
+        {
+            mResumeCount++;
+            mDestinationFile.flush();
+            mResumeOffset = mDestinationFile.size();
+
+            qDebug() << "resuming download at" << mResumeOffset << "bytes";
+            get(mReply->url(), mPos, mSize, mIsBackground);
+
+            return;
+        }
+
         mDownloadedBytes.clear();
 
         mRedirectionCount = 0;
 
+        if (isStreamingToFile())
+        {
+            closeDestinationFile();
+            QFile::remove(mDestinationPath);
+        }
+
         emit downloadFinished(false, mReply->url(), mReply->errorString(), mDownloadedBytes, mPos, mSize, mIsBackground);
     }
     else
@@ -112,6 +262,15 @@ void UBHttpGet::requestFinished()
         if (mReply->header(QNetworkRequest::LocationHeader).isValid() && mRedirectionCount < 10)
         {
             mRedirectionCount++;
+
+            if (isStreamingToFile())
+            {
+                // a partial file of the former location cannot be resumed on the new one
+                mDestinationFile.resize(0);
+                mDestinationFile.seek(0);
+                mResumeOffset = 0;
+            }
+
             get(mReply->header(QNetworkRequest::LocationHeader).toUrl(), mPos, mSize, mIsBackground);
 
             return;
@@ -119,6 +278,13 @@ void UBHttpGet::requestFinished()
 
         mRedirectionCount = 0;
 
+        if (isStreamingToFile())
+        {
+            readyRead();
+            closeDestinationFile();
+            mResumeCount = 0;
+        }
+
         emit downloadFinished(true, mReply->url(), mReply->header(QNetworkRequest::ContentTypeHeader).toString(),
                         mDownloadedBytes, mPos, mSize, mIsBackground);
     }
@@ -130,7 +296,8 @@ void UBHttpGet::downloadProgressed(qint64 bytesReceived, qint64 bytesTotal)
 //    qDebug() << "received: " << bytesReceived << ", / " << bytesTotal << " bytes";
     if (-1 != bytesTotal)
     {
-        emit downloadProgress(bytesReceived, bytesTotal);
+        // a resumed download reports only the remaining range
+        emit downloadProgress(mResumeOffset + bytesReceived, mResumeOffset + bytesTotal);
     }
 }
 
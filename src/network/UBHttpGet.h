@@ -44,6 +44,14 @@ class UBHttpGet : public QObject
         virtual ~UBHttpGet();
 
         QNetworkReply* get(QUrl pUrl, QPointF pPoint = QPointF(0, 0), QSize pSize = QSize(0, 0), bool isBackground = false);
+
+        /**
+         * Stream the body of the next request to the given file instead of keeping it in memory.
+         * An existing partial file is resumed with a ranged request. The data passed with
+         * downloadFinished() is then empty and the content is found in destinationFile().
+         */
+        void setDestinationFile(const QString& pFilePath);
+        QString destinationFile() const { return mDestinationPath; }
 //        QNetworkReply* get(const sDownloadFileDesc &downlinfo);
 
     signals:
@@ -62,7 +70,17 @@ class UBHttpGet : public QObject
 
     private:
 
+        bool isStreamingToFile() const { return !mDestinationPath.isEmpty(); }
+        bool openDestinationFile();
+        void closeDestinationFile();
+        bool canResume(QNetworkReply::NetworkError error) const;
+
         QByteArray mDownloadedBytes;
+        QString mDestinationPath;
+        QFile mDestinationFile;
+        qint64 mResumeOffset;
+        int mResumeCount;
+        bool mReplyChecked;
         QNetworkReply* mReply;
         QPointF mPos;
         QSize mSize;
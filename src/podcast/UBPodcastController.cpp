@@ -32,6 +32,7 @@
 #include "frameworks/UBFileSystemUtils.h"
 #include "frameworks/UBStringUtils.h"
 #include "frameworks/UBPlatformUtils.h"
+#include "frameworks/UBTrace.h"
 
 #include "core/UBApplication.h"
 #include "core/UBSettings.h"
@@ -71,6 +72,17 @@
 
 #include "core/memcheck.h"
 
+/** Cost of one extra scene render pass, expressed in rendered pixels */
+static const qint64 sRenderOverheadPixels = 64 * 64;
+
+/** Above this number of damaged rects the bounding rect is rendered at once */
+static const int sMaxRepaintRects = 32;
+
+static qint64 area(const QRect& rect)
+{
+    return qint64(rect.width()) * rect.height();
+}
+
 UBPodcastController* UBPodcastController::sInstance = 0;
 
 unsigned int UBPodcastController::sBackgroundColor = 0x00000000;  // BBGGRRAA
@@ -107,8 +119,11 @@ UBPodcastController::UBPodcastController(QObject* pParent)
     connect(UBApplication::applicationController, SIGNAL(desktopMode(bool)),
             this, SLOT(applicationDesktopMode(bool)));
 
-    connect(UBApplication::webController, SIGNAL(activeWebPageChanged(WebView*)),
-            this, SLOT(webActiveWebPageChanged(WebView*)));
+    if (UBApplication::hasWebController())
+    {
+        connect(UBApplication::webController(), SIGNAL(activeWebPageChanged(WebView*)),
+                this, SLOT(webActiveWebPageChanged(WebView*)));
+    }
 
     connect(UBApplication::app(), SIGNAL(lastWindowClosed()),
             this, SLOT(applicationAboutToQuit()));
@@ -569,12 +584,16 @@ void UBPodcastController::processScenePaintEvent()
     if(!bv)
         return;
 
-    QRectF repaintRect;
+    // damage is collected in scene coordinates and mapped to video pixels
+    // with the current view, so zooming or scrolling between two frames is safe
+    const QTransform sceneToVideo = bv->viewportTransform() * mViewToVideoTransform;
+    const QRect captureRect = mLatestCapture.rect();
+    QRegion damage;
 
     if (!mInitialized)
     {
         mSceneRepaintRectQueue.clear();
-        repaintRect = bv->mapToScene(QRect(0, 0, bv->width(), bv->height())).boundingRect();
+        damage = captureRect;
 
         if (bv->scene()->isDarkBackground())
             mLatestCapture.fill(Qt::black);
@@ -587,49 +606,107 @@ void UBPodcastController::processScenePaintEvent()
     {
         while(mSceneRepaintRectQueue.size() > 0)
         {
-            repaintRect = repaintRect.united(mSceneRepaintRectQueue.dequeue());
+            QRect videoRect = sceneToVideo.mapRect(mSceneRepaintRectQueue.dequeue()).toAlignedRect();
+            damage += videoRect.adjusted(-1, -1, 1, 1).intersected(captureRect);
         }
     }
 
-    if (!repaintRect.isNull())
+    if (!damage.isEmpty())
     {
         std::shared_ptr<UBGraphicsScene> scene = bv->scene();
+        const QTransform videoToScene = sceneToVideo.inverted();
+        const QVector<QRect> repaintRects = mergedRepaintRects(damage);
 
         QPainter p(&mLatestCapture);
 
-        p.setTransform(mViewToVideoTransform);
-        p.setTransform(bv->viewportTransform(), true);
-
         p.setRenderHints(QPainter::Antialiasing);
         p.setRenderHints(QPainter::SmoothPixmapTransform);
 
-        repaintRect.adjust(-1, -1, 1, 1);
+        scene->setRenderingContext(UBGraphicsScene::Podcast);
 
-        p.setClipRect(repaintRect);
+        qint64 pixels = 0;
 
-        if (scene->isDarkBackground())
-            p.fillRect(repaintRect, Qt::black);
-        else
-            p.fillRect(repaintRect, Qt::white);
+        for (const QRect& videoRect : repaintRects)
+        {
+            QRectF repaintRect = videoToScene.mapRect(QRectF(videoRect));
 
-        scene->setRenderingContext(UBGraphicsScene::Podcast);
+            // clip in device coordinates so neighbouring rects never overdraw each other
+            p.resetTransform();
+            p.setClipRect(videoRect);
+            p.setTransform(sceneToVideo);
 
-        scene->render(&p, repaintRect, repaintRect);
+            if (scene->isDarkBackground())
+                p.fillRect(repaintRect, Qt::black);
+            else
+                p.fillRect(repaintRect, Qt::white);
+
+            scene->render(&p, repaintRect, repaintRect);
+
+            pixels += qint64(videoRect.width()) * videoRect.height();
+        }
 
         scene->setRenderingContext(UBGraphicsScene::Screen);
 
+        UBTrace::counter("podcast rects rendered", repaintRects.size());
+        UBTrace::counter("podcast pixels rendered", pixels);
+
         sendLatestPixmapToEncoder();
     }
 }
 
 
+QVector<QRect> UBPodcastController::mergedRepaintRects(const QRegion& damage)
+{
+    const QRect bounds = damage.boundingRect();
+
+    if (damage.rectCount() > sMaxRepaintRects)
+        return QVector<QRect>() << bounds;
+
+    QVector<QRect> rects;
+
+    for (const QRect& rect : damage)
+        rects << rect;
+
+    // greedily merge two rects whenever rendering their bounding rect once
+    // costs less than rendering both of them separately
+    bool merged = true;
+
+    while (merged)
+    {
+        merged = false;
+
+        for (int i = 0; i < rects.size() && !merged; ++i)
+        {
+            for (int j = i + 1; j < rects.size() && !merged; ++j)
+            {
+                QRect united = rects[i].united(rects[j]);
+                qint64 separateCost = area(rects[i]) + area(rects[j]) + sRenderOverheadPixels;
+
+                if (area(united) <= separateCost)
+                {
+                    rects[i] = united;
+                    rects.remove(j);
+                    merged = true;
+                }
+            }
+        }
+    }
+
+    return rects;
+}
+
+
 void UBPodcastController::applicationMainModeChanged(UBApplicationController::MainMode pMode)
 {
     mIsDesktopMode = false;
 
     if (pMode == UBApplicationController::Internet)
     {
-        setSourceWidget(UBApplication::webController->controlView());
+        // the web controller may have been created after this controller
+        connect(UBApplication::webController(), SIGNAL(activeWebPageChanged(WebView*)),
+                this, SLOT(webActiveWebPageChanged(WebView*)), Qt::UniqueConnection);
+
+        setSourceWidget(UBApplication::webController()->controlView());
     }
     else
     {
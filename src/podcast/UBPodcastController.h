@@ -126,6 +126,9 @@ class UBPodcastController : public QObject
 
         void sendLatestPixmapToEncoder();
 
+        /** @brief Split the damaged region into the rects to render, merging them where that is cheaper */
+        static QVector<QRect> mergedRepaintRects(const QRegion& damage);
+
         long elapsedRecordingMs();
 
         static UBPodcastController* sInstance;
@@ -30,6 +30,7 @@
 #include <QPixmap>
 
 #include "tools/UBGraphicsAxes.h"
+#include "tools/UBToolFaceCache.h"
 #include "domain/UBGraphicsScene.h"
 #include "frameworks/UBGeometryUtils.h"
 #include "core/UBApplication.h"
@@ -174,25 +175,35 @@ void UBGraphicsAxes::paint(QPainter *painter, const QStyleOptionGraphicsItem *st
     qreal ratio = mAntiScaleRatio > 1.0 ? mAntiScaleRatio : 1.0;
     antiScaleTransform2.scale(ratio, 1.0);
 
-    QPen pen(drawColor());
-    pen.setWidthF(2);
-    painter->setPen(pen);
     painter->setRenderHint(QPainter::Antialiasing, true);
-    painter->drawLine(xAxis());
-    painter->drawLine(yAxis());
 
-    // draw arrows at end
-    QPointF tip = xAxis().p2();
-    painter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() + sArrowWidth);
-    painter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() - sArrowWidth);
-
-    tip = yAxis().p2();
-    painter->drawLine(tip.x(), tip.y(), tip.x() + sArrowWidth, tip.y() + sArrowLength);
-    painter->drawLine(tip.x(), tip.y(), tip.x() - sArrowWidth, tip.y() + sArrowLength);
-
-    pen.setWidthF(1);
-    painter->setPen(pen);
-    paintGraduations(painter);
+    const QRectF faceRect = mBounds.adjusted(-sArrowWidth, -sArrowWidth, sArrowWidth, sArrowWidth);
+    const QString faceKey = QString("axes:%1,%2,%3,%4:%5:%6:%7")
+            .arg(mBounds.x()).arg(mBounds.y()).arg(mBounds.width()).arg(mBounds.height())
+            .arg(int(mShowNumbers))
+            .arg(int(scene()->isDarkBackground()))
+            .arg(UBApplication::boardController->activeScene()->backgroundGridSize());
+
+    UBToolFaceCache::paint(painter, faceRect, faceKey, [this](QPainter* facePainter){
+        QPen pen(drawColor());
+        pen.setWidthF(2);
+        facePainter->setPen(pen);
+        facePainter->drawLine(xAxis());
+        facePainter->drawLine(yAxis());
+
+        // draw arrows at end
+        QPointF tip = xAxis().p2();
+        facePainter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() + sArrowWidth);
+        facePainter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() - sArrowWidth);
+
+        tip = yAxis().p2();
+        facePainter->drawLine(tip.x(), tip.y(), tip.x() + sArrowWidth, tip.y() + sArrowLength);
+        facePainter->drawLine(tip.x(), tip.y(), tip.x() - sArrowWidth, tip.y() + sArrowLength);
+
+        pen.setWidthF(1);
+        facePainter->setPen(pen);
+        paintGraduations(facePainter);
+    });
 }
 
 
@@ -28,6 +28,7 @@
 
 
 #include "tools/UBGraphicsCompass.h"
+#include "tools/UBToolFaceCache.h"
 #include "domain/UBGraphicsScene.h"
 #include "core/UBApplication.h"
 #include "core/UBSettings.h"
@@ -164,43 +165,56 @@ void UBGraphicsCompass::paint(QPainter *painter, const QStyleOptionGraphicsItem
 
 
     painter->setPen(drawColor());
-    painter->drawRoundedRect(hingeRect(), sCornerRadius, sCornerRadius);
-    painter->fillPath(hingeShape(), middleFillColor());
-
-    painter->fillPath(needleShape(), middleFillColor());
-    painter->drawPath(needleShape());
-    painter->fillPath(needleBaseShape(), middleFillColor());
-    painter->drawPath(needleBaseShape());
-
-    QLinearGradient needleArmLinearGradient(
-        QPointF(rect().left() + sNeedleLength + sNeedleBaseLength, rect().center().y()),
-        QPointF(hingeRect().left(), rect().center().y()));
-    needleArmLinearGradient.setColorAt(0, edgeFillColor());
-    needleArmLinearGradient.setColorAt(1, middleFillColor());
-    painter->fillPath(needleArmShape(), needleArmLinearGradient);
-    painter->drawPath(needleArmShape());
-
-    QRectF hingeGripRect(rect().center().x() - 16, rect().center().y() - 16, 32, 32);
-    painter->drawEllipse(hingeGripRect);
+
+    const bool darkBackground = scene()->isDarkBackground();
+    const QColor pencilColor = darkBackground
+            ? UBApplication::boardController->penColorOnDarkBackground()
+            : UBApplication::boardController->penColorOnLightBackground();
+
+    const QString faceKey = QString("compass:%1,%2,%3,%4:%5:%6:%7")
+            .arg(rect().x()).arg(rect().y()).arg(rect().width()).arg(rect().height())
+            .arg(int(darkBackground))
+            .arg(pencilColor.name(QColor::HexArgb))
+            .arg(UBSettings::settings()->penWidthIndex());
+
+    UBToolFaceCache::paint(painter, rect(), faceKey, [this, pencilColor](QPainter* facePainter){
+        facePainter->drawRoundedRect(hingeRect(), sCornerRadius, sCornerRadius);
+        facePainter->fillPath(hingeShape(), middleFillColor());
+
+        facePainter->fillPath(needleShape(), middleFillColor());
+        facePainter->drawPath(needleShape());
+        facePainter->fillPath(needleBaseShape(), middleFillColor());
+        facePainter->drawPath(needleBaseShape());
+
+        QLinearGradient needleArmLinearGradient(
+            QPointF(rect().left() + sNeedleLength + sNeedleBaseLength, rect().center().y()),
+            QPointF(hingeRect().left(), rect().center().y()));
+        needleArmLinearGradient.setColorAt(0, edgeFillColor());
+        needleArmLinearGradient.setColorAt(1, middleFillColor());
+        facePainter->fillPath(needleArmShape(), needleArmLinearGradient);
+        facePainter->drawPath(needleArmShape());
+
+        QRectF hingeGripRect(rect().center().x() - 16, rect().center().y() - 16, 32, 32);
+        facePainter->drawEllipse(hingeGripRect);
+
+        QLinearGradient pencilArmLinearGradient(
+            QPointF(hingeRect().right(), rect().center().y()),
+            QPointF(rect().right() - sPencilLength - sPencilBaseLength, rect().center().y()));
+        pencilArmLinearGradient.setColorAt(0, middleFillColor());
+        pencilArmLinearGradient.setColorAt(1, edgeFillColor());
+        facePainter->fillPath(pencilArmShape(), pencilArmLinearGradient);
+        facePainter->drawPath(pencilArmShape());
+
+        facePainter->fillPath(pencilShape(), pencilColor);
+
+        facePainter->fillPath(pencilBaseShape(), middleFillColor());
+        facePainter->drawPath(pencilBaseShape());
+    });
+
+    // the readouts change while the compass is used, they are painted over the face
     if (mShowButtons && (!hasFocus() || mDrawing || mRotating))
         paintAngleDisplay(painter);
 
-    QLinearGradient pencilArmLinearGradient(
-        QPointF(hingeRect().right(), rect().center().y()),
-        QPointF(rect().right() - sPencilLength - sPencilBaseLength, rect().center().y()));
-    pencilArmLinearGradient.setColorAt(0, middleFillColor());
-    pencilArmLinearGradient.setColorAt(1, edgeFillColor());
-    painter->fillPath(pencilArmShape(), pencilArmLinearGradient);
-    painter->drawPath(pencilArmShape());
-
-    if (scene()->isDarkBackground())
-        painter->fillPath(pencilShape(), UBApplication::boardController->penColorOnDarkBackground());
-    else
-        painter->fillPath(pencilShape(), UBApplication::boardController->penColorOnLightBackground());
-
-    painter->fillPath(pencilBaseShape(), middleFillColor());
-    painter->drawPath(pencilBaseShape());
-
     if (mResizing || mRotating || mDrawing || (mShowButtons && rect().width() > sDisplayRadiusOnPencilArmMinLength))
         paintRadiusDisplay(painter);
 }
@@ -34,6 +34,7 @@
 #include "board/UBBoardController.h"
 #include "board/UBDrawingController.h"
 #include "UBAbstractDrawRuler.h"
+#include "UBToolFaceCache.h"
 
 #include "core/memcheck.h"
 
@@ -108,8 +109,29 @@ void UBGraphicsProtractor::paint(QPainter *painter, const QStyleOptionGraphicsIt
 
     painter->setFont(QFont("Arial", 11));
     painter->setBrush(fillBrush());
-    painter->drawPie(QRectF(rect().center().x() - radius(), rect().center().y() - radius(), 2 * radius(), 2 * radius()), mStartAngle * 16, mSpan * 16);
-    paintGraduations(painter);
+
+    const QRectF pieRect(rect().center().x() - radius(), rect().center().y() - radius(), 2 * radius(), 2 * radius());
+
+    auto paintFace = [this, pieRect](QPainter* facePainter){
+        facePainter->drawPie(pieRect, mStartAngle * 16, mSpan * 16);
+        paintGraduations(facePainter);
+    };
+
+    if (mCurrentTool == Rotate)
+    {
+        // the face changes with each step of the rotation, caching it would be useless
+        paintFace(painter);
+    }
+    else
+    {
+        const QString faceKey = QString("protractor:%1,%2,%3,%4:%5:%6:%7")
+                .arg(pieRect.x()).arg(pieRect.y()).arg(pieRect.width()).arg(pieRect.height())
+                .arg(mStartAngle).arg(mSpan)
+                .arg(int(scene()->isDarkBackground()));
+
+        UBToolFaceCache::paint(painter, pieRect, faceKey, paintFace);
+    }
+
     paintButtons(painter);
     paintHelp(painter);
     paintAngleMarker(painter);
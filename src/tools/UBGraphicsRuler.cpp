@@ -33,6 +33,7 @@
 #include <QPixmap>
 
 #include "tools/UBGraphicsRuler.h"
+#include "tools/UBToolFaceCache.h"
 #include "domain/UBGraphicsScene.h"
 #include "core/UBApplication.h"
 #include "gui/UBResources.h"
@@ -128,17 +129,28 @@ void UBGraphicsRuler::paint(QPainter *painter, const QStyleOptionGraphicsItem *s
 
     mRotateSvgItem->setPos(rotateButtonRect().topLeft());
 
-    QPainterPath outline = QPainterPath();
-    outline.addRoundedRect(rect(), sRoundingRadius, sRoundingRadius);
+    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
+    sPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
 
     painter->setPen(drawColor());
     painter->setBrush(edgeFillColor());
     painter->setRenderHint(QPainter::Antialiasing, true);
 
-    fillBackground(painter, outline);
-    drawBorder(painter, outline);
+    const QString faceKey = QString("ruler:%1,%2,%3,%4:%5:%6")
+            .arg(rect().x()).arg(rect().y()).arg(rect().width()).arg(rect().height())
+            .arg(int(scene()->isDarkBackground()))
+            .arg(sPixelsPerCentimeter);
+
+    UBToolFaceCache::paint(painter, rect(), faceKey, [this](QPainter* facePainter){
+        QPainterPath outline = QPainterPath();
+        outline.addRoundedRect(rect(), sRoundingRadius, sRoundingRadius);
+
+        fillBackground(facePainter, outline);
+        drawBorder(facePainter, outline);
+        paintGraduations(facePainter);
+    });
+
     paintHelp(painter);
-    paintGraduations(painter);
     if (mRotating)
         paintRotationCenter(painter);
 }
@@ -213,9 +225,6 @@ void UBGraphicsRuler::paintGraduations(QPainter *painter)
     painter->setFont(font());
     QFontMetricsF fontMetrics(painter->font());
 
-    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
-    sPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
-
     qreal pixelsPerMillimeter = sPixelsPerCentimeter/10.0;
     int rulerLengthInMillimeters = (rect().width() - sLeftEdgeMargin - sRoundingRadius)/pixelsPerMillimeter;
 
@@ -31,6 +31,7 @@
 #include <QtWidgets/QGraphicsPolygonItem>
 
 #include "tools/UBGraphicsTriangle.h"
+#include "tools/UBToolFaceCache.h"
 #include "core/UBApplication.h"
 #include "board/UBBoardController.h"
 #include "board/UBDrawingController.h"
@@ -307,63 +308,75 @@ void UBGraphicsTriangle::calculatePoints(const QRectF& r)
 
 void UBGraphicsTriangle::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
 {
-    painter->setPen(Qt::NoPen);
+    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
+    sPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
 
-    QPolygonF polygon;
+    const QString faceKey = QString("triangle:%1,%2,%3,%4:%5:%6:%7:%8")
+            .arg(rect().x()).arg(rect().y()).arg(rect().width()).arg(rect().height())
+            .arg(int(mOrientation)).arg(int(mShouldPaintInnerTriangle))
+            .arg(int(scene()->isDarkBackground()))
+            .arg(sPixelsPerCentimeter);
 
-    if (mShouldPaintInnerTriangle) {
-        QLinearGradient gradient1(QPointF(A1.x(), 0), QPointF(A2.x(), 0));
-        gradient1.setColorAt(0, edgeFillColor());
-        gradient1.setColorAt(1, middleFillColor());
+    UBToolFaceCache::paint(painter, rect(), faceKey, [this](QPainter* facePainter){
+        facePainter->setPen(Qt::NoPen);
 
-        painter->setBrush(gradient1);
-        polygon << A1 << A2 << B2 << B1;
-        painter->drawPolygon(polygon);
-        polygon.clear();
+        QPolygonF polygon;
 
-        QLinearGradient gradient2(QPointF(0, B1.y()), QPointF(0, B2.y()));
-        gradient2.setColorAt(0, edgeFillColor());
-        gradient2.setColorAt(1, middleFillColor());
+        if (mShouldPaintInnerTriangle) {
+            QLinearGradient gradient1(QPointF(A1.x(), 0), QPointF(A2.x(), 0));
+            gradient1.setColorAt(0, edgeFillColor());
+            gradient1.setColorAt(1, middleFillColor());
 
-        painter->setBrush(gradient2);
-        polygon << B1 << B2 << C2 << C1;
-        painter->drawPolygon(polygon);
-        polygon.clear();
+            facePainter->setBrush(gradient1);
+            polygon << A1 << A2 << B2 << B1;
+            facePainter->drawPolygon(polygon);
+            polygon.clear();
 
-        QLinearGradient gradient3(CC, C2);
-        gradient3.setColorAt(0, edgeFillColor());
-        gradient3.setColorAt(1, middleFillColor());
+            QLinearGradient gradient2(QPointF(0, B1.y()), QPointF(0, B2.y()));
+            gradient2.setColorAt(0, edgeFillColor());
+            gradient2.setColorAt(1, middleFillColor());
 
-        painter->setBrush(gradient3);
-        polygon << C1 << C2 << A2 << A1;
-        painter->drawPolygon(polygon);
-        polygon.clear();
+            facePainter->setBrush(gradient2);
+            polygon << B1 << B2 << C2 << C1;
+            facePainter->drawPolygon(polygon);
+            polygon.clear();
 
+            QLinearGradient gradient3(CC, C2);
+            gradient3.setColorAt(0, edgeFillColor());
+            gradient3.setColorAt(1, middleFillColor());
 
-        painter->setBrush(Qt::NoBrush);
-        painter->setPen(drawColor());
+            facePainter->setBrush(gradient3);
+            polygon << C1 << C2 << A2 << A1;
+            facePainter->drawPolygon(polygon);
+            polygon.clear();
 
-        polygon << A1 << B1 << C1;
-        painter->drawPolygon(polygon);
-        polygon.clear();
 
-        polygon << A2 << B2 << C2;
-        painter->drawPolygon(polygon);
-    }
+            facePainter->setBrush(Qt::NoBrush);
+            facePainter->setPen(drawColor());
 
-    else {
-        QLinearGradient gradient(QPointF(A1.x(), 0), QPointF(C1.x(), 0));
-        gradient.setColorAt(0, edgeFillColor());
-        gradient.setColorAt(1, middleFillColor());
-        painter->setBrush(gradient);
-        painter->setPen(drawColor());
-        polygon << A1 << B1 << C1;
-        painter->drawPolygon(polygon);
-        polygon.clear();
-    }
+            polygon << A1 << B1 << C1;
+            facePainter->drawPolygon(polygon);
+            polygon.clear();
+
+            polygon << A2 << B2 << C2;
+            facePainter->drawPolygon(polygon);
+        }
 
+        else {
+            QLinearGradient gradient(QPointF(A1.x(), 0), QPointF(C1.x(), 0));
+            gradient.setColorAt(0, edgeFillColor());
+            gradient.setColorAt(1, middleFillColor());
+            facePainter->setBrush(gradient);
+            facePainter->setPen(drawColor());
+            polygon << A1 << B1 << C1;
+            facePainter->drawPolygon(polygon);
+            polygon.clear();
+        }
 
-    paintGraduations(painter);
+        paintGraduations(facePainter);
+    });
+
+    painter->setPen(drawColor());
     paintHelp(painter);
 
     mAntiScaleRatio = 1 / (UBApplication::boardController->systemScaleFactor() * UBApplication::boardController->currentZoom());
@@ -478,8 +491,6 @@ void UBGraphicsTriangle::paintGraduations(QPainter *painter)
     painter->setFont(font());
     QFontMetricsF fontMetrics(painter->font());
 
-    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
-    sPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
     double pixelsPerMillimeter = sPixelsPerCentimeter/10.0;
 
     // When a "centimeter" is too narrow, we only display every 5th number, and every 5th millimeter mark
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBToolFaceCache.h"
+
+#include <QPainter>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <QtMath>
+
+#include <cmath>
+
+#include "core/memcheck.h"
+
+/** Number of resolution steps per doubling of the scale */
+static const int sScaleStepsPerOctave = 4;
+
+/** Margin around the face in device pixels, for antialiased borders */
+static const int sMargin = 2;
+
+/** Faces larger than this number of device pixels are painted directly */
+static const qreal sMaxFacePixels = 2048. * 2048.;
+
+void UBToolFaceCache::paint(QPainter* painter, const QRectF& faceRect, const QString& key, const std::function<void(QPainter*)>& paintFace)
+{
+    const int deviceType = painter->device()->devType();
+    const qreal scale = std::sqrt(std::abs(painter->worldTransform().determinant())) * painter->device()->devicePixelRatioF();
+
+    // render at the next step above the current scale, so that the face is only ever scaled down
+    const int scaleStep = qCeil(std::log2(qMax(scale, 0.01)) * sScaleStepsPerOctave);
+    const qreal faceScale = std::pow(2., qreal(scaleStep) / sScaleStepsPerOctave);
+    const QSize pixmapSize = (faceRect.size() * faceScale).toSize() + QSize(2 * sMargin, 2 * sMargin);
+
+    if (deviceType == QInternal::Printer
+            || deviceType == QInternal::Picture
+            || faceRect.isEmpty()
+            || qreal(pixmapSize.width()) * pixmapSize.height() > sMaxFacePixels)
+    {
+        painter->save();
+        paintFace(painter);
+        painter->restore();
+        return;
+    }
+
+    const QString pixmapKey = QString("toolface:%1:%2").arg(key).arg(scaleStep);
+    QPixmap pixmap;
+
+    if (!QPixmapCache::find(pixmapKey, &pixmap))
+    {
+        pixmap = QPixmap(pixmapSize);
+        pixmap.fill(Qt::transparent);
+
+        QPainter facePainter(&pixmap);
+        facePainter.setRenderHints(painter->renderHints());
+        facePainter.setPen(painter->pen());
+        facePainter.setBrush(painter->brush());
+        facePainter.setFont(painter->font());
+        facePainter.translate(sMargin, sMargin);
+        facePainter.scale(faceScale, faceScale);
+        facePainter.translate(-faceRect.topLeft());
+
+        paintFace(&facePainter);
+        facePainter.end();
+
+        QPixmapCache::insert(pixmapKey, pixmap);
+    }
+
+    const qreal margin = sMargin / faceScale;
+    const QRectF targetRect(faceRect.left() - margin, faceRect.top() - margin,
+                            pixmapSize.width() / faceScale, pixmapSize.height() / faceScale);
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawPixmap(targetRect, pixmap, QRectF(pixmap.rect()));
+    painter->restore();
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QRectF>
+#include <QString>
+
+#include <functional>
+
+class QPainter;
+
+/**
+ * @brief Shared cache of the static faces of the drawing tools.
+ *
+ * A face, e.g. the body and graduations of a ruler, is rendered once to a pixmap at the
+ * resolution it is shown at, rounded up to a few steps per doubling so that zooming does
+ * not render it again at each step, and then drawn with the painter transform. Tools
+ * showing the same face, e.g. two rulers of the same size, share the pixmap.
+ */
+class UBToolFaceCache
+{
+public:
+    /**
+     * @brief Draw the face through the cache
+     *
+     * *key* identifies the face, it must change whenever the face looks different.
+     * *paintFace* paints the face in item coordinates when it is not cached yet.
+     */
+    static void paint(QPainter* painter, const QRectF& faceRect, const QString& key, const std::function<void(QPainter*)>& paintFace);
+};
@@ -100,7 +100,7 @@ void UBEmbedController::showEmbedDialog()
         int viewHeight = mParentWidget->height() * 2. / 3.;
         mTrapDialog->resize(viewWidth, viewHeight);
 
-        QWebEngineProfile* profile = UBApplication::webController->webProfile();
+        QWebEngineProfile* profile = UBApplication::webController()->webProfile();
         mTrapFlashUi->webView->setPage(new WebPage(profile, this));
 
         connect(mTrapFlashUi->flashCombobox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &UBEmbedController::selectFlash);
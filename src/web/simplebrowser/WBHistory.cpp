@@ -680,7 +680,7 @@ bool WBHistoryMenu::prePopulated()
 {
     if (!m_history)
     {
-        m_history = UBApplication::webController->browserWindow()->historyManager();
+        m_history = UBApplication::webController()->browserWindow()->historyManager();
         m_historyMenuModel = new WBHistoryMenuModel(m_history->historyTreeModel(), this);
         setModel(m_historyMenuModel);
     }
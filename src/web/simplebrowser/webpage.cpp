@@ -195,7 +195,7 @@ inline QString questionForFeature(QWebEnginePage::Feature feature)
 
 void WebPage::handleFeaturePermissionRequested(const QUrl &securityOrigin, Feature feature)
 {
-    PermissionPolicy policy = UBApplication::webController->hasFeaturePermission(securityOrigin, feature);
+    PermissionPolicy policy = UBApplication::webController()->hasFeaturePermission(securityOrigin, feature);
 
     if (policy == PermissionUnknown)
     {
@@ -207,7 +207,7 @@ void WebPage::handleFeaturePermissionRequested(const QUrl &securityOrigin, Featu
         else
             policy = PermissionDeniedByUser;
 
-        UBApplication::webController->setFeaturePermission(securityOrigin, feature, policy);
+        UBApplication::webController()->setFeaturePermission(securityOrigin, feature, policy);
     }
 
     setFeaturePermission(securityOrigin, feature, policy);